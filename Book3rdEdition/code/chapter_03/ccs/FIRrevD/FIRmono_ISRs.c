@@ -10,6 +10,8 @@
 
 #include "DSP_Config.h" 
 #include "coeff.h"	// load the filter coefficients, B[n] ... extern
+#include "DelayLine.h"
+#include "SparseFIR.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -26,8 +28,9 @@ volatile union {
 
 
 /* add any global variables here */
-float xLeft[N+1], *pLeft = xLeft;
-Int32 i;
+float xLeft[2*(N+1)];				// each sample stored twice, see DelayLine.h
+DelayLine left = {xLeft, N+1, 0};
+SparseFIR fir;						// B[] folded and without zero taps, by StartUp
 
 
 interrupt void Codec_ISR()
@@ -38,13 +41,15 @@ interrupt void Codec_ISR()
 //
 // Returns:   Nothing
 //
-// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData,
+//            DelayLine_Put, DelayLine_Window, SparseFIR_Run
 //
-// Notes:     None
+// Notes:     Linear phase filters take (N+1)/2 multiplies per sample,
+//            fewer if B[] has zero taps (half-band, Hilbert)
 ///////////////////////////////////////////////////////////////////////
 {                    
 	/* add any local variables here */
-	float output, *p;  
+	float output;  
 
  	if(CheckForOverrun())					// overrun error occurred (i.e. halted DSP)
 		return;								// so serial port is reset to recover
@@ -52,17 +57,14 @@ interrupt void Codec_ISR()
   	CodecDataIn.UINT = ReadCodecData();		// get input data samples
 	
 	/* I added my mono FIR filter routine here */
-	*pLeft  = CodecDataIn.Channel[LEFT];	// store LEFT input value
+	DelayLine_Put(&left, CodecDataIn.Channel[LEFT]);	// store LEFT input value
 
-	output = 0;								// set up for LEFT channel
-	p = pLeft;								// save current sample pointer
-	if(++pLeft > &xLeft[N])					// update pointer, wrap if necessary
-		pLeft = xLeft;						// and store
-	for (i = 0; i <= N; i++) {				// do LEFT channel FIR
-	        output += *p-- * B[i];  		// multiply and accumulate
-	        if(p < &xLeft[0])       		// check for pointer wrap around
-        	    p = &xLeft[N];
-	}
+	// do LEFT channel FIR over the last N+1 samples, no wrap around;
+	// mirrored samples are added before the multiply if B[] is symmetric
+	if(fir.memory != NULL)
+		SparseFIR_Run(&fir, DelayLine_Window(&left, N+1), &output, 1);
+	else
+		output = 0;				// until StartUp has analyzed B[]
 
 	CodecDataOut.Channel[LEFT]  = output; // store filtered value		
 	CodecDataOut.Channel[RIGHT] = output; // store filtered value	
@@ -9,9 +9,14 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "DSP_Config.h"
+#include "coeff.h"
+#include "SparseFIR.h"
 
+extern SparseFIR fir;	// in FIRmono_ISRs.c
 
 void StartUp()
 {
-	;
+	// fold the FIR from here on if B[] has linear phase, and skip
+	// its zero taps
+	SparseFIR_Init(&fir, B, N+1);
 }
@@ -0,0 +1,68 @@
+// Welch, Wright, & Morrow, 
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: ISRs.c
+//
+// Synopsis: Interrupt service routine for codec data transmit/receive
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "DSP_Config.h" 
+#include "coeff.h"	// load the Q15 filter coefficients, B[n] ... extern
+#include "FixedFIR.h"
+  
+// Data is received as 2 16-bit words (left/right) packed into one
+// 32-bit word.  The union allows the data to be accessed as a single 
+// entity when transferring to and from the serial port, but still be 
+// able to manipulate the left and right channels independently.
+
+#define LEFT  0
+#define RIGHT 1
+
+volatile union {
+	Uint32 UINT;
+	Int16 Channel[2];
+} CodecDataIn, CodecDataOut;
+
+
+/* add any global variables here */
+FixedFIR left;	// Q15 coefficients and Int16 history, set up by StartUp
+
+
+interrupt void Codec_ISR()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Codec interface interrupt service routine  
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData,
+//            FixedFIR_Filter
+//
+// Notes:     The codec samples are filtered as Int16, with no float
+//            conversion; silent until StartUp has set up the filter
+///////////////////////////////////////////////////////////////////////
+{                    
+	/* add any local variables here */
+	Int16 output;  
+
+ 	if(CheckForOverrun())					// overrun error occurred (i.e. halted DSP)
+		return;								// so serial port is reset to recover
+
+  	CodecDataIn.UINT = ReadCodecData();		// get input data samples
+	
+	/* I added my mono fixed-point FIR filter routine here */
+	output = 0;
+	if(left.memory)		// do LEFT channel FIR: Q15 x Q0 products,
+						// rounded back to Q0 and saturated
+		output = FixedFIR_Filter(&left, CodecDataIn.Channel[LEFT]);
+
+	CodecDataOut.Channel[LEFT]  = output; // store filtered value		
+	CodecDataOut.Channel[RIGHT] = output; // store filtered value	
+	/* end of my mono fixed-point FIR filter routine */	
+
+	WriteCodecData(CodecDataOut.UINT);		// send output data to  port
+}
+
@@ -0,0 +1,21 @@
+// Welch, Wright, & Morrow, 
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: StartUp.c
+//
+// Synopsis: Placeholder for code run after DSP_Init()
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "DSP_Config.h"
+#include "coeff.h"
+#include "FixedFIR.h"
+
+extern FixedFIR left;	// in ISRs.c
+
+void StartUp()
+{
+	// B[] is Q15, from fir_dump2c_Qxx; the ISR filters once this returns
+	FixedFIR_Init(&left, B, B_SIZE, 15, FIXEDFIR_ROUND, 1);
+}
@@ -0,0 +1,47 @@
+// Welch, Wright, & Morrow, 
+// Real-time Digital Signal Processing, 2017
+
+/* coeff.c                                  */
+/* DF2 filter coefficients in Q15 format        */
+/* exported from MATLAB using fir_dump2c_Qxx.m  */
+
+
+/* Equiripple FIR LPF with passband to */
+/* 5 kHz assuming Fs=48 kHz (FIRrevD)  */
+
+
+#include "coeff.h"
+
+short B[B_SIZE] = {
+     141,	/* B[0] */
+    -241,	/* B[1] */
+    -346,	/* B[2] */
+    -297,	/* B[3] */
+      22,	/* B[4] */
+     484,	/* B[5] */
+     749,	/* B[6] */
+     477,	/* B[7] */
+    -367,	/* B[8] */
+   -1339,	/* B[9] */
+   -1657,	/* B[10] */
+    -632,	/* B[11] */
+    1841,	/* B[12] */
+    5069,	/* B[13] */
+    7810,	/* B[14] */
+    8884,	/* B[15] */
+    7810,	/* B[16] */
+    5069,	/* B[17] */
+    1841,	/* B[18] */
+    -632,	/* B[19] */
+   -1657,	/* B[20] */
+   -1339,	/* B[21] */
+    -367,	/* B[22] */
+     477,	/* B[23] */
+     749,	/* B[24] */
+     484,	/* B[25] */
+      22,	/* B[26] */
+    -297,	/* B[27] */
+    -346,	/* B[28] */
+    -241,	/* B[29] */
+     141,	/* B[30] */
+};
@@ -0,0 +1,12 @@
+// Welch, Wright, & Morrow, 
+// Real-time Digital Signal Processing, 2017
+
+/* coeff.h                                  */
+/* DF2 filter coefficients in Q15 format        */
+/* exported from MATLAB using fir_dump2c_Qxx.m  */
+
+
+#define B_SIZE 31
+
+extern short B[];
+
@@ -11,6 +11,8 @@
 #include "DSP_Config.h" 
 #include "math.h"
 #include "frames.h"  
+#include "FrameQueue.h"
+#include "FrameTimer.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -30,30 +32,36 @@ volatile union {
 // frame buffer declarations
 #define BUFFER_LENGTH   	96000	// buffer length in samples 
 #define NUM_CHANNELS    	2		// supports stereo audio 
-#define NUM_BUFFERS     	3		// don't change 
+#define FRAME_QUEUE_DEPTH	1		// frames that may wait for ProcessBuffer
+#define NUM_BUFFERS     	(FRAME_QUEUE_DEPTH + 2)
 #define INITIAL_FILL_INDEX	0		// start filling this buffer
 #define INITIAL_DUMP_INDEX	1		// start dumping this buffer
 
 #pragma DATA_SECTION (buffer, "CE0"); // allocate buffers in external SDRAM 
 volatile float buffer[NUM_BUFFERS][2][BUFFER_LENGTH];
-// there are 3 buffers in use at all times, one being filled,
-// one being operated on, and one being emptied
+// one buffer is being filled, one is being emptied, and the other
+// FRAME_QUEUE_DEPTH buffers are queued for (or being) processed
 // fill_index   --> buffer being filled by the ADC
 // dump_index --> buffer being written to the DAC
-// ready_index --> buffer ready for processing
-Uint8 buffer_ready = 0, over_run = 0, ready_index = 2;
+// queue --> filled buffers waiting for processing, oldest first
+// Raising FRAME_QUEUE_DEPTH adds one frame of latency per step and
+// lets ProcessBuffer run that many frames behind without a glitch.
+FrameDesc queue_slots[FRAME_QUEUE_DEPTH];
+FrameQueue queue;
+FrameTimer process_timer; // ProcessBuffer execution time, see GetProcessTiming
 
 void ZeroBuffers() 
 ////////////////////////////////////////////////////////////////////////
-// Purpose:   Sets all buffer locations to 0.0 
+// Purpose:   Sets all buffer locations to 0.0 and empties the
+//            frame queue
 //
 // Input:     None
 //
 // Returns:   Nothing
 //
-// Calls:     Nothing
+// Calls:     FrameQueue_Init
 //
-// Notes:     None
+// Notes:     Call before DSP_Init
 ///////////////////////////////////////////////////////////////////////
 {
     Uint32 i = BUFFER_LENGTH * NUM_BUFFERS * NUM_CHANNELS;
@@ -62,26 +70,36 @@ void ZeroBuffers()
 
     while(i--)
         *p++ = 0.0;
+
+    FrameQueue_Init(&queue, queue_slots, FRAME_QUEUE_DEPTH, NUM_BUFFERS - 1);
 }
 
 void ProcessBuffer()
 ///////////////////////////////////////////////////////////////////////
-// Purpose:   Processes the data in buffer[ready_index] and stores
+// Purpose:   Processes the oldest queued buffer and stores
 //  		  the results back into the buffer 
 //
 // Input:     None
 //
 // Returns:   Nothing
 //
-// Calls:     Nothing
+// Calls:     FrameQueue_Peek, FrameQueue_Pop
 //
 // Notes:     None
 ///////////////////////////////////////////////////////////////////////
 {   
-	Uint32 i;
-    volatile float *pL = buffer[ready_index][LEFT];
-    volatile float *pR = buffer[ready_index][RIGHT];
-    float temp;       
+    FrameDesc *frame = FrameQueue_Peek(&queue);
+
+    if(frame == 0)
+        return;
+
+    // first call: the sample rate is known once DSP_Init has run
+    if(process_timer.period == 0)
+        FrameTimer_Init(&process_timer, "ProcessBuffer", BUFFER_LENGTH / GetSampleFreq());
+    FrameTimer_Start(&process_timer);
+
+    // to use the examples below, declare Uint32 i; float temp; and
+    // volatile float *pL = frame->data[LEFT], *pR = frame->data[RIGHT];
   
 /* zero out left channel 
    for(i=0;i < BUFFER_LENGTH;i++){ 
@@ -129,7 +147,8 @@ void ProcessBuffer()
       pR++;
     } 
 */
-    buffer_ready = 0;
+    FrameTimer_Stop(&process_timer);
+    FrameQueue_Pop(&queue); // release the buffer
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -145,7 +164,7 @@ void ProcessBuffer()
 ///////////////////////////////////////////////////////////////////////
 int IsBufferReady()
 {
-    return buffer_ready;
+    return FrameQueue_Count(&queue) != 0;
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -157,11 +176,49 @@ int IsBufferReady()
 //
 // Calls:     Nothing
 //
-// Notes:     None
+// Notes:     An overrun is a dropped or a late frame
 ///////////////////////////////////////////////////////////////////////
 int IsOverRun()
 {
-    return over_run;
+    return queue.dropped || queue.late;
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access function for the ProcessBuffer execution times 
+//
+// Input:     stats - receives min/mean/p99/max times and headroom
+//
+// Returns:   Nothing
+//
+// Calls:     FrameTimer_GetStats
+//
+// Notes:     The deadline is one frame period
+///////////////////////////////////////////////////////////////////////
+void GetProcessTiming(FrameTimerStats *stats)
+{
+	FrameTimer_GetStats(&process_timer, stats);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access functions for the frame queue counters 
+//
+// Input:     None
+//
+// Returns:   Frames dropped because the queue was full, or frames
+//            processed after their playout had begun
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+Uint32 GetDroppedFrames()
+{
+    return queue.dropped;
+}
+
+Uint32 GetLateFrames()
+{
+    return queue.late;
 }
 
 
@@ -205,14 +262,12 @@ interrupt void Codec_ISR()
    // update sample count and swap buffers when filled 
     if(++sample_count >= BUFFER_LENGTH) {
         sample_count = 0;
-        ready_index = fill_index;
+        // queue the full buffer; counts a dropped frame if no room
+        FrameQueue_Push(&queue, (void *)buffer[fill_index]);
         if(++fill_index >= NUM_BUFFERS)
             fill_index = 0;
         if(++dump_index >= NUM_BUFFERS)
             dump_index = 0;
-        if(buffer_ready == 1) // set a flag if buffer isn't processed in time 
-            over_run = 1;
-        buffer_ready = 1;
     }
 
 
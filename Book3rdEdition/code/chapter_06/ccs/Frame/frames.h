@@ -8,9 +8,14 @@
 //
 ///////////////////////////////////////////////////////////////////////
 
+#include "FrameTimer.h"
+
 // defined in ISRs.c
 void ZeroBuffers();
 void ProcessBuffer();
 int IsBufferReady();
 int IsOverRun();
+void GetProcessTiming(FrameTimerStats *);
+Uint32 GetDroppedFrames();
+Uint32 GetLateFrames();
 
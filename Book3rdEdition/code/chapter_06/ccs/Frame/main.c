@@ -24,6 +24,7 @@ int main()
   	while(1) { 
         if(IsBufferReady()) // process buffers in background
             ProcessBuffer();
+        FrameTimer_Poll(); // periodic timing report, if enabled
   	}   
 }
 
@@ -11,18 +11,27 @@
 #include "DSP_Config.h" 
 #include "math.h"
 #include "frames.h"  
+#include "FrameQueue.h"
+#include "FrameTimer.h"
   
 // frame buffer declarations
-#define BUFFER_COUNT		1024   // buffer length in McASP samples (L+R)
-#define BUFFER_LENGTH   	BUFFER_COUNT*2 // two Int16 read from McASP each time  
-#define NUM_BUFFERS     	3     // don't change this! 
+#define BUFFER_COUNT		1024   // default frame length in McASP samples (L+R)
+#define BUFFER_COUNT_MAX	4096   // longest frame, sets the buffer storage
+#define BUFFER_LENGTH   	BUFFER_COUNT_MAX*2 // two Int16 read from McASP each time  
+#define FRAME_QUEUE_DEPTH	1     // frames that may wait for ProcessBuffer
+#define NUM_BUFFERS     	(FRAME_QUEUE_DEPTH + 2) 
 
 #pragma DATA_SECTION (buffer, "CE0"); // allocate buffers in SDRAM 
 Int16 buffer[NUM_BUFFERS][BUFFER_LENGTH];
-// there are 3 buffers in use at all times, one being filled from the McBSP,
-// one being operated on, and one being emptied to the McBSP
-// ready_index --> buffer ready for processing
-volatile Int16 buffer_ready = 0, over_run = 0, ready_index = 0;
+Uint32 buffer_count = BUFFER_COUNT; // frame length in use, see SetFrameSize
+// one buffer is being filled from the McASP, one is being emptied to
+// the McASP, and the other FRAME_QUEUE_DEPTH buffers are queued for
+// (or being) processed.  Each step of FRAME_QUEUE_DEPTH adds one frame
+// of latency and lets ProcessBuffer fall that many frames behind.
+FrameDesc queue_slots[FRAME_QUEUE_DEPTH];
+FrameQueue queue;
+FrameTimer process_timer; // ProcessBuffer execution time, see GetProcessTiming
+Int16 fill_index = 1; // buffer the receive event fills next
 
 // values used for EDMA channel initialization
 #define EDMA_CONFIG_RX_OPTION				0x00100000	// TCINTEN, event 0
@@ -32,7 +41,7 @@ volatile Int16 buffer_ready = 0, over_run = 0, ready_index = 0;
 #define EDMA_CONFIG_RX_SRC_ADDR				((Uint32)(&(McASP0_Base->rbuf[12])))
 #endif
 #define EDMA_CONFIG_RX_SRC_DEST_B_INDEX		((4 << 16) + 0)	// src_b_index = 0, dest_b_index = 4
-#define EDMA_CONFIG_RX_A_B_COUNT			((BUFFER_COUNT << 16) + 4)	// 4-byte transfers
+#define EDMA_CONFIG_RX_A_B_COUNT			((buffer_count << 16) + 4)	// 4-byte transfers
 #define EDMA_CONFIG_TX_OPTION				0x00101000	// TCINTEN, event 1
 #ifdef DSPBOARDTYPE_TI_OMAPL138_LCDK
 #define EDMA_CONFIG_TX_DEST_ADDR			((Uint32)(&(McASP0_Base->xbuf[13])))
@@ -50,12 +59,11 @@ void EDMA_Init()
 //            EDMA is setup so buffer[2] is outbound to McASP, buffer[0] is 
 //            available for processing, and buffer[1] is being loaded.
 //            Both the EDMA transmit and receive events are set to automatically
-//            reload upon completion, cycling through the 3 buffers. 
+//            reload upon completion, cycling through the NUM_BUFFERS buffers. 
 //            The EDMA completion interrupt occurs when a buffer has been filled
 //            by the EDMA from the McASP.
-//            The EDMA interrupt service routine updates the ready buffer index, 
-//            and sets the buffer ready flag which is being polled by the main 
-//            program loop
+//            The EDMA interrupt service routine queues the filled buffer,
+//            and the main program loop polls the queue
 //
 // Input:     None
 //
@@ -63,51 +71,37 @@ void EDMA_Init()
 //
 // Calls:     Nothing
 //
-// Notes:     None
+// Notes:     Link params 64 to 64+NUM_BUFFERS-1 are used for tx and the
+//            next NUM_BUFFERS params for rx.  Receive fills buffer k+1
+//            during frame k and transmit sends buffer k+2, so a buffer
+//            is played NUM_BUFFERS-1 frames after it is filled.
+//            The frames are buffer_count samples long.
 ///////////////////////////////////////////////////////////////////////
 {
 	EDMA_params* param;
+	Int32 i;
 
 	// McASP tx event params
 	param = (EDMA_params*)EDMA3_0_PARAM(EDMA3_EVENT_MCASP0_TX);
 	param->option = EDMA_CONFIG_TX_OPTION;
-	param->source = (Uint32)(&buffer[2][0]);
-	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
-	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
-	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
-	param->c_count = 1;
-	
-	// set up first tx link param
-	param = (EDMA_params*)EDMA3_0_PARAM(64);
-	param->option = EDMA_CONFIG_TX_OPTION;
-	param->source = (Uint32)(&buffer[0][0]);
-	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
-	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
-	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(65) & 0xFFFF);
-	param->c_count = 1;
-	
-	// set up second tx link param
-	param = (EDMA_params*)EDMA3_0_PARAM(65);
-	param->option = EDMA_CONFIG_TX_OPTION;
-	param->source = (Uint32)(&buffer[1][0]);
-	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
-	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
-	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(66) & 0xFFFF);
-	param->c_count = 1;
-	
-	// set up third tx link param
-	param = (EDMA_params*)EDMA3_0_PARAM(66);
-	param->option = EDMA_CONFIG_TX_OPTION;
-	param->source = (Uint32)(&buffer[2][0]);
+	param->source = (Uint32)(&buffer[2 % NUM_BUFFERS][0]);
 	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
 	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
 	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
 	param->c_count = 1;
 	
+	// set up tx link params, each linked to the next in a ring
+	for(i = 0;i < NUM_BUFFERS;i++) {
+		param = (EDMA_params*)EDMA3_0_PARAM((64 + i));
+		param->option = EDMA_CONFIG_TX_OPTION;
+		param->source = (Uint32)(&buffer[(i + 3) % NUM_BUFFERS][0]);
+		param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
+		param->dest = EDMA_CONFIG_TX_DEST_ADDR;
+		param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
+		param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM((64 + (i + 1) % NUM_BUFFERS)) & 0xFFFF);
+		param->c_count = 1;
+	}
 	
 	// McASP rx event params
 	param = (EDMA_params*)(EDMA3_0_PARAM(EDMA3_EVENT_MCASP0_RX));
@@ -116,38 +110,20 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
 	param->dest = (Uint32)(&buffer[1][0]);
 	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(67) & 0xFFFF);
-	param->c_count = 1;
-	
-	// set up first rx link param
-	param = (EDMA_params*)EDMA3_0_PARAM(67);
-	param->option = EDMA_CONFIG_RX_OPTION;
-	param->source = EDMA_CONFIG_RX_SRC_ADDR;
-	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
-	param->dest = (Uint32)(&buffer[2][0]);
-	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(68) & 0xFFFF);
-	param->c_count = 1;
-	
-	// set up second rx link param
-	param = (EDMA_params*)EDMA3_0_PARAM(68);
-	param->option = EDMA_CONFIG_RX_OPTION;
-	param->source = EDMA_CONFIG_RX_SRC_ADDR;
-	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
-	param->dest = (Uint32)(&buffer[0][0]);
-	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(69) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM((64 + NUM_BUFFERS)) & 0xFFFF);
 	param->c_count = 1;
 	
-	// set up third rx link param
-	param = (EDMA_params*)EDMA3_0_PARAM(69);
-	param->option = EDMA_CONFIG_RX_OPTION;
-	param->source = EDMA_CONFIG_RX_SRC_ADDR;
-	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
-	param->dest = (Uint32)(&buffer[1][0]);
-	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(67) & 0xFFFF);
-	param->c_count = 1;
+	// set up rx link params, each linked to the next in a ring
+	for(i = 0;i < NUM_BUFFERS;i++) {
+		param = (EDMA_params*)EDMA3_0_PARAM((64 + NUM_BUFFERS + i));
+		param->option = EDMA_CONFIG_RX_OPTION;
+		param->source = EDMA_CONFIG_RX_SRC_ADDR;
+		param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
+		param->dest = (Uint32)(&buffer[(i + 2) % NUM_BUFFERS][0]);
+		param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
+		param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM((64 + NUM_BUFFERS + (i + 1) % NUM_BUFFERS)) & 0xFFFF);
+		param->c_count = 1;
+	}
 	
 	// configure EDMA to start servicing events
 	*(volatile Uint32 *)EDMA3_0_CC_ECR  = EDMA_CONFIG_EVENT_MASK;	// clear pending events
@@ -158,27 +134,68 @@ void EDMA_Init()
 
 void ZeroBuffers() 
 ////////////////////////////////////////////////////////////////////////
-// Purpose:   Sets all buffer locations to 0 
+// Purpose:   Sets all buffer locations to 0 and empties the frame
+//            queue
 //
 // Input:     None
 //
 // Returns:   Nothing
 //
-// Calls:     Nothing
+// Calls:     FrameQueue_Init
 //
-// Notes:     None
+// Notes:     Call before EDMA_Init
 ///////////////////////////////////////////////////////////////////////
 {
-    Int32 i = BUFFER_COUNT * NUM_BUFFERS;
+    Int32 i = BUFFER_COUNT_MAX * NUM_BUFFERS;
     Int32 *p = (Int32 *)buffer;
 
     while(i--)
         *p++ = 0;
+
+    FrameQueue_Init(&queue, queue_slots, FRAME_QUEUE_DEPTH, NUM_BUFFERS - 1);
+    fill_index = 1;
+}
+
+Int32 SetFrameSize(Uint32 count)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets the frame length
+//
+// Input:     count - McASP samples (L+R) per frame
+//
+// Returns:   1 on success, 0 if count is 0 or above BUFFER_COUNT_MAX
+//
+// Calls:     Nothing
+//
+// Notes:     Call before ZeroBuffers and EDMA_Init.  Latency is
+//            NUM_BUFFERS-1 frames.
+///////////////////////////////////////////////////////////////////////
+{
+    if(count == 0 || count > BUFFER_COUNT_MAX)
+        return 0;
+    buffer_count = count;
+    process_timer.period = 0; // new deadline, timed afresh
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access function for the frame length 
+//
+// Input:     None
+//
+// Returns:   McASP samples (L+R) per frame
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+Uint32 GetFrameSize()
+{
+    return buffer_count;
 }
 
 void ProcessBuffer()
 ///////////////////////////////////////////////////////////////////////
-// Purpose:   Processes the data in buffer[ready_index] and stores
+// Purpose:   Processes the oldest queued buffer and stores
 //  		  the results back into the buffer 
 //            Data is packed into the buffer, alternating right/left
 //
@@ -186,20 +203,30 @@ void ProcessBuffer()
 //
 // Returns:   Nothing
 //
-// Calls:     Nothing
+// Calls:     FrameQueue_Peek, FrameQueue_Pop
 //
 // Notes:     None
 ///////////////////////////////////////////////////////////////////////
 {   
-	Int16 *pBuf = buffer[ready_index];
-	static float Left[BUFFER_COUNT], Right[BUFFER_COUNT];
+	FrameDesc *frame = FrameQueue_Peek(&queue);
+	Int16 *pBuf;
+	static float Left[BUFFER_COUNT_MAX], Right[BUFFER_COUNT_MAX];
 	float *pL = Left, *pR = Right;
 	Int32 i;
-	float temp;     
+
+	if(frame == 0)
+		return;
+
+	// first call: the sample rate is known once DSP_Init has run
+	if(process_timer.period == 0)
+		FrameTimer_Init(&process_timer, "ProcessBuffer", buffer_count / GetSampleFreq());
+	FrameTimer_Start(&process_timer);
+
+	pBuf = frame->data;
 
 	WriteDigitalOutputs(0); // set digital outputs low - for time measurement
 
-	for(i = 0;i < BUFFER_COUNT;i++) { // extract data to float buffers
+	for(i = 0;i < buffer_count;i++) { // extract data to float buffers
 		*pR++ = *pBuf++;
 		*pL++ = *pBuf++;
 	}
@@ -207,35 +234,35 @@ void ProcessBuffer()
 	pL = Left; // reinitialize pointers
 	pR = Right;        
 /* gain */
-	for(i=0;i < BUFFER_COUNT;i++){ 
+	for(i=0;i < buffer_count;i++){ 
 		*pL++ *= 0.5;
 		*pR++ *= 2.0;
 	}  
   
 /* zero out left channel 
-	for(i=0;i < BUFFER_COUNT;i++){ 
+	for(i=0;i < buffer_count;i++){ 
 		*pL = 0.0;
 		pL++;
 	}  */
 
  
 /* zero out right channel 
-	for(i=0;i < BUFFER_COUNT;i++){ 
+	for(i=0;i < buffer_count;i++){ 
 		*pR = 0.0;
 		pR++;
 	}    */
 
 
 /* reverb on right channel  
-	for(i=0;i < BUFFER_COUNT-4;i++){ 
+	for(i=0;i < buffer_count-4;i++){ 
 		*pR = *pR + (0.9 * pR[2]) + (0.45 * pR[4]);
 		pR++;
 	}              
 */ 
   
 /* addition and subtraction 
-	for(i=0;i < BUFFER_COUNT;i++){ 
-		temp = *pL;        
+	for(i=0;i < buffer_count;i++){ 
+		float temp = *pL;        
 		*pL = temp + *pR; // left = L+R
 		*pR = temp - *pR; // right = L-R 
 		pL++;
@@ -244,14 +271,14 @@ void ProcessBuffer()
              
                    
 /* add a sinusoid    
-	for(i=0;i < BUFFER_COUNT;i++){ 
+	for(i=0;i < buffer_count;i++){ 
 		*pL = *pL + 1024*sinf(0.5*i);
 		pL++;
 	}    
 */                   
                    
 /* AM modulation 
-	for(i=0;i < BUFFER_COUNT;i++){
+	for(i=0;i < buffer_count;i++){
 		*pR = *pL * *pR * (1/32768.0); // right = L*R 
 		*pL = *pL + *pR; // left = L*(1+R) 
 		pL++;
@@ -260,24 +287,25 @@ void ProcessBuffer()
 */
 
 
- 	pBuf = buffer[ready_index];
+ 	pBuf = frame->data;
 	pL = Left;
 	pR = Right;
 
-//	for(i = 0;i < BUFFER_COUNT;i++) { // pack into buffer without bounding
+//	for(i = 0;i < buffer_count;i++) { // pack into buffer without bounding
 //		*pBuf++ = *pR++;
 //		*pBuf++ = *pL++;
 //	}
 
-	for(i = 0;i < BUFFER_COUNT;i++) { // pack into buffer after bounding
+	for(i = 0;i < buffer_count;i++) { // pack into buffer after bounding
 		*pBuf++ = _spint(*pR++ * 65536) >> 16;
 		*pBuf++ = _spint(*pL++ * 65536) >> 16;
 	}
 	
- 	pBuf = buffer[ready_index];
+ 	pBuf = frame->data;
 
+	FrameTimer_Stop(&process_timer);
 	WriteDigitalOutputs(1); // set digital output bit 0 high - for time measurement
-	buffer_ready = 0; // signal we are done
+	FrameQueue_Pop(&queue); // signal we are done
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -293,7 +321,7 @@ void ProcessBuffer()
 ///////////////////////////////////////////////////////////////////////
 int IsBufferReady()
 {
-	return buffer_ready;
+	return FrameQueue_Count(&queue) != 0;
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -305,11 +333,49 @@ int IsBufferReady()
 //
 // Calls:     Nothing
 //
-// Notes:     None
+// Notes:     An overrun is a dropped or a late frame
 ///////////////////////////////////////////////////////////////////////
 int IsOverRun()
 {
-	return over_run;
+	return queue.dropped || queue.late;
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access function for the ProcessBuffer execution times 
+//
+// Input:     stats - receives min/mean/p99/max times and headroom
+//
+// Returns:   Nothing
+//
+// Calls:     FrameTimer_GetStats
+//
+// Notes:     The deadline is one frame period
+///////////////////////////////////////////////////////////////////////
+void GetProcessTiming(FrameTimerStats *stats)
+{
+	FrameTimer_GetStats(&process_timer, stats);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access functions for the frame queue counters 
+//
+// Input:     None
+//
+// Returns:   Frames dropped because the queue was full, or frames
+//            processed after their playout had begun
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+Uint32 GetDroppedFrames()
+{
+	return queue.dropped;
+}
+
+Uint32 GetLateFrames()
+{
+	return queue.late;
 }
  
 interrupt void EDMA_ISR()
@@ -321,16 +387,15 @@ interrupt void EDMA_ISR()
 //
 // Returns:   Nothing
 //
-// Calls:     Nothing
+// Calls:     FrameQueue_Push
 //
 // Notes:     None
 ///////////////////////////////////////////////////////////////////////
 {
 	*(volatile Uint32 *)EDMA3_0_CC_ICR = EDMA_CONFIG_INTERRUPT_MASK; // clear interrupt
-	if(++ready_index >= NUM_BUFFERS) // update buffer index
-		ready_index = 0;
-	if(buffer_ready == 1) // set a flag if buffer isn't processed in time 
-		over_run = 1;
-	buffer_ready = 1; // mark buffer as ready for processing
+	// queue the buffer for processing; counts a dropped frame if no room
+	FrameQueue_Push(&queue, buffer[fill_index]);
+	if(++fill_index >= NUM_BUFFERS) // update buffer index
+		fill_index = 0;
 }
 
@@ -8,10 +8,17 @@
 //
 ///////////////////////////////////////////////////////////////////////
 
+#include "FrameTimer.h"
+
 // defined in ISRs.c
 void ZeroBuffers();
+Int32 SetFrameSize(Uint32);
+Uint32 GetFrameSize();
 void ProcessBuffer();
 int IsBufferReady();
 int IsOverRun();
+void GetProcessTiming(FrameTimerStats *);
+Uint32 GetDroppedFrames();
+Uint32 GetLateFrames();
 void EDMA_Init();
 
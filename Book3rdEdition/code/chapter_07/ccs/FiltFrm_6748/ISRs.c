@@ -8,24 +8,40 @@
 //
 // Modified April 2013 to "flip" the incoming samples properly -- chgw
 //
+// FastConv allocates about 73 KB at the default frame length, more at
+// longer ones: link with common_code/LCDK/link6748e_heap.cmd, whose
+// heap is in SDRAM, in place of link6748e.cmd.
+//
 ///////////////////////////////////////////////////////////////////////
 
 #include "DSP_Config.h" 
+#include <stdio.h>
 #include "math.h"
 #include "frames.h"  
 #include "coeff.h"      // load the filter coefficients, B[n] ... extern
+#include "FrameTimer.h"
+#include "FastConv.h"
   
 // frame buffer declarations
-#define BUFFER_COUNT		1024   // buffer length in McASP samples (L+R)
-#define BUFFER_LENGTH   	BUFFER_COUNT*2 // two Int16 read from McASP each time  
+#define BUFFER_COUNT		1024   // default frame length in McASP samples (L+R)
+#define BUFFER_COUNT_MAX	4096   // longest frame, sets the buffer storage
+#define BUFFER_LENGTH   	BUFFER_COUNT_MAX*2 // two Int16 read from McASP each time  
 #define NUM_BUFFERS     	3     // don't change this! 
+#define LEFT  0
+#define RIGHT 1
+#ifndef FIR_MODE
+#define FIR_MODE			FASTCONV_AUTO // or FASTCONV_DIRECT, FASTCONV_FFT
+#endif
 
 #pragma DATA_SECTION (buffer, "CE0"); // allocate buffers in SDRAM 
 Int16 buffer[NUM_BUFFERS][BUFFER_LENGTH];
+Uint32 buffer_count = BUFFER_COUNT; // frame length in use, see SetFrameSize
 // there are 3 buffers in use at all times, one being filled from the McBSP,
 // one being operated on, and one being emptied to the McBSP
 // ready_index --> buffer ready for processing
 volatile Int16 buffer_ready = 0, over_run = 0, ready_index = 0;
+FrameTimer process_timer; // ProcessBuffer execution time, see GetProcessTiming
+FastConv fir; // the FIR filter, direct or FFT form, set up by ZeroBuffers
 
 // values used for EDMA channel initialization
 #define EDMA_CONFIG_RX_OPTION				0x00100000	// TCINTEN, event 0
@@ -35,7 +51,7 @@ volatile Int16 buffer_ready = 0, over_run = 0, ready_index = 0;
 #define EDMA_CONFIG_RX_SRC_ADDR				((Uint32)(&(McASP0_Base->rbuf[12])))
 #endif
 #define EDMA_CONFIG_RX_SRC_DEST_B_INDEX		((4 << 16) + 0)	// src_b_index = 0, dest_b_index = 4
-#define EDMA_CONFIG_RX_A_B_COUNT			((BUFFER_COUNT << 16) + 4)	// 4-byte transfers
+#define EDMA_CONFIG_RX_A_B_COUNT			((buffer_count << 16) + 4)	// 4-byte transfers
 #define EDMA_CONFIG_TX_OPTION				0x00101000	// TCINTEN, event 1
 #ifdef DSPBOARDTYPE_TI_OMAPL138_LCDK
 #define EDMA_CONFIG_TX_DEST_ADDR			((Uint32)(&(McASP0_Base->xbuf[13])))
@@ -66,7 +82,7 @@ void EDMA_Init()
 //
 // Calls:     Nothing
 //
-// Notes:     None
+// Notes:     The frames are buffer_count samples long
 ///////////////////////////////////////////////////////////////////////
 {
 	EDMA_params* param;
@@ -78,7 +94,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
 	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
 	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up first tx link param
@@ -88,7 +104,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
 	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
 	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(65) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(65) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up second tx link param
@@ -98,7 +114,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
 	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
 	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(66) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(66) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up third tx link param
@@ -108,7 +124,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
 	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
 	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
 	param->c_count = 1;
 	
 	
@@ -119,7 +135,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
 	param->dest = (Uint32)(&buffer[1][0]);
 	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(67) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(67) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up first rx link param
@@ -129,7 +145,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
 	param->dest = (Uint32)(&buffer[2][0]);
 	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(68) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(68) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up second rx link param
@@ -139,7 +155,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
 	param->dest = (Uint32)(&buffer[0][0]);
 	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(69) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(69) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up third rx link param
@@ -149,7 +165,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
 	param->dest = (Uint32)(&buffer[1][0]);
 	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(67) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(67) & 0xFFFF);
 	param->c_count = 1;
 	
 	// configure EDMA to start servicing events
@@ -167,16 +183,64 @@ void ZeroBuffers()
 //
 // Returns:   Nothing
 //
-// Calls:     Nothing
+// Calls:     FastConv_Close, FastConv_Init
 //
-// Notes:     None
+// Notes:     Also restarts the buffer ring, for a new EDMA_Init, and
+//            sets up the filter for the frame length: FastConv times
+//            the direct and FFT forms and keeps the faster
 ///////////////////////////////////////////////////////////////////////
 {
-    Int32 i = BUFFER_COUNT * NUM_BUFFERS;
+    Int32 i = BUFFER_COUNT_MAX * NUM_BUFFERS;
     Int32 *p = (Int32 *)buffer;
 
     while(i--)
         *p++ = 0;
+
+    ready_index = 0;
+    buffer_ready = 0;
+    over_run = 0;
+
+    FastConv_Close(&fir);
+    if(!FastConv_Init(&fir, B, N+1, buffer_count, 2, FIR_MODE))
+        printf("FIR: no memory for %u sample frames, link with link6748e_heap.cmd\n",
+            buffer_count);
+}
+
+Int32 SetFrameSize(Uint32 count)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets the frame length
+//
+// Input:     count - McASP samples (L+R) per frame
+//
+// Returns:   1 on success, 0 if count is 0 or above BUFFER_COUNT_MAX
+//
+// Calls:     Nothing
+//
+// Notes:     Call before ZeroBuffers and EDMA_Init.  Latency is two
+//            frames, and ProcessBuffer must finish within one.
+///////////////////////////////////////////////////////////////////////
+{
+    if(count == 0 || count > BUFFER_COUNT_MAX)
+        return 0;
+    buffer_count = count;
+    process_timer.period = 0; // new deadline, timed afresh
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access function for the frame length 
+//
+// Input:     None
+//
+// Returns:   McASP samples (L+R) per frame
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+Uint32 GetFrameSize()
+{
+    return buffer_count;
 }
 
 void ProcessBuffer()
@@ -190,27 +254,30 @@ void ProcessBuffer()
 //
 // Returns:   Nothing
 //
-// Calls:     Nothing
+// Calls:     DelayLine_Put, FastConv_Run
 //
-// Notes:     None
+// Notes:     Sends silence if ZeroBuffers could not set up the filter
 ///////////////////////////////////////////////////////////////////////
 {   
     Int16 *pBuf = buffer[ready_index];
-    // extra buffer room for convolution "edge effects"
-    // N is filter order from coeff.h
-    static float Left[BUFFER_COUNT+N]={0}, Right[BUFFER_COUNT+N]={0};
-    float *pL = Left, *pR = Right;
-    float yLeft, yRight;
-    Int32 i, j, k;
-    
-    // offset pointers to start filling after N elements
-    pR += N;
-    pL += N;
+    Int32 i;
 
-    for(i = 0;i < BUFFER_COUNT;i++) { // extract data to float buffers
+    if(fir.memory == NULL) { // no filter, see ZeroBuffers
+        for(i = 0;i < 2 * buffer_count;i++)
+            *pBuf++ = 0;
+        buffer_ready = 0;
+        return;
+    }
+
+    // first call: the sample rate is known once DSP_Init has run
+    if(process_timer.period == 0)
+        FrameTimer_Init(&process_timer, "ProcessBuffer", buffer_count / GetSampleFreq());
+    FrameTimer_Start(&process_timer);
+
+    for(i = 0;i < buffer_count;i++) { // extract data to the delay lines
     // order is important here: must go right first then left
-       *pR++ = *pBuf++;
-       *pL++ = *pBuf++;
+       DelayLine_Put(&fir.line[RIGHT], *pBuf++);
+       DelayLine_Put(&fir.line[LEFT], *pBuf++);
     }
 
     // reinitialize pointer before FOR loop
@@ -220,32 +287,18 @@ void ProcessBuffer()
 // Implement FIR filter
 // Ensure COEFF.C is part of project
 ////////////////////////////////////////  
-   for(i=0;i < BUFFER_COUNT;i++){ 
-      yLeft  = 0;                      // initialize the LEFT output value
-      yRight = 0;                      // initialize the RIGHT output value
-      
-      for(j=0,k=i+N;j <= N;j++,k--){ 
-        yLeft  += Left[k] * B[j];        // perform the LEFT dot-product
-        yRight += Right[k] * B[j];        // perform the RIGHT dot-product
-      }
-      
+   // the whole frame of both channels, N is filter order from coeff.h
+   FastConv_Run(&fir, buffer_count);
+
+   for(i=0;i < buffer_count;i++){ 
       // pack into buffer after bounding (must be right then left)
-      *pBuf++ = _spint(yRight * 65536) >> 16;
-      *pBuf++ = _spint(yLeft * 65536) >> 16;
+      *pBuf++ = _spint(fir.y[RIGHT][i] * 65536) >> 16;
+      *pBuf++ = _spint(fir.y[LEFT][i] * 65536) >> 16;
    }  
-  
-   // save end values at end of buffer array for next pass
-   //  by placing at beginning of buffer array
-   for(i=BUFFER_COUNT,j=0;i < BUFFER_COUNT+N;i++,j++){ 
-      Left[j]=Left[i];
-      Right[j]=Right[i];
-   }
 
 //////// end of FIR routine ///////////  
 
-    // reinitialize pointer
-    pBuf = buffer[ready_index];
-
+    FrameTimer_Stop(&process_timer);
     buffer_ready = 0; // signal we are done
 }
 
@@ -280,6 +333,22 @@ int IsOverRun()
 {
 	return over_run;
 }
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access function for the ProcessBuffer execution times 
+//
+// Input:     stats - receives min/mean/p99/max times and headroom
+//
+// Returns:   Nothing
+//
+// Calls:     FrameTimer_GetStats
+//
+// Notes:     The deadline is one frame period
+///////////////////////////////////////////////////////////////////////
+void GetProcessTiming(FrameTimerStats *stats)
+{
+	FrameTimer_GetStats(&process_timer, stats);
+}
  
 interrupt void EDMA_ISR()
 ///////////////////////////////////////////////////////////////////////
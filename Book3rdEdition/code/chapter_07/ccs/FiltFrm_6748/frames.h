@@ -8,9 +8,14 @@
 //
 ///////////////////////////////////////////////////////////////////////
 
+#include "FrameTimer.h"
+
 // defined in ISRs.c
 void ZeroBuffers();
+Int32 SetFrameSize(Uint32);
+Uint32 GetFrameSize();
 void ProcessBuffer();
 int IsBufferReady();
 int IsOverRun();
+void GetProcessTiming(FrameTimerStats *);
 void EDMA_Init();
@@ -0,0 +1,299 @@
+// Welch, Wright, & Morrow, 
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: ISRs.c
+//
+// Synopsis: Interrupt service routine for codec data transmit/receive
+//           and a convolution reverb: each frame is convolved with a
+//           2 second impulse response by uniformly partitioned
+//           convolution (PartConv), so the delay through the reverb
+//           is the frame buffering alone, not the response length
+//
+//           PartConv allocates about 3 MB: link with
+//           common_code/LCDK/link6748e_heap.cmd, whose heap is in
+//           SDRAM, in place of link6748e.cmd.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "DSP_Config.h" 
+#include <math.h>
+#include <stdio.h>
+#include "frames.h"  
+#include "FrameQueue.h"
+#include "FrameTimer.h"
+#include "PartConv.h"
+  
+// Data is received as 2 16-bit words (left/right) packed into one
+// 32-bit word.  The union allows the data to be accessed as a single 
+// entity when transferring to and from the serial port, but still be 
+// able to manipulate the left and right channels independently.
+
+#define LEFT  0
+#define RIGHT 1
+
+volatile union {
+	Uint32 UINT;
+	Int16 Channel[2];
+} CodecDataIn, CodecDataOut;
+
+
+/* add any global variables here */
+// frame buffer declarations
+#define BUFFER_LENGTH   	128		// buffer length in samples, one partition
+#define NUM_CHANNELS    	2		// supports stereo audio 
+#define FRAME_QUEUE_DEPTH	1		// frames that may wait for ProcessBuffer
+#define NUM_BUFFERS     	(FRAME_QUEUE_DEPTH + 2)
+#define INITIAL_FILL_INDEX	0		// start filling this buffer
+#define INITIAL_DUMP_INDEX	1		// start dumping this buffer
+
+// impulse response
+#define RESPONSE_LENGTH		96000	// taps, 2 s at 48 kHz
+#define T60					1.5		// seconds for the tail to fall 60 dB
+
+#pragma DATA_SECTION (buffer, "CE0"); // allocate buffers in external SDRAM 
+volatile float buffer[NUM_BUFFERS][2][BUFFER_LENGTH];
+// fill_index   --> buffer being filled by the ADC
+// dump_index --> buffer being written to the DAC
+// queue --> filled buffers waiting for processing, oldest first
+FrameDesc queue_slots[FRAME_QUEUE_DEPTH];
+FrameQueue queue;
+FrameTimer process_timer; // ProcessBuffer execution time, see GetProcessTiming
+
+#pragma DATA_SECTION (response, "CE0");
+float response[RESPONSE_LENGTH];
+PartConv reverb; // partition spectra and delay lines, set up by ZeroBuffers
+volatile float dry = 1.0, wet = 0.5; // mix, can be manipulated by GEL file
+
+static void MakeResponse(float *h, Uint32 length, float fs)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Fills a synthetic room response
+//
+// Input:     h - receives length taps
+//            length - taps
+//            fs - sample frequency
+//
+// Returns:   Nothing
+//
+// Calls:     expf, sqrtf
+//
+// Notes:     Uniform noise with an exponential decay of 60 dB in T60
+//            seconds, scaled to unit energy so the reverb is about as
+//            loud as its input
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i, seed = 1;
+	float decay = expf(-6.9078f / (T60 * fs)), g = 1, energy = 0;
+
+	for(i = 0; i < length; i++) {
+		seed = seed * 1664525 + 1013904223;
+		h[i] = g * ((Int32)seed * (1.0f / 2147483648.0f));
+		energy += h[i] * h[i];
+		g *= decay;
+	}
+	g = 1 / sqrtf(energy);
+	for(i = 0; i < length; i++)
+		h[i] *= g;
+}
+
+void ZeroBuffers() 
+////////////////////////////////////////////////////////////////////////
+// Purpose:   Sets all buffer locations to 0.0, empties the frame
+//            queue and sets up the reverb
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     FrameQueue_Init, MakeResponse, PartConv_Init
+//
+// Notes:     Call before DSP_Init.  The partition spectra take 3 MB,
+//            from link6748e_heap.cmd's heap in SDRAM.  Without them
+//            ProcessBuffer passes the input through dry.
+///////////////////////////////////////////////////////////////////////
+{
+    Uint32 i = BUFFER_LENGTH * NUM_BUFFERS * NUM_CHANNELS;
+
+    volatile float *p = buffer[0][0];
+
+    while(i--)
+        *p++ = 0.0;
+
+    FrameQueue_Init(&queue, queue_slots, FRAME_QUEUE_DEPTH, NUM_BUFFERS - 1);
+
+    MakeResponse(response, RESPONSE_LENGTH, 48000);
+    PartConv_Close(&reverb);
+    if(!PartConv_Init(&reverb, response, RESPONSE_LENGTH, BUFFER_LENGTH, NUM_CHANNELS))
+        printf("Reverb: no memory for %u taps, link with link6748e_heap.cmd\n",
+            RESPONSE_LENGTH);
+}
+
+void ProcessBuffer()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Processes the oldest queued buffer and stores
+//  		  the results back into the buffer 
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     FrameQueue_Peek, FrameQueue_Pop, DelayLine_Put,
+//            PartConv_Run
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{   
+	Uint32 i;
+    FrameDesc *frame = FrameQueue_Peek(&queue);
+    volatile float (*pBuf)[BUFFER_LENGTH];
+
+    if(frame == 0)
+        return;
+
+    // first call: the sample rate is known once DSP_Init has run
+    if(process_timer.period == 0)
+        FrameTimer_Init(&process_timer, "ProcessBuffer", BUFFER_LENGTH / GetSampleFreq());
+    FrameTimer_Start(&process_timer);
+
+    pBuf = frame->data;
+    if(reverb.memory) {
+        for(i = 0; i < BUFFER_LENGTH; i++) {
+            DelayLine_Put(&reverb.line[LEFT], pBuf[LEFT][i]);
+            DelayLine_Put(&reverb.line[RIGHT], pBuf[RIGHT][i]);
+        }
+        PartConv_Run(&reverb);
+        for(i = 0; i < BUFFER_LENGTH; i++) {
+            pBuf[LEFT][i] = dry * pBuf[LEFT][i] + wet * reverb.y[LEFT][i];
+            pBuf[RIGHT][i] = dry * pBuf[RIGHT][i] + wet * reverb.y[RIGHT][i];
+        }
+    }
+
+    FrameTimer_Stop(&process_timer);
+    FrameQueue_Pop(&queue); // release the buffer
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access function for buffer ready flag 
+//
+// Input:     None
+//
+// Returns:   Non-zero when a buffer is ready for processing
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+int IsBufferReady()
+{
+    return FrameQueue_Count(&queue) != 0;
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access function for buffer overrun flag 
+//
+// Input:     None
+//
+// Returns:   Non-zero if a buffer overrun has occurred
+//
+// Calls:     Nothing
+//
+// Notes:     An overrun is a dropped or a late frame
+///////////////////////////////////////////////////////////////////////
+int IsOverRun()
+{
+    return queue.dropped || queue.late;
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access function for the ProcessBuffer execution times 
+//
+// Input:     stats - receives min/mean/p99/max times and headroom
+//
+// Returns:   Nothing
+//
+// Calls:     FrameTimer_GetStats
+//
+// Notes:     The deadline is one frame period
+///////////////////////////////////////////////////////////////////////
+void GetProcessTiming(FrameTimerStats *stats)
+{
+	FrameTimer_GetStats(&process_timer, stats);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access functions for the frame queue counters 
+//
+// Input:     None
+//
+// Returns:   Frames dropped because the queue was full, or frames
+//            processed after their playout had begun
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+Uint32 GetDroppedFrames()
+{
+    return queue.dropped;
+}
+
+Uint32 GetLateFrames()
+{
+    return queue.late;
+}
+
+
+interrupt void Codec_ISR()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Codec interface interrupt service routine  
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{                    
+	/* add any local variables here */
+    static Uint8 fill_index = INITIAL_FILL_INDEX; // index of buffer to fill
+    static Uint8 dump_index = INITIAL_DUMP_INDEX; // index of buffer to dump
+    static Uint32 sample_count = 0; // current sample count in buffer
+
+ 	if(CheckForOverrun())					// overrun error occurred (i.e. halted DSP)
+		return;								// so serial port is reset to recover
+
+  	CodecDataIn.UINT = ReadCodecData();		// get input data samples
+	
+	/* add your code starting here */
+
+    // store input in buffer
+    buffer[fill_index][ LEFT][sample_count] = CodecDataIn.Channel[ LEFT];
+    buffer[fill_index][RIGHT][sample_count] = CodecDataIn.Channel[RIGHT];
+    
+ 	// bound output data before packing
+	// use saturation of SPINT to limit to 16-bits
+	CodecDataOut.Channel[ LEFT] = _spint(buffer[dump_index][ LEFT][sample_count] * 65536) >> 16;
+	CodecDataOut.Channel[RIGHT] = _spint(buffer[dump_index][RIGHT][sample_count] * 65536) >> 16;
+    // pack output data without bounding 
+//  CodecDataOut.channel[ LEFT] = buffer[dump_index][LEFT][sample_count];
+//  CodecDataOut.channel[RIGHT] = buffer[dump_index][RIGHT][sample_count];
+
+   // update sample count and swap buffers when filled 
+    if(++sample_count >= BUFFER_LENGTH) {
+        sample_count = 0;
+        // queue the full buffer; counts a dropped frame if no room
+        FrameQueue_Push(&queue, (void *)buffer[fill_index]);
+        if(++fill_index >= NUM_BUFFERS)
+            fill_index = 0;
+        if(++dump_index >= NUM_BUFFERS)
+            dump_index = 0;
+    }
+
+
+	/* end your code here */
+
+	WriteCodecData(CodecDataOut.UINT);		// send output data to  port
+}
+
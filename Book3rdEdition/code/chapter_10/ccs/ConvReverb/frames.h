@@ -0,0 +1,21 @@
+// Welch, Wright, & Morrow, 
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: frames.h
+//
+// Synopsis: Frame buffering/processing function declarations
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "FrameTimer.h"
+
+// defined in ISRs.c
+void ZeroBuffers();
+void ProcessBuffer();
+int IsBufferReady();
+int IsOverRun();
+void GetProcessTiming(FrameTimerStats *);
+Uint32 GetDroppedFrames();
+Uint32 GetLateFrames();
+
@@ -9,7 +9,7 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "DSP_Config.h" 
-#include "coeff.h"	// load the filter coefficients, B[n] ... extern
+#include "Equalizer.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -25,7 +25,7 @@ volatile union {
 } CodecDataIn, CodecDataOut;
 
 /* add any global variables here */
-float xLeft[N+1], *pLeft = xLeft;
+extern Equalizer eq;	// in main.c, its kernel set by UpdateCoefficients
 
 interrupt void Codec_ISR()
 ///////////////////////////////////////////////////////////////////////
@@ -35,14 +35,17 @@ interrupt void Codec_ISR()
 //
 // Returns:   Nothing
 //
-// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData,
+//            DelayLine_Put, Equalizer_Run
 //
-// Notes:     None
+// Notes:     The band filters have linear phase, so the kernel does
+//            too and each sample takes (N+1)/2 multiplies, twice that
+//            while fading into a new kernel.  Silent if main could not
+//            set up the equalizer.
 ///////////////////////////////////////////////////////////////////////
 {                    
 	/* add any local variables here */
-	float output, *p; 
-	Int32 i; 
+	float output; 
 
  	if(CheckForOverrun())					// overrun error occurred (i.e. halted DSP)
 		return;								// so serial port is reset to recover
@@ -51,18 +54,17 @@ interrupt void Codec_ISR()
 	
 	/* add your code starting here */
 
-	*pLeft  = CodecDataIn.Channel[LEFT];  // current LEFT input value
-
-	output = 0;			// set up for LEFT channel
-	p = pLeft;			// save current sample pointer
-	if(++pLeft > &xLeft[N])		// update pointer, wrap if necessary
-		pLeft = xLeft;			// and store
-	for (i = 0; i <= N; i++) {	// do LEFT channel FIR
-        output += *p-- * B[i];  // do MAC
-        if(p < xLeft)           // check for pointer wrap around
-            p = &xLeft[N];      // 
+	if(eq.memory == NULL) { // no equalizer, see main
+		WriteCodecData(0);
+		return;
 	}
 
+	DelayLine_Put(&eq.line, CodecDataIn.Channel[LEFT]);  // current LEFT input value
+
+	// do LEFT channel FIR with the current kernel, no wrap around
+	Equalizer_Run(&eq, 1);
+	output = eq.y[0];
+
 	CodecDataOut.Channel[LEFT]  = output; // setup the LEFT value		
 	CodecDataOut.Channel[RIGHT] = output; // setup the RIGHT value	
 
@@ -6,40 +6,51 @@
 //
 // Synopsis: Main program file for graphic equalizer project
 //
+//           The Equalizer allocates about 2.6 KB: link with
+//           common_code/LCDK/link6748e_heap.cmd, whose heap is in
+//           SDRAM, in place of link6748e.cmd.
+//
 ///////////////////////////////////////////////////////////////////////
 
 #include "DSP_Config.h"   
-#include "coeff.h"		// coefficients used by FIR filter
+#include <stdio.h>
+#include "coeff.h"		// N, the order of the band filters
 #include "coeff_lp.h"		// coefficients for equalizer
 #include "coeff_bp1.h"
 #include "coeff_bp2.h"
 #include "coeff_bp3.h"
 #include "coeff_hp.h"
+#include "Equalizer.h"
+
+#define FADE 256		// samples to crossfade over after a slider move
  
 volatile float new_gain_lp = 1, new_gain_bp1 = 1, new_gain_bp2 = 1;
 volatile float new_gain_bp3 = 1, new_gain_hp = 1;
-volatile float old_gain_lp = 0, old_gain_bp1 = 0, old_gain_bp2 = 0;
-volatile float old_gain_bp3 = 0, old_gain_hp = 0;
+const float *bands[] = {B_LP, B_BP1, B_BP2, B_BP3, B_HP};
+Equalizer eq;		// filters the input in Codec_ISR
 
 void UpdateCoefficients()
 {
-	Int32 i;
-	
-	old_gain_lp  = new_gain_lp; // save new gain values
-	old_gain_bp1 = new_gain_bp1;
-	old_gain_bp2 = new_gain_bp2;
-	old_gain_bp3 = new_gain_bp3;
-	old_gain_hp  = new_gain_hp;
-	
-	for(i = 0; i <= N; i++) { // calculate new coefficients
-		B[i] = (B_LP[i]  * old_gain_lp)  + (B_BP1[i] * old_gain_bp1)
-			 + (B_BP2[i] * old_gain_bp2) + (B_BP3[i] * old_gain_bp3)
-			 + (B_HP[i]  * old_gain_hp);
-	}
+	if(eq.memory == NULL) // no equalizer, see main
+		return;
+
+	// any number of bands may be added to bands[] and set here
+	Equalizer_SetGain(&eq, 0, new_gain_lp);
+	Equalizer_SetGain(&eq, 1, new_gain_bp1);
+	Equalizer_SetGain(&eq, 2, new_gain_bp2);
+	Equalizer_SetGain(&eq, 3, new_gain_bp3);
+	Equalizer_SetGain(&eq, 4, new_gain_hp);
+
+	// builds the new kernel here, off the ISR, and hands it over
+	// whole; the ISR fades into it over FADE samples
+	Equalizer_Update(&eq);
 }
 
 int main()
 {    
+	// sum of the bands at unity gain, one FIR per sample
+	if(!Equalizer_Init(&eq, bands, sizeof(bands) / sizeof(bands[0]), N+1, NULL, 1, FADE))
+		printf("GraphEq: no memory for the equalizer, link with link6748e_heap.cmd\n");
 	UpdateCoefficients(); // update FIR filter coefficients
 	
 	// initialize DSP board
@@ -47,14 +58,8 @@ int main()
 	
 	// main stalls here, interrupts drive operation 
   	while(1) { 
-  		// check if any gains have changed
-		if((new_gain_lp != old_gain_lp) 
-			|| (new_gain_bp1 != old_gain_bp1)
-			|| (new_gain_bp2 != old_gain_bp2) 
-			|| (new_gain_bp3 != old_gain_bp3)
-			|| (new_gain_hp != old_gain_hp)) {
-			UpdateCoefficients();
-		}
+  		// rebuilds only if any gains have changed
+		UpdateCoefficients();
   	}   
 }
 
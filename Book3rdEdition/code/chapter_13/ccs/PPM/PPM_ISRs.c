@@ -9,6 +9,9 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "DSP_Config.h" 
+#include <math.h>
+#include <stdlib.h>
+#include "Polyphase.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -26,6 +29,7 @@ volatile union {
 
 /* add any global variables here */
 Int32 DecimationFactor = 1;
+Int32 AntiAlias = 0;	// set non-zero to lowpass before decimating
 Int32 NumBitsToUse = 16;
 Int32 LED_1_counter = 0;
 Int32 LED_2_counter = 0;
@@ -44,6 +48,92 @@ volatile Int16 TruncationMask;
 
 volatile Uint8 LedMask = 0; // used by main() to update the LEDs
 
+#define PI 3.14159265358979
+#define AA_TAPS_PER_PHASE 16	// anti-alias filter length per DecimationFactor
+#define AA_MAX_FACTOR 8			// largest DecimationFactor with a filter
+#define AA_TAPS(factor)	(AA_TAPS_PER_PHASE * (factor) + 1)
+#define AA_FLOATS	POLYPHASE_FLOATS(AA_TAPS(AA_MAX_FACTOR), 1, AA_MAX_FACTOR, 1)
+
+// anti-alias decimators for DecimationFactor 2..AA_MAX_FACTOR, left and
+// right, designed by StartUp; see Decimate
+Polyphase aa[AA_MAX_FACTOR - 1][2];
+static float aaMemory[AA_MAX_FACTOR - 1][2][AA_FLOATS];
+
+void StartUp()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Designs the anti-alias decimators
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     sinf, cosf, Polyphase_InitStatic
+//
+// Notes:     Hamming windowed sinc with its cutoff at the new Nyquist
+//            frequency, one for each factor, so that the ISR only
+//            picks one when DecimationFactor changes
+///////////////////////////////////////////////////////////////////////
+{
+	static float h[AA_TAPS(AA_MAX_FACTOR)];
+	Int32 i, factor, taps;
+	float t;
+
+	for(factor = 2; factor <= AA_MAX_FACTOR; factor++) {
+		taps = AA_TAPS(factor);
+		for(i = 0; i < taps; i++) {
+			t = PI * (i - (taps - 1) / 2) / factor;
+			h[i] = (t == 0 ? 1 : sinf(t) / t) / factor
+				* (0.54 - 0.46 * cosf(2 * PI * i / (taps - 1)));
+		}
+		for(i = 0; i < 2; i++)
+			Polyphase_InitStatic(&aa[factor - 2][i], h, taps, 1, factor, 1,
+				aaMemory[factor - 2][i], AA_FLOATS);
+	}
+}
+
+static Int32 Decimate(Int16 *left, Int16 *right)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Decides whether an input sample is kept
+//
+// Input:     left, right - the input samples, replaced by the
+//                          filtered ones when AntiAlias is set
+//
+// Returns:   Non-zero for one sample in DecimationFactor
+//
+// Calls:     DelayLine_Put, Polyphase_Run
+//
+// Notes:     Without AntiAlias the other samples are simply dropped,
+//            so anything above the new Nyquist frequency aliases;
+//            with it a polyphase lowpass computes only the kept
+//            samples.  Larger factors than AA_MAX_FACTOR are decimated
+//            without the lowpass.
+///////////////////////////////////////////////////////////////////////
+{
+	static Int32 DecimationIndex = 0;
+	Polyphase *left_aa, *right_aa;
+	Int32 keep;
+
+	if(!AntiAlias || DecimationFactor <= 1 || DecimationFactor > AA_MAX_FACTOR
+		|| aa[DecimationFactor - 2][RIGHT].memory == NULL) { // right is set up last
+		if(++DecimationIndex < DecimationFactor) // use sample?
+			return 0;
+		DecimationIndex = 0;		// reset decimation index
+		return 1;
+	}
+
+	left_aa = &aa[DecimationFactor - 2][LEFT];
+	right_aa = &aa[DecimationFactor - 2][RIGHT];
+	DelayLine_Put(&left_aa->line, *left);
+	DelayLine_Put(&right_aa->line, *right);
+	keep = Polyphase_Run(left_aa, 1);
+	Polyphase_Run(right_aa, 1);
+	if(keep) {
+		*left = _spint(left_aa->y[0] * 65536) >> 16;	// saturate to 16 bits
+		*right = _spint(right_aa->y[0] * 65536) >> 16;
+	}
+	return keep;
+}
+
 interrupt void Codec_ISR()
 ///////////////////////////////////////////////////////////////////////
 // Purpose:   Codec interface interrupt service routine  
@@ -52,13 +142,13 @@ interrupt void Codec_ISR()
 //
 // Returns:   Nothing
 //
-// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData, Decimate
 //
 // Notes:     None
 ///////////////////////////////////////////////////////////////////////
 {                    
 	/* add any local variables here */
-	static Int32 DecimationIndex = 0;
+	Int16 inputLeft, inputRight;
 
  	if(CheckForOverrun())					// overrun error occurred (i.e. halted DSP)
 		return;								// so serial port is reset to recover
@@ -67,12 +157,13 @@ interrupt void Codec_ISR()
 	
 	/* add your code starting here */
 	// decimate signal by DecimationFactor	
-	if(++DecimationIndex >= DecimationFactor) { // use sample?
-		DecimationIndex = 0;		// reset decimation index
+	inputLeft = CodecDataIn.Channel[ LEFT];
+	inputRight = CodecDataIn.Channel[RIGHT];
+	if(Decimate(&inputLeft, &inputRight)) { // use sample?
 		TruncationMask = 0xFFFF << (16 - NumBitsToUse); // create truncation mask
 		
-		outputLeft = scaleFactor*(CodecDataIn.Channel[ LEFT] & TruncationMask);
-		outputRight = scaleFactor*(CodecDataIn.Channel[RIGHT] & TruncationMask);
+		outputLeft = scaleFactor*(inputLeft & TruncationMask);
+		outputRight = scaleFactor*(inputRight & TruncationMask);
 		
 		// LED 1 logic
 		if ((abs(outputLeft) > 28000)||(abs(outputRight) > 28000)) {
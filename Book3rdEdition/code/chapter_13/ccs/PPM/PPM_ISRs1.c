@@ -44,6 +44,23 @@ volatile Int16 TruncationMask;
 
 volatile Uint8 LedMask = 0; // used by main() to update the LEDs
 
+void StartUp()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Application specific set-up, called by main
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Nothing to set up here; PPM_ISRs.c designs its
+//            anti-alias decimators in its StartUp
+///////////////////////////////////////////////////////////////////////
+{
+	;
+}
+
 interrupt void Codec_ISR()
 ///////////////////////////////////////////////////////////////////////
 // Purpose:   Codec interface interrupt service routine  
@@ -19,6 +19,10 @@ int main()
 	// initialize DSP board
   	DSP_Init();
 
+	// call StartUp for application specific code,
+	// defined in each PPM_ISRs file
+	StartUp();
+
 	// main stalls here, interrupts drive operation 
   	while(1) { 
 		if(PrevLedMask != LedMask) {	// did the LEDs change?
@@ -0,0 +1,72 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: AMreceiver.c
+//
+// Synopsis: Per-channel AM receiver: Hilbert transform envelope
+//           detector and D.C. blocking filter, as in Codec_ISR of
+//           AMreceiver_ISRs.c.  The arithmetic is done in the same
+//           order, so each channel's output matches the ISR's.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <math.h>
+#include "AMreceiver.h"
+#include "TapFIR.h"
+
+static const float r = 0.99;	// pole location for the D.C. blocking filter
+
+TAPFIR_DEFINE(Hilbert, N)		// the HT filter unrolled for its N taps
+
+// used by the multi-channel host driver, common_code/Host/Multi
+const StreamAlgorithm AMreceiver_Algorithm = {
+	"AMrx", sizeof(AMreceiver), AMreceiver_Init, AMreceiver_Process, 1	// RIGHT
+};
+
+void AMreceiver_Init(void *state)
+{
+	AMreceiver *s = state;
+
+	memset(s, 0, sizeof(AMreceiver));
+	DelayLine_Init(&s->x, s->xStore, N);
+}
+
+void AMreceiver_Process(void *state, const float *in, float *out, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Demodulates a block of one channel
+//
+// Input:     state - the channel's AMreceiver
+//            in - received AM signal, codec scale
+//            out - demodulated output, codec scale
+//            n - samples in the block
+//
+// Returns:   Nothing
+//
+// Calls:     DelayLine_Put, DelayLine_Window, Hilbert, sqrtf
+//
+// Notes:     The ISR writes out[] to both codec channels
+///////////////////////////////////////////////////////////////////////
+{
+	AMreceiver *s = state;
+	const float *x;
+	float y;
+	Uint32 k;
+
+	for(k = 0; k < n; k++) {
+		DelayLine_Put(&s->x, in[k]);		// current AM signal value
+		x = DelayLine_Window(&s->x, N);	// x[N-1] is the newest
+
+		Hilbert(B, x, &y, 1);		// perform the HT (dot-product)
+
+		s->envelope[0] = sqrtf(y*y + x[N-1-16]*x[N-1-16]); // real envelope
+
+		// D.C. blocking filter
+		s->output[0] = r*s->output[1] + (float)0.5 * (r + 1)*(s->envelope[0] - s->envelope[1]);
+
+		s->envelope[1] = s->envelope[0];
+		s->output[1] = s->output[0];
+		out[k] = s->output[0];
+	}
+}
@@ -0,0 +1,34 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: AMreceiver.h
+//
+// Synopsis: The AM receiver of AMreceiver_ISRs.c with its globals
+//           gathered into a per-channel state, so that any number of
+//           receivers can run at once (see StreamSched.h)
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	AMRECEIVER_H_INCLUDED
+#define AMRECEIVER_H_INCLUDED
+
+#include "tistdtypes.h"
+#include "coeff.h"
+#include "DelayLine.h"
+#include "StreamSched.h"
+
+typedef struct {
+	float xStore[2*N];			// received AM signal values, stored twice
+	DelayLine x;				// over xStore, see DelayLine.h
+	float envelope[2];			// real envelope
+	float output[2];			// output of the D.C. blocking filter
+} AMreceiver;
+
+// defined in AMreceiver.c
+void AMreceiver_Init(void *);
+void AMreceiver_Process(void *, const float *, float *, Uint32);
+
+extern const StreamAlgorithm AMreceiver_Algorithm;
+
+#endif
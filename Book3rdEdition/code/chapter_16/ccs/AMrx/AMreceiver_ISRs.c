@@ -11,6 +11,8 @@
 #include "DSP_Config.h" 
 #include "coeff.h"  
 #include <math.h>   
+#include "DelayLine.h"
+#include "TapFIR.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -27,12 +29,15 @@ volatile union {
 
 
 /* add any global variables here */
-float x[N];					// received AM signal values
+float xStore[2*N];			// received AM signal values, stored twice
+DelayLine x = {xStore, N, 0};	// see DelayLine.h
+const float *w;				// the last N values, w[N-1] is the newest
 float y;					// Hilbert Transforming (HT) filter's output
 float envelope[2];			// real envelope
 float output[2] = {0,0};	// output of the D.C. blocking filter
 float r = 0.99;				// pole location for the D.C. blocking filter
-Int32 i;					// integer index
+
+TAPFIR_DEFINE(Hilbert, N)	// the HT filter unrolled for its N taps
 
 interrupt void Codec_ISR()
 ///////////////////////////////////////////////////////////////////////
@@ -42,7 +47,8 @@ interrupt void Codec_ISR()
 //
 // Returns:   Nothing
 //
-// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData,
+//            DelayLine_Put, DelayLine_Window, Hilbert
 //
 // Notes:     None
 ///////////////////////////////////////////////////////////////////////
@@ -57,22 +63,16 @@ interrupt void Codec_ISR()
 	/* add your code starting here */
 
 	/* algorithm begins here */
-	x[0] = CodecDataIn.Channel[RIGHT];// current AM signal value
-	y = 0;				 // initialize the filter's output value
+	DelayLine_Put(&x, CodecDataIn.Channel[RIGHT]);// current AM signal value
+	w = DelayLine_Window(&x, N);
 
-	for (i = 0; i < N; i++) {
-		y += x[i]*B[i];		 // perform the HT (dot-product)
-	}
+	Hilbert(B, w, &y, 1);	 // perform the HT (dot-product)
 
-	envelope[0] = sqrtf(y*y + x[16]*x[16]); // real envelope
+	envelope[0] = sqrtf(y*y + w[N-1-16]*w[N-1-16]); // real envelope
 
 	/* implement the D.C. blocking filter */
 	output[0] = r*output[1] + (float)0.5 * (r + 1)*(envelope[0] - envelope[1]);
 
-	for (i = N-1; i > 0; i--) {
-		x[i] = x[i-1];		   // setup for the next input
-	}
-
 	envelope[1] = envelope[0]; // setup for the next input
 	output[1]   = output[0];   // setup for the next input
 
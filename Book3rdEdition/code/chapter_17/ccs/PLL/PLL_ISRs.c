@@ -11,6 +11,8 @@
 #include "DSP_Config.h" 
 #include "coeff.h"	// load the filter coefficients, B[n] ... extern
 #include <math.h>  
+#include "DelayLine.h"
+#include "SparseFIR.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -31,8 +33,10 @@ float alpha =  0.01;			// loop filter parameter
 float beta  = 0.002; 			// loop filter parameter 
 float Fmsg  = 12000;			// vco rest frequency 
 float Fs = 48000;				// sample frequency 
-float x[N+1] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-		0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}; // input signal
+float xLeft[2*(N+1)];			// input signal, stored twice
+DelayLine left = {xLeft, N+1, 0};	// see DelayLine.h
+const float *x;					// the last N+1 inputs, x[N] the newest
+SparseFIR hilbert;				// B[] without its zero taps, set by StartUp
 float sReal;					// real part of the analytic signal 
 float sImag;       				// imag part of the analytic signal 
 float q = 0;					// input to the loop filter
@@ -47,8 +51,6 @@ float vcoOutputReal = 1;
 float vcoOutputImag = 0;
 float scaleFactor = 3.0517578125e-5;
 
-Int32 i;
-
 interrupt void Codec_ISR()
 ///////////////////////////////////////////////////////////////////////
 // Purpose:   Codec interface interrupt service routine  
@@ -57,9 +59,10 @@ interrupt void Codec_ISR()
 //
 // Returns:   Nothing
 //
-// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData,
+//            DelayLine_Put, DelayLine_Window, SparseFIR_Run
 //
-// Notes:     None
+// Notes:     Silent until StartUp has set up the Hilbert filter
 ///////////////////////////////////////////////////////////////////////
 {                    
 	/* add any local variables here */
@@ -72,19 +75,20 @@ interrupt void Codec_ISR()
 	/* add your code starting here */
 
 	// I added my PLL routine here
-	x[0] = CodecDataIn.Channel[LEFT]; // current LEFT input value
-	sImag = 0;		// initialize the dot-product result
-    
-	for (i = 0; i <= N; i+=2) {	// indexing by 2, B[odd] = 0
-		sImag += x[i]*B[i];	// perform the dot-product
+	if (hilbert.memory == NULL) {
+		WriteCodecData(0);
+		return;
 	}
 
-    sReal = x[15]*scaleFactor;	// grpdelay of the filter is 15 samples
+	DelayLine_Put(&left, CodecDataIn.Channel[LEFT]); // current LEFT input value
+	x = DelayLine_Window(&left, N+1);
+
+	// perform the dot-product; B[odd] = 0 and B is antisymmetric, so
+	// SparseFIR_Init kept the 8 taps that differ and Run folds them
+	SparseFIR_Run(&hilbert, x, &sImag, 1);
+
+    sReal = x[N-15]*scaleFactor;	// grpdelay of the filter is 15 samples
 
-	for (i = N; i > 0; i--) {
-		x[i] = x[i-1];		// setup x[] for the next input
-	}
-		
 	sImag *= scaleFactor;	// scale prior to loop filter
 
     // execute the D-PLL (the loop)
@@ -8,10 +8,25 @@
 //
 ///////////////////////////////////////////////////////////////////////
 
+#include <stdio.h>
 #include "DSP_Config.h"
+#include "coeff.h"
+#include "Polyphase.h"
 
+extern Polyphase shaper;		// in impulseModulatedBPSK_ISRs.c
+extern Int32 samplesPerSymbol;
+
+// the shaper's memory, static since it is larger than the board's heap;
+// sized for 20 samples per symbol
+#define SHAPER_FLOATS	POLYPHASE_FLOATS(N, 20, 1, 1)
+static float shaperMemory[SHAPER_FLOATS];
 
 void StartUp()
 {
-	;
+	// pulse shape at samplesPerSymbol times the symbol rate, 10 symbols
+	// long (B[N] is past them); the ISR starts sending once this returns
+	if(!Polyphase_InitStatic(&shaper, B, N, samplesPerSymbol, 1, 1, shaperMemory,
+		SHAPER_FLOATS))
+		printf("BPSK: no shaper for %d samples per symbol, raise SHAPER_FLOATS\n",
+			samplesPerSymbol);
 }
@@ -11,6 +11,7 @@
 #include "DSP_Config.h" 
 #include "coeff.h"	// load the filter coefficients, B[n] ... extern
 #include <stdlib.h>	// needed to call the rand() function
+#include "Polyphase.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -32,9 +33,8 @@ Int32 samplesPerSymbol = 20;
 Int32 symbol;
 Int32 data[2] = {-15000, 15000};
 Int32 cosine[4] = {1, 0, -1, 0};
-Int32 i;
 
-float x[10];
+Polyphase shaper;	// B[] split into samplesPerSymbol phases, see StartUp
 float y;
 float output;
 
@@ -46,9 +46,10 @@ interrupt void Codec_ISR()
 //
 // Returns:   Nothing
 //
-// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData,
+//            DelayLine_Put, Polyphase_Run
 //
-// Notes:     None
+// Notes:     Silent until StartUp has set up the shaper
 ///////////////////////////////////////////////////////////////////////
 {                    
 	/* add any local variables here */
@@ -61,25 +62,24 @@ interrupt void Codec_ISR()
 	/* add your code starting here */
 
 	// I added my IM BPSK routine here
-    if (counter == 0) {
-		symbol = rand() & 1; // a faster version of rand() % 2
-		x[0] = data[symbol]; // read the table
+	if (shaper.memory == NULL) {
+		WriteCodecData(0);
+		return;
 	}
 
-    // perform impulse modulation based on the FIR filter, B[N] 
-    y  = 0;
+    if (counter == 0) {
+		symbol = rand() & 1; // a faster version of rand() % 2
+		DelayLine_Put(&shaper.line, data[symbol]); // read the table
 
-    for (i = 0; i < 10; i++) {
-		y +=  x[i]*B[counter + 20*i];	// perform the dot-product
+		// impulse modulation based on the FIR filter, B[N]: all
+		// samplesPerSymbol outputs of this symbol, one per phase
+		Polyphase_Run(&shaper, 1);
 	}
+
+    y = shaper.y[counter];
     
     if (counter == (samplesPerSymbol - 1)) {
     	counter = -1; 
-
-		/* shift x[] in preparation for the next symbol */
- 		for (i = 9; i > 0; i--) {
-			x[i] = x[i - 1];          // setup x[] for the next input
-		}
    	}
 
    	counter++;
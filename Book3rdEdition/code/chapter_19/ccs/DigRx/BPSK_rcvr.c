@@ -0,0 +1,154 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: BPSK_rcvr.c
+//
+// Synopsis: Per-channel BPSK receiver: Hilbert transform, carrier PLL,
+//           matched filter and ML symbol timing recovery, as in
+//           Codec_ISR of BPSK_rcvr_ISRs.c.  The arithmetic is done in
+//           the same order, so each channel's output matches the ISR's
+//           RIGHT channel.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <math.h>
+#include "BPSK_rcvr.h"
+
+static const float alpha_PLL = 0.01;	// loop filter parameter
+static const float beta_PLL = 0.002;	// loop filter parameter
+
+static const float alpha_ML = 0.1;		// loop filter parameter
+static const float beta_ML = 0.02;		// loop filter parameter
+
+static const float twoPi = 6.2831853072;		// 2pi
+static const float piBy2 = 1.57079632679;		// pi/2
+static const float piBy10 = 0.314159265359;		// pi/10
+static const float piBy100 = 0.0314159265359;	// pi/100
+static const float scaleFactor = 3.0517578125e-5;
+static const float gain = 3276.8;
+
+// used by the multi-channel host driver, common_code/Host/Multi
+const StreamAlgorithm BPSK_rcvr_Algorithm = {
+	"BPSK_Rx", sizeof(BPSK_rcvr), BPSK_rcvr_Init, BPSK_rcvr_Process, 0	// LEFT
+};
+
+void BPSK_rcvr_Init(void *state)
+{
+	BPSK_rcvr *s = state;
+
+	memset(s, 0, sizeof(BPSK_rcvr));
+	s->ML_on_off = 1;
+}
+
+void BPSK_rcvr_Process(void *state, const float *in, float *out, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Demodulates a block of one channel
+//
+// Input:     state - the channel's BPSK_rcvr
+//            in - received BPSK signal, codec scale
+//            out - matched filter output, codec scale
+//            n - samples in the block
+//
+// Returns:   Nothing
+//
+// Calls:     cosf, sinf
+//
+// Notes:     Like the ISR, element 0 of the matched filter's circular
+//            buffer is overwritten by every new sample as well as the
+//            element at newest
+///////////////////////////////////////////////////////////////////////
+{
+	BPSK_rcvr *s = state;
+	float *x = s->x, *pd = s->phaseDetectorOutputReal, *mf = s->matchedfilterout;
+	float sReal, sImag, vcoOutputReal, vcoOutputImag, phaseDetectorOutputImag;
+	float q_loop, PLL_loopFilterOutput, diffoutput, adjustment, data, ML_loopFilterOutput;
+	Uint32 k, p;
+	Int32 i;
+
+	for(k = 0; k < n; k++) {
+		x[0] = in[k];
+
+		// execute Hilbert transform and group delay compensation
+		sImag = (x[0] - x[6])*B_hilbert[0] + (x[2] - x[4])*B_hilbert[2];
+		sReal = x[3]*scaleFactor; // scale and account for the group delay
+
+		for(i = N; i > 0; i--) {
+			x[i] = x[i-1];
+		}
+
+		sImag *= scaleFactor;
+
+		// execute the PLL
+		vcoOutputReal = cosf(s->phi);
+		vcoOutputImag = sinf(s->phi);
+		pd[0] = sReal*vcoOutputReal + sImag*vcoOutputImag;
+		phaseDetectorOutputImag = sImag*vcoOutputReal - sReal*vcoOutputImag;
+		q_loop = pd[0] * phaseDetectorOutputImag;
+		s->sigma_loop += beta_PLL*q_loop;
+		PLL_loopFilterOutput = s->sigma_loop + alpha_PLL*q_loop;
+		s->phi += piBy2 + PLL_loopFilterOutput;
+
+		while(s->phi > twoPi) {
+			s->phi -= twoPi;  // modulo 2pi operation for accumulator
+		}
+
+		// execute the matched filter (MF)
+		pd[s->newest] = pd[0];
+
+		mf[0] = 0;
+		p = s->newest;
+		s->newest = s->newest < M ? s->newest + 1 : 0;
+		for (i = 0; i <= M; i++) {
+			mf[0] += pd[p] * B_MF[i];
+			p = p ? p - 1 : M;
+		}
+
+		// execute the differentiation filter
+		diffoutput = mf[0] - mf[2];
+
+		// execute the ML timing recovery loop
+		s->sync = 0;
+		if(s->accumulator >= twoPi) {
+			s->sync = 20000;
+			data = -1;
+			if(mf[0] >= 0) { // recover data
+				data = 1;
+			}
+			adjustment = data*diffoutput;
+			s->sigma_ML += beta_ML*adjustment;
+			// prevents timing adjustments of more than +/- 1 sample
+			if (s->sigma_ML > piBy10) {
+				s->sigma_ML = piBy10;
+			}
+			else if (s->sigma_ML < -piBy10) {
+				s->sigma_ML = -piBy10;
+			}
+			ML_loopFilterOutput = s->sigma_ML + alpha_ML*adjustment;
+
+			// prevents timing adjustments of more than +/- 0.1 sample
+			if (ML_loopFilterOutput > piBy100) {
+				ML_loopFilterOutput = piBy100;
+			}
+			else if (ML_loopFilterOutput < -piBy100) {
+				ML_loopFilterOutput = -piBy100;
+			}
+			if (s->ML_on_off == 1) {
+				s->accumulator -= (twoPi + ML_loopFilterOutput);
+			}
+			else {
+				s->accumulator -= twoPi;
+			}
+		}
+
+		// increment the accumulator
+		s->accumulator += piBy10;
+
+		// setup matchedfilterout for the next input
+		mf[2] = mf[1];
+		mf[1] = mf[0];
+
+		out[k] = gain * mf[1];
+	}
+}
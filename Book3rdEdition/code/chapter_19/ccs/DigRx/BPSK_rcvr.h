@@ -0,0 +1,40 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: BPSK_rcvr.h
+//
+// Synopsis: The BPSK receiver of BPSK_rcvr_ISRs.c with its globals
+//           gathered into a per-channel state, so that any number of
+//           receivers can run at once (see StreamSched.h)
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	BPSK_RCVR_H_INCLUDED
+#define BPSK_RCVR_H_INCLUDED
+
+#include "tistdtypes.h"
+#include "hilbert.h"
+#include "matched_120.h"
+#include "StreamSched.h"
+
+typedef struct {
+	float x[N+1];						// input signal
+	float phaseDetectorOutputReal[M+1];	// matched filter input, circular
+	Uint32 newest;						// index of the newest matched filter input
+	float sigma_loop;					// part of the PLL loop filter
+	float phi;							// phase accumulator value
+	float matchedfilterout[3];
+	float sigma_ML;						// part of the ML loop filter
+	float accumulator;
+	Int32 sync;							// O-scope trigger, 20000 at each symbol
+	float ML_on_off;					// 1 enables the ML timing loop
+} BPSK_rcvr;
+
+// defined in BPSK_rcvr.c
+void BPSK_rcvr_Init(void *);
+void BPSK_rcvr_Process(void *, const float *, float *, Uint32);
+
+extern const StreamAlgorithm BPSK_rcvr_Algorithm;
+
+#endif
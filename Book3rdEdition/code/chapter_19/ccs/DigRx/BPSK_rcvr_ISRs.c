@@ -12,6 +12,8 @@
 #include "hilbert.h" 
 #include "math.h"
 #include "matched_120.h"
+#include "DelayLine.h"
+#include "SparseFIR.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -41,7 +43,10 @@ float piBy100 = 0.0314159265359; // pi/100
 float scaleFactor = 3.0517578125e-5;
 float gain = 3276.8;
 
-float x[N+1] = {0,0,0,0,0,0,0}; // input signal
+float xLeft[2*(N+1)];	// input signal, stored twice
+DelayLine left = {xLeft, N+1, 0};	// see DelayLine.h
+const float *x;			// the last N+1 inputs, x[N] the newest
+SparseFIR hilbert;		// B_hilbert[] without its zero taps, set by StartUp
 float sReal = 0;  // real part of the analytical signal
 float sImag = 0;  // imag part of the analytical signal
 
@@ -80,9 +85,10 @@ interrupt void Codec_ISR()
 //
 // Returns:   Nothing
 //
-// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData,
+//            DelayLine_Put, DelayLine_Window, SparseFIR_Run
 //
-// Notes:     None
+// Notes:     Silent until StartUp has set up the Hilbert filter
 ///////////////////////////////////////////////////////////////////////
 {                    
 	/* add any local variables here */
@@ -95,17 +101,20 @@ interrupt void Codec_ISR()
 	/* add your code starting here */
 
 	// my algorithm starts here ...
-	// bring in input value
-	x[0]  = CodecDataIn.Channel[LEFT];  // current LEFT input value
-
-	// execute Hilbert transform and group delay compensation
-	sImag = (x[0] - x[6])*B_hilbert[0] + (x[2] - x[4])*B_hilbert[2];
-	sReal = x[3]*scaleFactor; // scale and account for the group delay
-	
-	// setup x for the next input
-	for(i = N; i >0; i--) {
-		x[i] = x[i-1];  
+	if(hilbert.memory == NULL) {
+		WriteCodecData(0);
+		return;
 	}
+
+	// bring in input value
+	DelayLine_Put(&left, CodecDataIn.Channel[LEFT]);  // current LEFT input value
+	x = DelayLine_Window(&left, N+1);
+
+	// execute Hilbert transform and group delay compensation; the
+	// filter is folded and skips the zero taps, which gives
+	// (x[6] - x[0])*B_hilbert[0] + (x[4] - x[2])*B_hilbert[2]
+	SparseFIR_Run(&hilbert, x, &sImag, 1);
+	sReal = x[N-3]*scaleFactor; // scale and account for the group delay
 	
 	sImag *= scaleFactor;
 	
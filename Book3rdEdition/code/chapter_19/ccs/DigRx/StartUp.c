@@ -9,9 +9,14 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "DSP_Config.h"
+#include "hilbert.h"
+#include "SparseFIR.h"
+
+extern SparseFIR hilbert;	// in BPSK_rcvr_ISRs.c
 
 
 void StartUp()
 {
-	;
+	// find the Hilbert transformer's zero taps once, not per sample
+	SparseFIR_Init(&hilbert, B_hilbert, N+1);
 }
@@ -8,10 +8,28 @@
 //
 ///////////////////////////////////////////////////////////////////////
 
+#include <stdio.h>
 #include "DSP_Config.h"
+#include "coeff.h"
+#include "Polyphase.h"
 
+extern Polyphase shaperI, shaperQ;	// in impulseModulatedQPSK_ISRs.c
+extern const Int32 samplesPerSymbol;
+
+// the shapers' memory, static since together they are larger than the
+// board's heap; sized for 20 samples per symbol
+#define SHAPER_FLOATS	POLYPHASE_FLOATS(B_SIZE - 1, 20, 1, 1)
+static float shaperMemory[2][SHAPER_FLOATS];
 
 void StartUp()
 {
-	;
+	// pulse shape at samplesPerSymbol times the symbol rate, 6 symbols
+	// long (B[B_SIZE-1] is past them); the ISR starts sending once both
+	// are set up
+	if(!Polyphase_InitStatic(&shaperI, B, B_SIZE - 1, samplesPerSymbol, 1, 1,
+		shaperMemory[0], SHAPER_FLOATS)
+		|| !Polyphase_InitStatic(&shaperQ, B, B_SIZE - 1, samplesPerSymbol, 1, 1,
+		shaperMemory[1], SHAPER_FLOATS))
+		printf("QPSK: no shapers for %d samples per symbol, raise SHAPER_FLOATS\n",
+			samplesPerSymbol);
 }
@@ -11,6 +11,7 @@
 #include "DSP_Config.h" 
 #include "coeff.h"   // load the filter coefficients, B[n] ... extern
 #include <stdlib.h>  // needed to call the rand() function
+#include "Polyphase.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -42,8 +43,7 @@ const float QPSK_LUT[4][2] = {
 };
 
 float output_gain = 1.0;
-float xI[6];
-float xQ[6];
+Polyphase shaperI, shaperQ; // B[] split into samplesPerSymbol phases, see StartUp
 float yI;
 float yQ;
 float output;
@@ -57,14 +57,14 @@ interrupt void Codec_ISR()
 //
 // Returns:   Nothing
 //
-// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData,
+//            DelayLine_Put, Polyphase_Run
 //
-// Notes:     None
+// Notes:     Silent until StartUp has set up the shapers
 ///////////////////////////////////////////////////////////////////////
 {                    
 	/* add any local variables here */
 	Int32 symbol;
-	Int32 i;
 
  	if(CheckForOverrun())					// overrun error occurred (i.e. halted DSP)
 		return;								// so serial port is reset to recover
@@ -74,29 +74,27 @@ interrupt void Codec_ISR()
 	/* add your code starting here */
 
 	// I added my impulse modulated QPSK routine here
-	if (counter == 0) {
-		symbol = rand() & 3; /* generate 2 random bits */
-		xI[0]  = QPSK_LUT[symbol][RIGHT];  
-		xQ[0]  = QPSK_LUT[symbol][ LEFT];   
+	if (shaperI.memory == NULL || shaperQ.memory == NULL) {
+		WriteCodecData(0);
+		return;
 	}
 
-	// perform impulse modulation based on the FIR filter, B[N]
-	yI = 0;
-	yQ = 0;
+	if (counter == 0) {
+		symbol = rand() & 3; /* generate 2 random bits */
+		DelayLine_Put(&shaperI.line, QPSK_LUT[symbol][RIGHT]);  
+		DelayLine_Put(&shaperQ.line, QPSK_LUT[symbol][ LEFT]);   
 
-	for (i = 0; i < 6; i++) {
-		yI += xI[i]*B[counter + 20*i];	// perform the "I" dot-product
-		yQ += xQ[i]*B[counter + 20*i];	// perform the "Q" dot-product
+		// impulse modulation based on the FIR filter, B[N]: all
+		// samplesPerSymbol "I" and "Q" outputs of this symbol
+		Polyphase_Run(&shaperI, 1);
+		Polyphase_Run(&shaperQ, 1);
 	}
+
+	yI = shaperI.y[counter];
+	yQ = shaperQ.y[counter];
     
 	if (counter >= (samplesPerSymbol - 1)) {
 		counter = -1; 
-
-		/* shift xI[] and xQ[] in preparation to receive the next input */
-		for (i = 5; i > 0; i--) {
-			xI[i] = xI[i-1];  // setup xI[] for the next input value
-			xQ[i] = xQ[i-1];  // setup xQ[] for the next input value
-		}
 	}
 
 	counter++;
@@ -9,9 +9,16 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "DSP_Config.h"
+#include "Biquad.h"
+
+extern float SOS[4][6];				// in the ISRs file
+extern Biquad filterQ, filterI;
 
 
 void StartUp()
 {
 	InitDigitalOutputs();
+	// the I and Q matched filters share one set of sections
+	Biquad_Init(&filterQ, SOS[0], 4, 6, BIQUAD_DF2, 1);
+	Biquad_Init(&filterI, SOS[0], 4, 6, BIQUAD_DF2, 1);
 }
@@ -10,6 +10,7 @@
 
 #include "DSP_Config.h" 
 #include <math.h> 
+#include "Biquad.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -30,31 +31,21 @@ Int32 fourcount = 0;
 Int32 costable[4] = {1, 0, -1, 0};
 Int32 sintable[4] = {0, 1, 0, -1};
 
-float Output_Q[5] = {0, 0, 0, 0, 0};
-float Output_I[5] = {0, 0, 0, 0, 0};
+float Output_Q[2] = {0, 0};	// matched filter input and output
+float Output_I[2] = {0, 0};
 
 /* IIR-based matched filters using four second order sections (SOS) */
 float SOS_Gain = -0.005691614547251;
 
-float Stage1_B[3] = {1.0, -0.669057621555000, -0.505837557192856};
-float Stage2_B[3] = {1.0, -1.636373970290336,  0.793253123708712};
-float Stage3_B[3] = {1.0, -2.189192793892326,  1.206129332609970};
-float Stage4_B[3] = {1.0, -1.927309142277217,  0.981006820709641};
+// one row {b0, b1, b2, a0, a1, a2} per section
+float SOS[4][6] = {
+	{1.0, -0.669057621555000, -0.505837557192856, 1.0, -1.898291587416584, 0.901843187948439},
+	{1.0, -1.636373970290336,  0.793253123708712, 1.0, -1.898520943904540, 0.909540256532186},
+	{1.0, -2.189192793892326,  1.206129332609970, 1.0, -1.906315962519294, 0.928697673452646},
+	{1.0, -1.927309142277217,  0.981006820709641, 1.0, -1.920806676700677, 0.957209542544347}
+};
 
-float Stage1_A[3] = {1.0, -1.898291587416584, 0.901843187948439};
-float Stage2_A[3] = {1.0, -1.898520943904540, 0.909540256532186};
-float Stage3_A[3] = {1.0, -1.906315962519294, 0.928697673452646};
-float Stage4_A[3] = {1.0, -1.920806676700677, 0.957209542544347};
-
-float Stage1_Q[3] = {0, 0, 0};
-float Stage2_Q[3] = {0, 0, 0};
-float Stage3_Q[3] = {0, 0, 0};
-float Stage4_Q[3] = {0, 0, 0};
-	
-float Stage1_I[3] = {0, 0, 0};
-float Stage2_I[3] = {0, 0, 0};
-float Stage3_I[3] = {0, 0, 0};
-float Stage4_I[3] = {0, 0, 0};
+Biquad filterQ, filterI;	// the sections' state, set up by StartUp
 
 float I, Q;
 float Iscaled[3] = {0, 0, 0};
@@ -100,64 +91,22 @@ interrupt void Codec_ISR()
   	CodecDataIn.UINT = ReadCodecData();	// get input data samples
 	
 	/* add your code starting here */
+	if (filterI.memory == NULL) {
+		WriteCodecData(0);
+		return;
+	}
+
 	// demodulate ... multiplication by the free running oscillators	
 	Output_I[0] = SOS_Gain*CodecDataIn.Channel[LEFT]*sintable[fourcount];
 	Output_Q[0] = SOS_Gain*CodecDataIn.Channel[LEFT]*costable[fourcount];
 	
-	// 8th order, IIR-based matched filters 
-	Stage1_Q[0] = Stage1_A[0]*Output_Q[0] - 
-		Stage1_A[1]*Stage1_Q[1] - Stage1_A[2]*Stage1_Q[2];
-	Output_Q[1] = Stage1_B[0]*Stage1_Q[0] + 
-		Stage1_B[1]*Stage1_Q[1] + Stage1_B[2]*Stage1_Q[2];
-	
-	Stage1_I[0] = Stage1_A[0]*Output_I[0] - 
-		Stage1_A[1]*Stage1_I[1] - Stage1_A[2]*Stage1_I[2];
-	Output_I[1] = Stage1_B[0]*Stage1_I[0] + 
-		Stage1_B[1]*Stage1_I[1] + Stage1_B[2]*Stage1_I[2];
-	
-	Stage2_Q[0] = Stage2_A[0]*Output_Q[1] - 
-		Stage2_A[1]*Stage2_Q[1] - Stage2_A[2]*Stage2_Q[2];
-	Output_Q[2] = Stage2_B[0]*Stage2_Q[0] + 
-		Stage2_B[1]*Stage2_Q[1] + Stage2_B[2]*Stage2_Q[2];
-	Stage2_I[0] = Stage2_A[0]*Output_I[1] - 
-		Stage2_A[1]*Stage2_I[1] - Stage2_A[2]*Stage2_I[2];
-	Output_I[2] = Stage2_B[0]*Stage2_I[0] + 
-		Stage2_B[1]*Stage2_I[1] + Stage2_B[2]*Stage2_I[2];
-	
-	Stage3_Q[0] = Stage3_A[0]*Output_Q[2] - 
-		Stage3_A[1]*Stage3_Q[1] - Stage3_A[2]*Stage3_Q[2];
-	Output_Q[3] = Stage3_B[0]*Stage3_Q[0] + 
-		Stage3_B[1]*Stage3_Q[1] + Stage3_B[2]*Stage3_Q[2];
-	Stage3_I[0] = Stage3_A[0]*Output_I[2] - 
-		Stage3_A[1]*Stage3_I[1] - Stage3_A[2]*Stage3_I[2];
-	Output_I[3] = Stage3_B[0]*Stage3_I[0] + 
-		Stage3_B[1]*Stage3_I[1] + Stage3_B[2]*Stage3_I[2];
-	
-	Stage4_Q[0] = Stage4_A[0]*Output_Q[3] - 
-		Stage4_A[1]*Stage4_Q[1] - Stage4_A[2]*Stage4_Q[2];
-	Output_Q[4] = Stage4_B[0]*Stage4_Q[0] + 
-		Stage4_B[1]*Stage4_Q[1] + Stage4_B[2]*Stage4_Q[2];
-	Stage4_I[0] = Stage4_A[0]*Output_I[3] - 
-		Stage4_A[1]*Stage4_I[1] - Stage4_A[2]*Stage4_I[2];
-	Output_I[4] = Stage4_B[0]*Stage4_I[0] + 
-		Stage4_B[1]*Stage4_I[1] + Stage4_B[2]*Stage4_I[2];
-	
-	// update the matched filter's state
-	for (i=0; i<2; i++) {
-        Stage1_Q[2-i] = Stage1_Q[(2-i)-1];
-		Stage2_Q[2-i] = Stage2_Q[(2-i)-1];
-		Stage3_Q[2-i] = Stage3_Q[(2-i)-1];
-		Stage4_Q[2-i] = Stage4_Q[(2-i)-1];
-
-		Stage1_I[2-i] = Stage1_I[(2-i)-1];
-		Stage2_I[2-i] = Stage2_I[(2-i)-1];
-		Stage3_I[2-i] = Stage3_I[(2-i)-1];
-		Stage4_I[2-i] = Stage4_I[(2-i)-1];
-	}
+	// 8th order, IIR-based matched filters
+	Biquad_Run(&filterQ, &Output_Q[0], &Output_Q[1], 1);
+	Biquad_Run(&filterI, &Output_I[0], &Output_I[1], 1);
 	
 	// apply the AGC gain
-	Iscaled[0] = AGCgain*Output_I[4];
-    Qscaled[0] = AGCgain*Output_Q[4];
+	Iscaled[0] = AGCgain*Output_I[1];
+    Qscaled[0] = AGCgain*Output_Q[1];
     
     // calculate the new AGC gain
     magnitude = sqrtf(Iscaled[0]*Iscaled[0] + Qscaled[0]*Qscaled[0]);
@@ -0,0 +1,246 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: batch.c
+//
+// Synopsis: Runs a host-built example program over a corpus of WAV
+//           files, several files at a time.  The programs keep their
+//           filter state in globals, so each file gets its own process
+//           and therefore its own state; up to one process per core
+//           runs at once.  Output goes to outdir with the input's name.
+//
+//           usage: batch [-j jobs] [-o outdir] [-l list] program [file ...]
+//
+//           -j  processes at once (default: the number of cores)
+//           -o  output directory (default: no output files)
+//           -l  read file names, one per line, from list ("-" is stdin)
+//
+//           The program is run as "program in.wav out.wav" with
+//           HOST_CODEC_IN/HOST_CODEC_OUT set as well, so both the host
+//           main.c and programs with their own main() work.  EDMA
+//           programs run with HOST_EDMA_SPEED=0 (no frame clock)
+//           unless HOST_EDMA_SPEED is already set.
+//
+///////////////////////////////////////////////////////////////////////
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "Host_Codec.h"
+
+typedef struct {
+	pid_t  pid;				// 0 when the slot is free
+	char  *name;			// input file
+	double start;			// start time, seconds
+} BatchJob;
+
+static char **Files = NULL;
+static Uint32 NumFiles = 0, MaxFiles = 0;
+
+// HostCodec_Open, unused here, refers to the program's sample rate
+float GetSampleFreq()
+{
+	return 48000.0F;
+}
+
+static double Now()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static void AddFile(const char *name)
+{
+	if(NumFiles == MaxFiles) {
+		MaxFiles = MaxFiles ? 2 * MaxFiles : 256;
+		if((Files = realloc(Files, MaxFiles * sizeof(char *))) == NULL) {
+			fprintf(stderr, "batch: out of memory\n");
+			exit(1);
+		}
+	}
+	Files[NumFiles++] = strdup(name);
+}
+
+static void ReadList(const char *list)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Adds the file names listed in a file
+//
+// Input:     list - file with one name per line, "-" for stdin
+//
+// Returns:   Nothing
+//
+// Calls:     AddFile
+//
+// Notes:     Blank lines are skipped
+///////////////////////////////////////////////////////////////////////
+{
+	FILE *f = strcmp(list, "-") ? fopen(list, "r") : stdin;
+	char line[4096];
+	size_t n;
+
+	if(f == NULL) {
+		fprintf(stderr, "batch: cannot read %s\n", list);
+		exit(1);
+	}
+	while(fgets(line, sizeof(line), f)) {
+		n = strcspn(line, "\r\n");
+		line[n] = 0;
+		if(n)
+			AddFile(line);
+	}
+	if(f != stdin)
+		fclose(f);
+}
+
+static double AudioSeconds(const char *name)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the length of an input file
+//
+// Input:     name - WAV or raw file
+//
+// Returns:   Duration in seconds, 0 if unknown
+//
+// Calls:     HostStream_OpenRead, HostStream_Close
+//
+// Notes:     Raw files are assumed to be at 48 kHz
+///////////////////////////////////////////////////////////////////////
+{
+	HostStream s;
+	double seconds;
+
+	if(!HostStream_OpenRead(&s, name))
+		return 0;
+	seconds = s.frames / (double)(s.rate ? s.rate : 48000);
+	HostStream_Close(&s);
+	return seconds;
+}
+
+static pid_t Launch(const char *program, const char *in, const char *outdir)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Starts the program on one input file
+//
+// Input:     program - host-built example program
+//            in - input file
+//            outdir - output directory, NULL for no output
+//
+// Returns:   Process id, or -1 if it could not be started
+//
+// Calls:     fork, execv
+//
+// Notes:     The child's console output goes to stderr, so it stays
+//            apart from the batch report
+///////////////////////////////////////////////////////////////////////
+{
+	const char *base = strrchr(in, '/') ? strrchr(in, '/') + 1 : in;
+	char *out = NULL;
+	pid_t pid;
+
+	if(outdir && asprintf(&out, "%s/%s", outdir, base) < 0)
+		return -1;
+	pid = fork();
+	if(pid == 0) {
+		setenv("HOST_CODEC_IN", in, 1);
+		if(out)
+			setenv("HOST_CODEC_OUT", out, 1);
+		else
+			unsetenv("HOST_CODEC_OUT");
+		setenv("HOST_EDMA_SPEED", "0", 0);
+		dup2(2, 1);
+		execl(program, program, in, out, (char *)NULL);
+		fprintf(stderr, "batch: cannot run %s: %s\n", program, strerror(errno));
+		_exit(127);
+	}
+	free(out);
+	return pid;
+}
+
+int main(int argc, char *argv[])
+{
+	Int32 jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	const char *outdir = NULL, *program;
+	BatchJob *job;
+	Uint32 next = 0, running = 0, failed = 0;
+	Int32 i;
+	double start, audio = 0, elapsed;
+	int opt, status;
+	pid_t pid;
+
+	while((opt = getopt(argc, argv, "j:o:l:")) != -1) {
+		switch(opt) {
+		case 'j':	jobs = atoi(optarg);	break;
+		case 'o':	outdir = optarg;		break;
+		case 'l':	ReadList(optarg);		break;
+		default:
+			fprintf(stderr, "usage: %s [-j jobs] [-o outdir] [-l list] program [file ...]\n", argv[0]);
+			return 2;
+		}
+	}
+	if(optind >= argc) {
+		fprintf(stderr, "usage: %s [-j jobs] [-o outdir] [-l list] program [file ...]\n", argv[0]);
+		return 2;
+	}
+	program = argv[optind++];
+	while(optind < argc)
+		AddFile(argv[optind++]);
+	if(jobs < 1)
+		jobs = 1;
+	if(outdir && mkdir(outdir, 0777) && errno != EEXIST) {
+		fprintf(stderr, "batch: cannot create %s\n", outdir);
+		return 1;
+	}
+	if((job = calloc(jobs, sizeof(BatchJob))) == NULL)
+		return 1;
+
+	start = Now();
+	while(next < NumFiles || running) {
+		// fill the free slots
+		for(i = 0; i < jobs && next < NumFiles; i++) {
+			if(job[i].pid)
+				continue;
+			audio += AudioSeconds(Files[next]);
+			if((job[i].pid = Launch(program, Files[next], outdir)) <= 0) {
+				printf("FAIL %s (cannot start)\n", Files[next]);
+				job[i].pid = 0;
+				failed++;
+				next++;
+				continue;
+			}
+			job[i].name = Files[next++];
+			job[i].start = Now();
+			running++;
+		}
+
+		// wait for one to finish
+		if(running == 0 || (pid = wait(&status)) < 0)
+			continue;
+		for(i = 0; i < jobs && job[i].pid != pid; i++)
+			;
+		if(i == jobs)
+			continue;
+		// the EDMA emulator exits 1 if a frame was not processed in time
+		if(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+			printf("ok   %s (%.3f s)\n", job[i].name, Now() - job[i].start);
+		else {
+			printf("FAIL %s (%s %d)\n", job[i].name, WIFEXITED(status) ? "exit" : "signal",
+				WIFEXITED(status) ? WEXITSTATUS(status) : WTERMSIG(status));
+			failed++;
+		}
+		fflush(stdout);
+		job[i].pid = 0;
+		running--;
+	}
+	elapsed = Now() - start;
+
+	printf("%u files, %u failed, %.1f s of audio in %.3f s (%.0fx real time) with %d jobs\n",
+		NumFiles, failed, audio, elapsed, elapsed > 0 ? audio / elapsed : 0, jobs);
+	return failed != 0;
+}
@@ -0,0 +1,146 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: bench.c
+//
+// Synopsis: Host main program measuring the throughput of an example
+//           program.  Link it in place of main.c (or the program's
+//           own main.c).  Seeded noise is fed as fast as the host
+//           allows through Codec_ISR, ProcessBuffer for frame
+//           programs, or the EDMA frames for EDMA programs, and one
+//           JSON record is printed:
+//
+//           {"kernel": "FIRrevD", "samples": 1000000, "seed": 1,
+//            "seconds": 0.0153, "samples_per_second": 6.5e+07,
+//            "ns_per_sample": 15.3, "allocations": 0, "bytes_allocated": 0}
+//
+//           usage: program [samples [seed [name]]]
+//
+///////////////////////////////////////////////////////////////////////
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "DSP_Config.h"
+#include "Host_Codec.h"
+#include "Host_EDMA.h"
+#include "Host_Support_DSP.h"
+
+// the parts of the program present decide how it is driven
+extern void Codec_ISR() __attribute__((weak));
+extern void StartUp() __attribute__((weak));
+extern void ZeroBuffers() __attribute__((weak));
+extern void EDMA_Init() __attribute__((weak));
+extern void ProcessBuffer() __attribute__((weak));
+extern int  IsBufferReady() __attribute__((weak));
+
+// heap use while the program runs, see the allocator wrappers below
+static volatile Uint32 Allocations = 0;
+static volatile size_t BytesAllocated = 0;
+
+#ifdef __GLIBC__
+extern void *__libc_malloc(size_t);
+extern void *__libc_calloc(size_t, size_t);
+extern void *__libc_realloc(void *, size_t);
+
+void *malloc(size_t n)
+{
+	Allocations++;
+	BytesAllocated += n;
+	return __libc_malloc(n);
+}
+
+void *calloc(size_t n, size_t size)
+{
+	Allocations++;
+	BytesAllocated += n * size;
+	return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t n)
+{
+	Allocations++;
+	BytesAllocated += n;
+	return __libc_realloc(p, n);
+}
+#endif
+
+static double Now()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static void ProcessReadyBuffers()
+{
+	if(ProcessBuffer && IsBufferReady && IsBufferReady())
+		ProcessBuffer();
+}
+
+int main(int argc, char *argv[])
+{
+	Uint32 samples = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+	Uint32 seed = argc > 2 ? strtoul(argv[2], NULL, 0) : 1;
+	const char *name = argc > 3 ? argv[3] : (strrchr(argv[0], '/') ? strrchr(argv[0], '/') + 1 : argv[0]);
+	char noise[32];
+	Uint32 n, allocations;
+	size_t bytes;
+	double t;
+
+	if(argc > 4 || samples == 0) {
+		fprintf(stderr, "usage: %s [samples [seed [name]]]\n", argv[0]);
+		return 2;
+	}
+	if(!Codec_ISR && !EDMA_Init) {
+		fprintf(stderr, "%s: no Codec_ISR or EDMA_Init to drive\n", argv[0]);
+		return 2;
+	}
+	sprintf(noise, "noise:%u:%u", samples, seed);
+	srand(seed);						// for programs drawing rand() symbols
+
+	// same start-up order as the programs' own main()
+	Host_SetInterruptMode(HOST_ISR_POLLED);
+	if(ZeroBuffers)
+		ZeroBuffers();
+	if(EDMA_Init) {
+		EDMA_Init();
+		DSP_Init_EDMA();
+	}
+	else
+		DSP_Init();
+	if(!HostCodec_Open(noise, NULL))
+		return 1;
+	if(StartUp)
+		StartUp();
+
+	allocations = Allocations;
+	bytes = BytesAllocated;
+	t = Now();
+	if(EDMA_Init) {
+		while(HostEDMA_Step())
+			ProcessReadyBuffers();
+		n = HostCodec_GetSampleCount();
+	}
+	else {
+		// transmitters read no input, so count interrupts, not samples
+		for(n = 0; n < samples; n++) {
+			Codec_ISR();
+			ProcessReadyBuffers();
+		}
+	}
+	t = Now() - t;
+	allocations = Allocations - allocations;
+	bytes = BytesAllocated - bytes;
+	HostCodec_Close();
+
+	printf("{\"kernel\": \"%s\", \"samples\": %u, \"seed\": %u, \"seconds\": %.6f, "
+		"\"samples_per_second\": %.6g, \"ns_per_sample\": %.4g, "
+		"\"allocations\": %u, \"bytes_allocated\": %zu}\n",
+		name, n, seed, t, n / t, 1e9 * t / n, allocations, bytes);
+	return 0;
+}
@@ -0,0 +1,88 @@
+#!/bin/sh
+# Welch, Wright, & Morrow,
+# Real-time Digital Signal Processing, 2017
+#
+#######################################################################
+# Filename: bench.sh
+#
+# Synopsis: Builds the chapter kernels with bench.c and prints their
+#           throughput as a JSON array, one record per kernel.  Run
+#           from Book3rdEdition/code:
+#
+#               sh common_code/Host/Bench/bench.sh > bench.json
+#
+#           SAMPLES and SEED set the noise input (default 1000000, 1),
+#           CC and CFLAGS the compiler, BENCH_DIR the build directory.
+#           Pass kernel names to run only those.
+#
+#######################################################################
+
+H=common_code/Host
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--O2}
+SAMPLES=${SAMPLES:-1000000}
+SEED=${SEED:-1}
+BENCH_DIR=${BENCH_DIR:-/tmp/rtdsp_bench}
+
+# name | project directory | sources
+KERNELS="
+FIRrevA|chapter_03/ccs/FIRrevA|FIRmono_ISRs.c StartUp.c
+FIRrevB|chapter_03/ccs/FIRrevB|FIRmono_ISRs.c coeff.c StartUp.c
+FIRrevC|chapter_03/ccs/FIRrevC|FIRmono_ISRs.c coeff.c StartUp.c
+FIRrevD|chapter_03/ccs/FIRrevD|FIRmono_ISRs.c coeff.c StartUp.c
+FiltFrm|chapter_07/ccs/FiltFrm_6748|ISRs.c COEFF.C
+IIR_SOS_DF2|chapter_12/ccs|sosIIRmonoFun_ISRs.c StartUp.c
+fft_c|chapter_09/ccs/FFT_FRAME|ISRs.c
+LMS|chapter_14/ccs|ISRsAF.c
+AMrx|chapter_16/ccs/AMrx|AMreceiver_ISRs.c coeff.c StartUp.c
+PLL|chapter_17/ccs/PLL|PLL_ISRs.c coeff.c StartUp.c
+BPSK_Tx|chapter_18/ccs/DigTxIM|impulseModulatedBPSK_ISRs.c coeff.c StartUp.c
+BPSK_Rx|chapter_19/ccs/DigRx|BPSK_rcvr_ISRs.c hilbert.c matched_120.c StartUp.c
+QPSK_Tx|chapter_20/ccs/QPSK_Tx|impulseModulatedQPSK_ISRs.c coeff.c StartUp.c
+QPSK_Rx|chapter_21/ccs/QPSK_Rx|ISRs_QPSK_Rx.c StartUp.c
+"
+
+HOSTFLAGS="-no-pie -include Host_Target.h -I$H -I common_code/LCDK -I common_code/Lib
+	-Wno-unknown-pragmas -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast"
+
+# the support code is the same for every kernel, so build it once
+mkdir -p "$BENCH_DIR/support" || exit 1
+SUPPORT=""
+for S in $H/Bench/bench.c $H/Host_Codec.c $H/Host_EDMA.c $H/Host_Support_DSP.c common_code/Lib/*.c; do
+	O="$BENCH_DIR/support/$(basename "$S" .c).o"
+	$CC $CFLAGS $HOSTFLAGS -c "$S" -o "$O" || exit 1
+	SUPPORT="$SUPPORT $O"
+done
+SEP=""
+
+echo "["
+echo "$KERNELS" | while IFS='|' read NAME DIR SRCS; do
+	[ -z "$NAME" ] && continue
+	if [ $# -gt 0 ] && ! echo " $* " | grep -q " $NAME "; then
+		continue
+	fi
+
+	# some projects spell their coefficient header COEFF.H
+	INC="$BENCH_DIR/$NAME.inc"
+	mkdir -p "$INC"
+	[ -f "$DIR/COEFF.H" ] && [ ! -f "$DIR/coeff.h" ] && ln -sf "$PWD/$DIR/COEFF.H" "$INC/coeff.h"
+
+	FILES=""
+	for S in $SRCS; do
+		FILES="$FILES $DIR/$S"
+	done
+	if ! $CC $CFLAGS $HOSTFLAGS -I "$DIR" -I "$INC" -x c $FILES -x none $SUPPORT \
+		-lm -lpthread -o "$BENCH_DIR/$NAME" 2> "$BENCH_DIR/$NAME.log"; then
+		echo "$NAME: build failed, see $BENCH_DIR/$NAME.log" >&2
+		continue
+	fi
+	RESULT=$("$BENCH_DIR/$NAME" "$SAMPLES" "$SEED" "$NAME" 2> /dev/null) || {
+		echo "$NAME: run failed" >&2
+		continue
+	}
+	printf '%s  %s' "$SEP" "$RESULT"
+	SEP=",
+"
+done
+echo
+echo "]"
@@ -0,0 +1,343 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: biquadbank.c
+//
+// Synopsis: Checks that every channel of a BiquadBank is bit-exact with
+//           a Biquad of the same sections, for each channel count up
+//           to -c, and optionally times the bank against separate
+//           Biquads.
+//
+//           usage: biquadbank [-c channels] [-n frames] [-s seed] [-t]
+//                             [file.c ...]
+//
+//           -c  most channels; 1, 2, ... this many are checked
+//               (default 37)
+//           -n  frames of seeded noise per channel count (default 4800)
+//           -s  seed of the sections and the noise (default 1)
+//           -t  also time the bank against separate Biquads at 1-32
+//               channels, a frame per call and in 64-frame blocks
+//
+//           With no file the shared sections are random, as rows of 5
+//           and of 6; a file's first array of SOS rows (declared [5]
+//           or [6] wide, see Parallel/parallel.c) is used instead.
+//           Each of DF1, DF2 and DF2T is checked.  Every third channel
+//           is given its own random sections with BiquadBank_SetChannel,
+//           the bank is called with random numbers of frames (1 to 64)
+//           and every other call is in place, while each Biquad
+//           filters its whole channel in one call.  Each comparison is
+//           printed as by Golden_Report.  The exit status is 1 if any
+//           channel differs or a file cannot be read.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "Golden.h"
+#include "Biquad.h"
+#include "BiquadBank.h"
+#include "CoeffFile.h"
+
+#define BANK_SECTIONS		4		// random sections in a cascade
+#define BANK_MAX_VALUES		1024	// coefficients read from a file
+#define BANK_BLOCK			64		// most frames per BiquadBank_Run
+#define BANK_TIME_FRAMES	4096	// frames of the buffer -t filters over and over
+
+static const char *Forms[] = {"DF1", "DF2", "DF2T"};
+
+static Uint32 Random(Uint32 *seed)
+{
+	*seed = *seed * 1664525 + 1013904223;
+	return *seed >> 8;
+}
+
+static void RandomSections(float *sos, Uint32 sections, Uint32 width, Uint32 *seed)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Makes a stable cascade of random sections
+//
+// Input:     sos - receives sections rows of width coefficients
+//            sections - number of rows
+//            width - 5 or 6, see Biquad_Init
+//            seed - updated
+//
+// Returns:   Nothing
+//
+// Calls:     Random
+//
+// Notes:     Each row has a pole pair of radius 0.5 to 0.99 and a zero
+//            pair on the unit circle.  A 6-wide row is scaled by a
+//            random a0 of 0.5 to 2, so the division by it is tested.
+///////////////////////////////////////////////////////////////////////
+{
+	double r, pole, zero, a0, row[6];
+	Uint32 k, j;
+
+	for(k = 0; k < sections; k++, sos += width) {
+		r = 0.5 + 0.49 * Random(seed) / 16777216.0;
+		pole = 3.14159265358979 * Random(seed) / 16777216.0;
+		zero = 3.14159265358979 * Random(seed) / 16777216.0;
+		a0 = width == 6 ? 0.5 + 1.5 * Random(seed) / 16777216.0 : 1;
+		row[0] = 0.25;
+		row[1] = -0.5 * cos(zero);
+		row[2] = 0.25;
+		row[3] = 1;
+		row[4] = -2 * r * cos(pole);
+		row[5] = r * r;
+		if(width == 5) {
+			row[3] = -row[4];
+			row[4] = -row[5];
+		}
+		for(j = 0; j < width; j++)
+			sos[j] = (float)(width == 6 ? a0 * row[j] : row[j]);
+	}
+}
+
+static Int32 Check(const char *name, const float *sos, Uint32 sections, Uint32 width,
+	Int32 form, Uint32 channels, Uint32 frames, Uint32 seed)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Compares a bank with per-channel Biquads at 1..channels
+//            channels
+//
+// Input:     name - of the sections, for the report
+//            sos - shared sections rows of width coefficients
+//            sections - number of rows
+//            width - 5 or 6
+//            form - BIQUAD_DF1, BIQUAD_DF2 or BIQUAD_DF2T
+//            channels - most channels
+//            frames - frames of noise per channel count
+//            seed - of the own sections, the noise and the calls
+//
+// Returns:   1 if every channel was bit-exact, 0 if not
+//
+// Calls:     BiquadBank_Init, BiquadBank_SetChannel, BiquadBank_Run,
+//            Biquad_Init, Biquad_Run, RandomSections, Golden_Report
+//
+// Notes:     The gain is 0.75 for DF2T, 1 otherwise, so both paths of
+//            the gain are covered
+///////////////////////////////////////////////////////////////////////
+{
+	float *x, *y, *ref, *out, *own, gain = form == BIQUAD_DF2T ? 0.75F : 1;
+	char label[128];
+	BiquadBank bank;
+	Biquad *single;
+	Golden check;
+	Uint32 ch, c, i, n, call = 0;
+	Int32 ok = 1;
+
+	x = malloc(channels * frames * sizeof(float));
+	y = malloc(channels * frames * sizeof(float));
+	ref = malloc(frames * sizeof(float));
+	out = malloc(frames * sizeof(float));
+	own = malloc(channels * sections * width * sizeof(float));
+	single = malloc(channels * sizeof(Biquad));
+	if(!x || !y || !ref || !out || !own || !single) {
+		fprintf(stderr, "biquadbank: out of memory\n");
+		exit(2);
+	}
+	sprintf(label, "%s, %u-wide rows, %s, 1-%u channels", name, width, Forms[form],
+		channels);
+	Golden_Init(&check, label, GOLDEN_EXACT, 0);
+
+	for(ch = 1; ch <= channels; ch++) {
+		if(!BiquadBank_Init(&bank, sos, sections, width, ch, BANK_BLOCK, form, gain)) {
+			fprintf(stderr, "biquadbank: cannot set up %u channels\n", ch);
+			exit(2);
+		}
+		for(c = 0; c < ch; c++) {
+			if(c % 3 == 2) {
+				RandomSections(own + c * sections * width, sections, width, &seed);
+				BiquadBank_SetChannel(&bank, c, own + c * sections * width, width);
+				Biquad_Init(&single[c], own + c * sections * width, sections, width,
+					form, gain);
+			}
+			else
+				Biquad_Init(&single[c], sos, sections, width, form, gain);
+		}
+		for(i = 0; i < ch * frames; i++)
+			x[i] = (float)(Random(&seed) / 8388608.0 - 1);
+
+		for(i = 0; i < frames; i += n, call++) {
+			n = 1 + Random(&seed) % BANK_BLOCK;
+			if(n > frames - i)
+				n = frames - i;
+			if(call & 1) {
+				memcpy(y + i * ch, x + i * ch, n * ch * sizeof(float));
+				BiquadBank_Run(&bank, y + i * ch, y + i * ch, n);
+			}
+			else
+				BiquadBank_Run(&bank, x + i * ch, y + i * ch, n);
+		}
+
+		for(c = 0; c < ch; c++) {
+			for(i = 0; i < frames; i++) {
+				ref[i] = x[i * ch + c];
+				out[i] = y[i * ch + c];
+			}
+			Biquad_Run(&single[c], ref, ref, frames);
+			Golden_CompareFloat(&check, ref, out, frames);
+			Biquad_Close(&single[c]);
+		}
+		if(!Golden_Passed(&check) && ok) {
+			printf("%s: first differs at %u channels\n", label, ch);
+			ok = 0;
+		}
+		BiquadBank_Close(&bank);
+	}
+
+	free(x);
+	free(y);
+	free(ref);
+	free(out);
+	free(own);
+	free(single);
+	return Golden_Report(&check);
+}
+
+static double Seconds(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static void Time(const float *sos, Uint32 sections, Uint32 width, Uint32 frames)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Prints the time per frame of a DF2 bank and of separate
+//            DF2 Biquads at 1-32 channels
+//
+// Input:     sos - shared sections rows of width coefficients
+//            sections - number of rows
+//            width - 5 or 6
+//            frames - frames per channel count, a multiple of
+//                     BANK_TIME_FRAMES
+//
+// Returns:   Nothing
+//
+// Calls:     BiquadBank_Run, Biquad_Run, Seconds
+//
+// Notes:     The Biquads are given each frame as an ISR would, one
+//            sample per channel, or in blocks copied out of and back
+//            into the interleaved frames, as a frame program would.
+//            The noise is not filtered in place, so that it is not
+//            filtered down to denormals pass after pass.
+///////////////////////////////////////////////////////////////////////
+{
+	static const Uint32 Counts[] = {1, 2, 4, 8, 16, 32}, Blocks[] = {1, BANK_BLOCK};
+	float *x, *y, *ch_buf;
+	BiquadBank bank;
+	Biquad single[32];
+	double t0, bank_ns, single_ns;
+	Uint32 k, b, c, i, j, r, ch, block;
+
+	x = malloc(32 * BANK_TIME_FRAMES * sizeof(float));
+	y = malloc(32 * BANK_TIME_FRAMES * sizeof(float));
+	ch_buf = malloc(BANK_BLOCK * sizeof(float));
+	for(i = 0; i < 32 * BANK_TIME_FRAMES; i++)
+		x[i] = (float)(i % 97) / 97 - 0.5F;
+
+	printf("channels  frames/call  bank ns/frame  Biquads ns/frame  speed-up\n");
+	for(k = 0; k < sizeof(Counts) / sizeof(Counts[0]); k++)
+		for(b = 0; b < 2; b++) {
+			ch = Counts[k];
+			block = Blocks[b];
+			BiquadBank_Init(&bank, sos, sections, width, ch, block, BIQUAD_DF2, 1);
+			for(c = 0; c < ch; c++)
+				Biquad_Init(&single[c], sos, sections, width, BIQUAD_DF2, 1);
+
+			t0 = Seconds();
+			for(r = 0; r < frames; r += BANK_TIME_FRAMES)
+				for(i = 0; i < BANK_TIME_FRAMES; i += block)
+					BiquadBank_Run(&bank, x + i * ch, y + i * ch, block);
+			bank_ns = (Seconds() - t0) * 1e9 / frames;
+
+			t0 = Seconds();
+			for(r = 0; r < frames; r += BANK_TIME_FRAMES)
+				for(i = 0; i < BANK_TIME_FRAMES; i += block)
+					for(c = 0; c < ch; c++) {
+						if(block == 1) {
+							Biquad_Run(&single[c], x + i * ch + c, y + i * ch + c, 1);
+							continue;
+						}
+						for(j = 0; j < block; j++)
+							ch_buf[j] = x[(i + j) * ch + c];
+						Biquad_Run(&single[c], ch_buf, ch_buf, block);
+						for(j = 0; j < block; j++)
+							y[(i + j) * ch + c] = ch_buf[j];
+					}
+			single_ns = (Seconds() - t0) * 1e9 / frames;
+
+			printf("%8u  %11u  %13.1f  %16.1f  %7.2fx\n", ch, block, bank_ns,
+				single_ns, single_ns / bank_ns);
+			for(c = 0; c < ch; c++)
+				Biquad_Close(&single[c]);
+			BiquadBank_Close(&bank);
+		}
+	free(x);
+	free(y);
+	free(ch_buf);
+}
+
+int main(int argc, char *argv[])
+{
+	static float sos[BANK_MAX_VALUES];
+	Uint32 channels = 37, frames = 4800, seed = 1, timing = 0, failed = 0;
+	Uint32 width, n;
+	Int32 form;
+	char *text, *pos;
+	int opt, i;
+
+	while((opt = getopt(argc, argv, "c:n:s:t")) != -1) {
+		switch(opt) {
+		case 'c':	channels = atoi(optarg);	break;
+		case 'n':	frames = atoi(optarg);		break;
+		case 's':	seed = atoi(optarg);		break;
+		case 't':	timing = 1;					break;
+		default:	argc = 0;					break;
+		}
+	}
+	if(argc < optind || channels == 0 || frames == 0) {
+		fprintf(stderr, "usage: %s [-c channels] [-n frames] [-s seed] [-t] [file.c ...]\n",
+			argv[0]);
+		return 2;
+	}
+
+	if(optind == argc) {
+		for(width = 5; width <= 6; width++) {
+			RandomSections(sos, BANK_SECTIONS, width, &seed);
+			for(form = BIQUAD_DF1; form <= BIQUAD_DF2T; form++)
+				if(!Check("random", sos, BANK_SECTIONS, width, form, channels, frames, seed))
+					failed++;
+		}
+		if(timing)
+			Time(sos, BANK_SECTIONS, 6, 75 * BANK_TIME_FRAMES);
+	}
+
+	for(i = optind; i < argc; i++) {
+		text = CoeffFile_Read(argv[i]);
+		if(text == NULL) {
+			fprintf(stderr, "biquadbank: cannot read %s\n", argv[i]);
+			failed++;
+			continue;
+		}
+		pos = text;
+		n = CoeffFile_NextArray(&pos, sos, BANK_MAX_VALUES, &width);
+		free(text);
+		if(n == 0 || (width != 5 && width != 6)) {
+			fprintf(stderr, "biquadbank: no SOS rows in %s\n", argv[i]);
+			failed++;
+			continue;
+		}
+		for(form = BIQUAD_DF1; form <= BIQUAD_DF2T; form++)
+			if(!Check(argv[i], sos, n / width, width, form, channels, frames, seed))
+				failed++;
+		if(timing)
+			Time(sos, n / width, width, 75 * BANK_TIME_FRAMES);
+	}
+	return failed != 0;
+}
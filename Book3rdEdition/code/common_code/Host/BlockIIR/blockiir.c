@@ -0,0 +1,130 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: blockiir.c
+//
+// Synopsis: Sets up the block state-space form of BlockIIR.c for the
+//           IIR filters of coefficient files and checks each against
+//           its recursion run in double, before a program is changed
+//           to filter with it.
+//
+//           usage: blockiir [-m snr:dB] [-n samples] [-b block] file.c ...
+//
+//           -m  tolerance, as for Golden/golden.c (default snr:90)
+//           -n  samples of seeded noise to compare (default 480000)
+//           -b  samples per block (default 64)
+//
+//           Files are read as by Parallel/parallel.c: SOS rows if the
+//           first array is declared [5] or [6] wide (sos_dump2c.m,
+//           SOS2C.m), otherwise it and the next are the numerator and
+//           denominator (IIR_dump2C.m).  The comparison is printed as
+//           by Golden_Report.  The exit status is 1 if any file cannot
+//           be set up or fails the comparison.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "BlockIIR.h"
+#include "CoeffFile.h"
+
+#define BLOCKIIR_MAX_VALUES	1024
+
+static Int32 Check(const char *name, const char *mode, Uint32 samples, Uint32 block)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up and checks the block filter of one file
+//
+// Input:     name - coefficient file
+//            mode - tolerance, as for Golden_ParseMode
+//            samples - length of the comparison
+//            block - samples per block
+//
+// Returns:   1 if the block filter passed, 0 if not
+//
+// Calls:     CoeffFile_Read, CoeffFile_NextArray, BlockIIR_InitSOS,
+//            BlockIIR_InitTF, BlockIIR_Check, Golden_Report
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	static float b[BLOCKIIR_MAX_VALUES], a[BLOCKIIR_MAX_VALUES];
+	Uint32 nb, na, width;
+	BlockIIR f;
+	Golden check;
+	char *text, *pos;
+	Int32 ok;
+
+	text = CoeffFile_Read(name);
+	if(text == NULL) {
+		fprintf(stderr, "blockiir: cannot read %s\n", name);
+		return 0;
+	}
+	pos = text;
+	nb = CoeffFile_NextArray(&pos, b, BLOCKIIR_MAX_VALUES, &width);
+	if(nb == 0) {
+		fprintf(stderr, "blockiir: no coefficients in %s\n", name);
+		free(text);
+		return 0;
+	}
+	if(width > 1) {
+		printf("%s: %u sections of %u", name, nb / width, width);
+		ok = BlockIIR_InitSOS(&f, b, nb / width, width, 1, block);
+	}
+	else {
+		na = CoeffFile_NextArray(&pos, a, BLOCKIIR_MAX_VALUES, &width);
+		if(na != nb || nb < 2) {
+			fprintf(stderr, "blockiir: %s has %u numerator and %u denominator values\n",
+				name, nb, na);
+			free(text);
+			return 0;
+		}
+		printf("%s: transfer function of %u coefficients", name, nb);
+		ok = BlockIIR_InitTF(&f, b, a, nb - 1, block);
+	}
+	free(text);
+	if(!ok) {
+		printf("\n%s: FAIL, no memory for blocks of %u\n", name, block);
+		return 0;
+	}
+	printf(", blocks of %u\n", f.block);
+
+	Golden_Init(&check, (char *)name, GOLDEN_SNR, 90);
+	Golden_ParseMode(&check, mode);
+	BlockIIR_Check(&f, &check, samples, 1);
+	ok = Golden_Report(&check);
+	BlockIIR_Close(&f);
+	return ok;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *mode = "snr:90";
+	Uint32 samples = 480000, block = 64, failed = 0;
+	Golden check;
+	int opt, i;
+
+	while((opt = getopt(argc, argv, "m:n:b:")) != -1) {
+		switch(opt) {
+		case 'm':	mode = optarg;			break;
+		case 'n':	samples = atoi(optarg);	break;
+		case 'b':	block = atoi(optarg);	break;
+		default:	argc = 0;				break;
+		}
+	}
+	if(argc - optind < 1 || block == 0) {
+		fprintf(stderr, "usage: %s [-m snr:dB] [-n samples] [-b block] file.c ...\n",
+			argv[0]);
+		return 2;
+	}
+	if(!Golden_ParseMode(&check, mode)) {
+		fprintf(stderr, "blockiir: unknown mode %s\n", mode);
+		return 2;
+	}
+
+	for(i = optind; i < argc; i++)
+		if(!Check(argv[i], mode, samples, block))
+			failed++;
+	return failed != 0;
+}
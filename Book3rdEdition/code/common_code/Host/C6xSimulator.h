@@ -0,0 +1,18 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: C6xSimulator.h
+//
+// Synopsis: Host stand-in for TI's C6xSimulator.h, which DSPLIB
+//           headers (DSPF_sp_biquad.h) include when the compiler is not
+//           TI's.  The intrinsics they expect are those of c6x.h.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	C6XSIMULATOR_H_INCLUDED
+#define C6XSIMULATOR_H_INCLUDED
+
+#include "c6x.h"
+
+#endif
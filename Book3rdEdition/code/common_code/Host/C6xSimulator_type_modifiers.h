@@ -0,0 +1,20 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: C6xSimulator_type_modifiers.h
+//
+// Synopsis: Host stand-in for TI's C6xSimulator_type_modifiers.h,
+//           included by DSPLIB headers off the board.  The headers use
+//           restrict, which C99 has and C++ spells __restrict.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	C6XSIMULATOR_TYPE_MODIFIERS_H_INCLUDED
+#define C6XSIMULATOR_TYPE_MODIFIERS_H_INCLUDED
+
+#ifdef __cplusplus
+#define restrict	__restrict
+#endif
+
+#endif
@@ -0,0 +1,115 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: CoeffFile.c
+//
+// Synopsis: Arrays of MATLAB-exported coefficient files, see
+//           CoeffFile.h
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "CoeffFile.h"
+
+char *CoeffFile_Read(const char *name)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Reads a source file, comments blanked out
+//
+// Input:     name - file name
+//
+// Returns:   The text (to be freed), NULL if it cannot be read
+//
+// Calls:     fopen, fread, malloc
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	FILE *file = fopen(name, "rb");
+	char *text, *p, *end;
+	long size;
+
+	if(file == NULL)
+		return NULL;
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	text = malloc(size + 1);
+	if(text == NULL || fread(text, 1, size, file) != (size_t)size) {
+		fclose(file);
+		free(text);
+		return NULL;
+	}
+	fclose(file);
+	text[size] = 0;
+
+	for(p = text; *p; p++)
+		if(p[0] == '/' && p[1] == '*') {
+			end = strstr(p + 2, "*/");
+			end = end ? end + 2 : p + strlen(p);
+			memset(p, ' ', end - p);
+		}
+		else if(p[0] == '/' && p[1] == '/')
+			while(*p && *p != '\n')
+				*p++ = ' ';
+	return text;
+}
+
+Uint32 CoeffFile_NextArray(char **pos, float *v, Uint32 max, Uint32 *width)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Reads the next initialized array of a source file
+//
+// Input:     pos - where to look, moved past the array
+//            v - receives the values
+//            max - most values kept, the rest are skipped
+//            width - receives 5 or 6 if the array is declared [5] or
+//                    [6] in its last dimension, otherwise 1
+//
+// Returns:   Number of values kept, 0 if there are no more arrays
+//
+// Calls:     strtod
+//
+// Notes:     Inner braces, as in {{0.1}, {0.2}}, are skipped
+///////////////////////////////////////////////////////////////////////
+{
+	char *p, *decl = *pos, *end;
+	Uint32 n = 0, depth = 0;
+
+	p = strchr(*pos, '=');
+	while(p != NULL && p[1] == '=')
+		p = strchr(p + 2, '=');
+	if(p == NULL)
+		return 0;
+	*p = 0;
+	decl = strrchr(decl, ';') ? strrchr(decl, ';') : decl;
+	*width = strstr(decl, "[5]") ? 5 : strstr(decl, "[6]") ? 6 : 1;
+	for(p++; *p && isspace((unsigned char)*p); p++)
+		;
+	if(*p != '{') {
+		*pos = p;
+		return CoeffFile_NextArray(pos, v, max, width);
+	}
+
+	do {
+		if(*p == '{')
+			depth++;
+		else if(*p == '}')
+			depth--;
+		else if(isdigit((unsigned char)*p) || *p == '-' || *p == '+' || *p == '.') {
+			if(n < max)
+				v[n++] = (float)strtod(p, &end);
+			else
+				strtod(p, &end);
+			if(end > p) {
+				p = end;
+				continue;
+			}
+		}
+		p++;
+	} while(*p && depth > 0);
+	*pos = p;
+	return n;
+}
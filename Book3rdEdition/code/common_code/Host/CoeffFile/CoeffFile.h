@@ -0,0 +1,29 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: CoeffFile.h
+//
+// Synopsis: Reads the arrays of the coefficient files that the MATLAB
+//           export scripts write (fir_dump2c.m, sos_dump2c.m, SOS2C.m,
+//           IIR_dump2C.m), for the host tools that check a filter
+//           without building its program:
+//
+//           text = CoeffFile_Read("coeff.c");
+//           pos = text;
+//           while((n = CoeffFile_NextArray(&pos, v, max, &width)) != 0)
+//               ...                 // n values, rows of width if > 1
+//           free(text);
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	COEFFFILE_H_INCLUDED
+#define COEFFFILE_H_INCLUDED
+
+#include "tistdtypes.h"
+
+// defined in CoeffFile.c
+char  *CoeffFile_Read(const char *);
+Uint32 CoeffFile_NextArray(char **, float *, Uint32, Uint32 *);
+
+#endif
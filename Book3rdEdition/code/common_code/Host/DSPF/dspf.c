@@ -0,0 +1,61 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: dspf.c
+//
+// Synopsis: Conformance check of the host DSPF_sp_biquad against TI's
+//           natural C version, run before a frame program is trusted
+//           off the board or a new SIMD path is added.
+//
+//           usage: dspf [-m snr:dB] [-n samples] [-s seed]
+//
+//           -m  tolerance, as for Golden/golden.c (default snr:90;
+//               exact passes only a -DDSPF_BIQUAD_NO_SIMD build)
+//           -n  samples of seeded noise, shared by the random
+//               sections (default 480000)
+//           -s  seed of the sections and the noise (default 1)
+//
+//           The comparison is printed as by Golden_Report.  The exit
+//           status is 1 if it fails.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "Golden.h"
+#include "DSPF_sp_biquad.h"
+
+// defined in DSPF_sp_biquad.c, kept out of its header so that it can
+// stand in for TI's
+Int32 DSPF_sp_biquad_Check(Golden *, Uint32, Uint32);
+
+int main(int argc, char *argv[])
+{
+	const char *mode = "snr:90";
+	Uint32 samples = 480000, seed = 1;
+	Golden check;
+	int opt;
+
+	while((opt = getopt(argc, argv, "m:n:s:")) != -1) {
+		switch(opt) {
+		case 'm':	mode = optarg;			break;
+		case 'n':	samples = atoi(optarg);	break;
+		case 's':	seed = atoi(optarg);	break;
+		default:	argc = 0;				break;
+		}
+	}
+	if(argc != optind) {
+		fprintf(stderr, "usage: %s [-m snr:dB] [-n samples] [-s seed]\n", argv[0]);
+		return 2;
+	}
+	Golden_Init(&check, "DSPF_sp_biquad", GOLDEN_SNR, 90);
+	if(!Golden_ParseMode(&check, mode)) {
+		fprintf(stderr, "dspf: unknown mode %s\n", mode);
+		return 2;
+	}
+
+	DSPF_sp_biquad_Check(&check, samples, seed);
+	return !Golden_Report(&check);
+}
@@ -0,0 +1,204 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: golden.c
+//
+// Synopsis: Golden-output regression check of a whole program.  A
+//           reference build and a candidate build (optimized kernel,
+//           fixed point, ...) are run on the same inputs and their
+//           outputs compared, channel by channel, with Golden.c.
+//
+//           usage: golden [-m mode] [-d delay] [-c channel] [-k]
+//                         reference candidate input ...
+//
+//           -m  exact (default), ulp:N (N LSBs) or snr:dB
+//           -d  candidate output lags the reference by delay samples
+//           -c  compare only the left or right channel
+//           -k  keep the output files (their directory is printed)
+//
+//           The programs are run as "program in.wav out.wav" with
+//           HOST_CODEC_IN/HOST_CODEC_OUT set as well, like Batch/batch.c.
+//           Inputs may be "noise:samples[:seed]".  The exit status is
+//           1 if any channel of any input fails.
+//
+///////////////////////////////////////////////////////////////////////
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "Host_Codec.h"
+#include "Golden.h"
+
+// HostCodec_Open, unused here, refers to the program's sample rate
+float GetSampleFreq()
+{
+	return 48000.0F;
+}
+
+static char *Run(const char *program, const char *in, const char *dir)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Runs a program on one input
+//
+// Input:     program - host-built example program
+//            in - input file
+//            dir - directory for the output
+//
+// Returns:   Output file name (to be freed), NULL if the program failed
+//
+// Calls:     fork, execl, waitpid
+//
+// Notes:     The program's console output goes to stderr
+///////////////////////////////////////////////////////////////////////
+{
+	const char *base = strrchr(in, '/') ? strrchr(in, '/') + 1 : in;
+	char *out;
+	int status;
+	pid_t pid;
+
+	if(asprintf(&out, "%s/%s%s", dir, base, strchr(base, '.') ? "" : ".wav") < 0)
+		return NULL;
+	pid = fork();
+	if(pid == 0) {
+		setenv("HOST_CODEC_IN", in, 1);
+		setenv("HOST_CODEC_OUT", out, 1);
+		setenv("HOST_EDMA_SPEED", "0", 0);
+		dup2(2, 1);
+		execl(program, program, in, out, (char *)NULL);
+		fprintf(stderr, "golden: cannot run %s: %s\n", program, strerror(errno));
+		_exit(127);
+	}
+	if(pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status)) {
+		fprintf(stderr, "golden: %s failed on %s\n", program, in);
+		free(out);
+		return NULL;
+	}
+	return out;
+}
+
+static Int32 Compare(const char *in, const char *ref_name, const char *cand_name,
+	const char *mode, Uint32 delay, Uint32 channels)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Compares the outputs of the two programs for one input
+//
+// Input:     in - input file, for the report
+//            ref_name, cand_name - output files
+//            mode - comparison mode, as for Golden_ParseMode
+//            delay - candidate samples to skip
+//            channels - bit 0 for left, bit 1 for right
+//
+// Returns:   1 if both channels pass, 0 if not
+//
+// Calls:     HostStream_OpenRead, HostStream_Read, Golden_CompareInt16,
+//            Golden_Report
+//
+// Notes:     The comparison stops at the end of the shorter output
+///////////////////////////////////////////////////////////////////////
+{
+	static HostStream ref, cand;
+	static Uint32 ref_buf[4096], cand_buf[4096];
+	Golden g[2];
+	char *label[2];
+	Uint32 n, m, c;
+	Int32 passed = 1;
+
+	if(!HostStream_OpenRead(&ref, ref_name))
+		return 0;
+	if(!HostStream_OpenRead(&cand, cand_name)) {
+		HostStream_Close(&ref);
+		return 0;
+	}
+	for(c = 0; c < 2; c++) {
+		if(asprintf(&label[c], "%s %s", in, c ? "right" : "left") < 0)
+			label[c] = (char *)in;
+		Golden_Init(&g[c], label[c], GOLDEN_EXACT, 0);
+		Golden_ParseMode(&g[c], mode);
+	}
+
+	// line the candidate up with the reference
+	while(delay > 0 && (n = HostStream_Read(&cand, cand_buf, delay < 4096 ? delay : 4096)) > 0)
+		delay -= n;
+	while((n = HostStream_Read(&ref, ref_buf, 4096)) > 0) {
+		if((m = HostStream_Read(&cand, cand_buf, n)) < n)
+			n = m;
+		// codec words hold the left channel in the low half
+		for(c = 0; c < 2; c++)
+			if(channels & (1 << c))
+				Golden_CompareInt16(&g[c], (Int16 *)ref_buf + c, (Int16 *)cand_buf + c, n, 2);
+	}
+	HostStream_Close(&ref);
+	HostStream_Close(&cand);
+
+	for(c = 0; c < 2; c++) {
+		if(channels & (1 << c))
+			passed &= Golden_Report(&g[c]);
+		if(label[c] != in)
+			free(label[c]);
+	}
+	return passed;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *mode = "exact";
+	char dir[] = "/tmp/goldenXXXXXX", *sub[2], *out[2];
+	Uint32 delay = 0, failed = 0, keep = 0, channels = 3, i;
+	Golden check;
+	int opt;
+
+	while((opt = getopt(argc, argv, "m:d:c:k")) != -1) {
+		switch(opt) {
+		case 'm':	mode = optarg;			break;
+		case 'd':	delay = atoi(optarg);	break;
+		case 'c':	channels = !strcmp(optarg, "left") ? 1 : !strcmp(optarg, "right") ? 2 : 0;
+					break;
+		case 'k':	keep = 1;				break;
+		default:	argc = 0;				break;
+		}
+	}
+	if(argc - optind < 3 || channels == 0) {
+		fprintf(stderr, "usage: %s [-m exact|ulp:N|snr:dB] [-d delay] [-c left|right] [-k] "
+			"reference candidate input ...\n",
+			argv[0]);
+		return 2;
+	}
+	if(!Golden_ParseMode(&check, mode)) {
+		fprintf(stderr, "golden: unknown mode %s\n", mode);
+		return 2;
+	}
+	if(mkdtemp(dir) == NULL || asprintf(&sub[0], "%s/ref", dir) < 0 ||
+		asprintf(&sub[1], "%s/cand", dir) < 0 || mkdir(sub[0], 0777) || mkdir(sub[1], 0777)) {
+		fprintf(stderr, "golden: cannot create %s\n", dir);
+		return 1;
+	}
+
+	for(i = optind + 2; i < (Uint32)argc; i++) {
+		out[0] = Run(argv[optind], argv[i], sub[0]);
+		out[1] = out[0] ? Run(argv[optind + 1], argv[i], sub[1]) : NULL;
+		if(out[1] == NULL || !Compare(argv[i], out[0], out[1], mode, delay, channels))
+			failed++;
+		if(!keep) {
+			if(out[0])
+				remove(out[0]);
+			if(out[1])
+				remove(out[1]);
+		}
+		free(out[0]);
+		free(out[1]);
+	}
+
+	if(keep)
+		printf("outputs kept in %s\n", dir);
+	else {
+		rmdir(sub[0]);
+		rmdir(sub[1]);
+		rmdir(dir);
+	}
+	printf("%u inputs, %u failed\n", argc - optind - 2, failed);
+	return failed != 0;
+}
@@ -0,0 +1,580 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Host_Codec.c
+//
+// Synopsis: File-backed codec for the host build.  Input samples come
+//           from a 16-bit PCM WAV or a raw interleaved L/R Int16 file,
+//           or from a seeded noise generator ("noise:samples[:seed]"),
+//           output samples go to a stereo WAV or raw file.  Samples
+//           move as the same packed 32-bit words the McASP delivers,
+//           left channel in the low half.  Stereo input files are
+//           memory mapped, so samples are read straight from the page
+//           cache, and read ahead and released a window at a time, so
+//           a file may be larger than RAM.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Host_Codec.h"
+
+#define HOST_BLOCK		(sizeof(((HostStream *)0)->buf) / sizeof(Uint32))
+#define HOST_MAP_WINDOW	(4 << 20)	// bytes read ahead of, and kept behind, the read position
+
+static HostStream CodecIn, CodecOut;
+static Uint32 SampleCount = 0;
+static Uint8 OutOpen = 0;
+
+static Uint32 GetLE32(const Uint8 *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
+static void PutLE32(Uint8 *p, Uint32 v)
+{
+	p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static Uint8 IsRawName(const char *name)
+{
+	const char *ext = strrchr(name, '.');
+
+	return ext && (!strcmp(ext, ".raw") || !strcmp(ext, ".pcm"));
+}
+
+static Uint32 NoiseWord(HostStream *s)
+{
+	Int16 left, right;
+
+	s->seed = s->seed * 1664525 + 1013904223;		// Numerical Recipes LCG
+	left = (Int16)(s->seed >> 16) >> 2;				// -12 dBFS peak
+	s->seed = s->seed * 1664525 + 1013904223;
+	right = (Int16)(s->seed >> 16) >> 2;
+	return (Uint16)left | ((Uint32)(Uint16)right << 16);
+}
+
+static void Advise(HostStream *s)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Keeps the page cache a window ahead of a mapped stream
+//
+// Input:     s - mapped input stream
+//
+// Returns:   Nothing
+//
+// Calls:     madvise
+//
+// Notes:     Pages more than a window behind the read position are
+//            released, so only a few windows of the file are resident
+//            however long it is.  Pages returned by the last
+//            HostStream_Map are never released.
+///////////////////////////////////////////////////////////////////////
+{
+	size_t pos = (Uint8 *)s->next - (Uint8 *)s->map, end;
+
+	// start reading the next window from disk while this one is processed
+	while(s->ahead < s->map_size && s->ahead < pos + HOST_MAP_WINDOW) {
+		end = s->ahead + HOST_MAP_WINDOW < s->map_size ? s->ahead + HOST_MAP_WINDOW : s->map_size;
+		madvise((Uint8 *)s->map + s->ahead, end - s->ahead, MADV_WILLNEED);
+		s->ahead = end;
+	}
+	if(pos >= s->behind + 2 * HOST_MAP_WINDOW) {
+		end = (pos - HOST_MAP_WINDOW) & ~(size_t)(HOST_MAP_WINDOW - 1);
+		madvise((Uint8 *)s->map + s->behind, end - s->behind, MADV_DONTNEED);
+		s->behind = end;
+	}
+}
+
+static void MapInput(HostStream *s, long offset)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Maps a stereo input file in place of stdio reads
+//
+// Input:     s - input stream, opened with its FILE
+//            offset - byte offset of the first sample
+//
+// Returns:   Nothing, s->map stays NULL if the file cannot be mapped
+//
+// Calls:     mmap, madvise
+//
+// Notes:     The mapping is private and writable, so a kernel may
+//            process the mapped samples in place without changing the
+//            file.  Mono files (expanded to L/R words), unaligned data,
+//            pipes and HOST_CODEC_MMAP=0 use stdio.
+///////////////////////////////////////////////////////////////////////
+{
+	const char *env = getenv("HOST_CODEC_MMAP");
+	FILE *f = (FILE *)s->file;
+	struct stat st;
+	void *p;
+
+	if((env && !atoi(env)) || s->channels != 2 || (offset & 3) ||
+		fstat(fileno(f), &st) || !S_ISREG(st.st_mode) || st.st_size <= offset ||
+		(off_t)(size_t)st.st_size != st.st_size)
+		return;
+	p = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_NORESERVE, fileno(f), 0);
+	if(p == MAP_FAILED)
+		return;
+	s->map = p;
+	s->map_size = st.st_size;
+	s->next = (Uint32 *)((Uint8 *)p + offset);
+	if(s->frames > (st.st_size - offset) / 4)
+		s->frames = (st.st_size - offset) / 4;		// truncated file
+	madvise(p, s->map_size, MADV_SEQUENTIAL);
+	Advise(s);
+}
+
+Int32 HostStream_OpenRead(HostStream *s, const char *name)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Opens a WAV or raw file as a codec input stream
+//
+// Input:     s - stream to initialize
+//            name - file name, .raw/.pcm selects raw stereo Int16,
+//                   "noise:samples[:seed]" selects white noise
+//
+// Returns:   1 on success, 0 if the file is missing or unsupported
+//
+// Calls:     Nothing
+//
+// Notes:     WAV input must be 16-bit PCM, mono or stereo.  Mono input
+//            is copied to both codec channels.  Noise is uniform on
+//            each channel at up to -12 dBFS; a seed gives the same
+//            samples on every run (default 1).  Stereo files are
+//            memory mapped where possible.
+///////////////////////////////////////////////////////////////////////
+{
+	FILE *f;
+	Uint8 hdr[16];
+	Uint32 size;
+	char *end;
+
+	memset(s, 0, sizeof(HostStream) - sizeof(s->buf));
+	if(!strncmp(name, "noise:", 6)) {
+		s->format = HOST_FORMAT_NOISE;
+		s->channels = 2;
+		s->frames = strtoul(name + 6, &end, 0);
+		s->seed = (*end == ':') ? strtoul(end + 1, NULL, 0) : 1;
+		s->file = s;						// open, with no FILE behind it
+		return 1;
+	}
+	if((f = fopen(name, "rb")) == NULL)
+		return 0;
+	s->file = f;
+	s->channels = 2;
+
+	if(IsRawName(name)) {
+		s->format = HOST_FORMAT_RAW;
+		fseek(f, 0, SEEK_END);
+		s->frames = ftell(f) / 4;
+		fseek(f, 0, SEEK_SET);
+		MapInput(s, 0);
+		return 1;
+	}
+
+	s->format = HOST_FORMAT_WAV;
+	if(fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4) || memcmp(hdr + 8, "WAVE", 4))
+		goto bad;
+	while(fread(hdr, 1, 8, f) == 8) {		// walk the chunk list
+		size = GetLE32(hdr + 4);
+		if(!memcmp(hdr, "fmt ", 4)) {
+			if(size < 16 || fread(hdr, 1, 16, f) != 16)
+				goto bad;
+			if((hdr[0] | (hdr[1] << 8)) != 1 || (hdr[14] | (hdr[15] << 8)) != 16)
+				goto bad;					// PCM, 16 bits only
+			s->channels = hdr[2];
+			s->rate = GetLE32(hdr + 4);
+			if(s->channels < 1 || s->channels > 2)
+				goto bad;
+			fseek(f, size - 16 + (size & 1), SEEK_CUR);
+		}
+		else if(!memcmp(hdr, "data", 4)) {
+			s->frames = size / (2 * s->channels);
+			MapInput(s, ftell(f));
+			return 1;
+		}
+		else
+			fseek(f, size + (size & 1), SEEK_CUR);
+	}
+bad:
+	fprintf(stderr, "%s: not a 16-bit PCM WAV file\n", name);
+	fclose(f);
+	s->file = NULL;
+	return 0;
+}
+
+Int32 HostStream_OpenWrite(HostStream *s, const char *name, Uint32 rate)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Creates a stereo WAV or raw file as a codec output stream
+//
+// Input:     s - stream to initialize
+//            name - file name, .raw/.pcm selects raw stereo Int16
+//            rate - sample rate written to the WAV header
+//
+// Returns:   1 on success, 0 if the file cannot be created
+//
+// Calls:     Nothing
+//
+// Notes:     WAV sizes are patched by HostStream_Close
+///////////////////////////////////////////////////////////////////////
+{
+	static const Uint8 wav[44] = {
+		'R','I','F','F', 0,0,0,0, 'W','A','V','E',
+		'f','m','t',' ', 16,0,0,0, 1,0, 2,0, 0,0,0,0, 0,0,0,0, 4,0, 16,0,
+		'd','a','t','a', 0,0,0,0 };
+	Uint8 hdr[44];
+	FILE *f;
+
+	memset(s, 0, sizeof(HostStream) - sizeof(s->buf));
+	if((f = fopen(name, "wb")) == NULL)
+		return 0;
+	s->file = f;
+	s->channels = 2;
+	s->writing = 1;
+	s->rate = rate;
+	s->format = IsRawName(name) ? HOST_FORMAT_RAW : HOST_FORMAT_WAV;
+	if(s->format == HOST_FORMAT_WAV) {
+		memcpy(hdr, wav, sizeof(hdr));
+		PutLE32(hdr + 24, rate);
+		PutLE32(hdr + 28, rate * 4);
+		fwrite(hdr, 1, sizeof(hdr), f);
+	}
+	return 1;
+}
+
+Uint32 HostStream_Read(HostStream *s, Uint32 *data, Uint32 count)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Reads up to count packed L/R codec words from a stream
+//
+// Input:     s - input stream
+//            data - destination for the codec words
+//            count - number of words wanted
+//
+// Returns:   Number of words read, 0 at end of file
+//
+// Calls:     HostStream_Map for a mapped file
+//
+// Notes:     Assumes a little-endian host, as is the C6748
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i, n;
+	Uint16 mono[HOST_BLOCK];
+	Uint32 *p;
+
+	if(s->map) {
+		for(i = 0; i < count; i += n) {
+			n = count - i;
+			if((p = HostStream_Map(s, &n)) == NULL)
+				break;
+			memcpy(data + i, p, n * 4);
+		}
+		return i;
+	}
+	if(count > s->frames)
+		count = s->frames;
+	if(s->format == HOST_FORMAT_NOISE) {
+		for(i = 0; i < count; i++)
+			data[i] = NoiseWord(s);
+		s->frames -= count;
+		return count;
+	}
+	if(s->channels == 2)
+		n = fread(data, 4, count, (FILE *)s->file);
+	else {
+		if(count > HOST_BLOCK)
+			count = HOST_BLOCK;
+		n = fread(mono, 2, count, (FILE *)s->file);
+		for(i = 0; i < n; i++)
+			data[i] = mono[i] | ((Uint32)mono[i] << 16);
+	}
+	s->frames -= n;
+	if(n < count)
+		s->frames = 0;						// truncated file
+	return n;
+}
+
+Uint32 *HostStream_Map(HostStream *s, Uint32 *count)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the next codec words of an input stream without
+//            copying them
+//
+// Input:     s - input stream
+//            count - number of words wanted, set to the number returned
+//
+// Returns:   Pointer to *count packed L/R words, NULL at end of file
+//
+// Calls:     Advise, or HostStream_Read if the file is not mapped
+//
+// Notes:     For a mapped file the words are the file's own pages, the
+//            same interleaved Int16 L/R layout the EDMA writes into a
+//            frame buffer, and may be processed in place.  Otherwise
+//            they are read into s->buf.  Either way the pointer is
+//            valid until the next call.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 *p;
+
+	if(s->map == NULL) {
+		*count = HostStream_Read(s, s->buf, *count < HOST_BLOCK ? *count : HOST_BLOCK);
+		return *count ? s->buf : NULL;
+	}
+	if(*count > s->frames)
+		*count = s->frames;
+	if(*count > HOST_MAP_WINDOW / 4)
+		*count = HOST_MAP_WINDOW / 4;
+	if(*count == 0)
+		return NULL;
+	p = s->next;
+	s->next += *count;
+	s->frames -= *count;
+	Advise(s);
+	return p;
+}
+
+void HostStream_Write(HostStream *s, const Uint32 *data, Uint32 count)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Writes packed L/R codec words to an output stream
+//
+// Input:     s - output stream
+//            data - codec words
+//            count - number of words
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	fwrite(data, 4, count, (FILE *)s->file);
+	s->frames += count;
+}
+
+void HostStream_Close(HostStream *s)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Closes a stream, completing the WAV header for output
+//
+// Input:     s - stream to close
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Safe to call on a stream that was never opened
+///////////////////////////////////////////////////////////////////////
+{
+	FILE *f = (FILE *)s->file;
+	Uint8 size[4];
+
+	if(f == NULL)
+		return;
+	s->file = NULL;
+	if(s->format == HOST_FORMAT_NOISE)
+		return;
+	if(s->map) {
+		munmap(s->map, s->map_size);
+		s->map = NULL;
+	}
+	if(s->writing && s->format == HOST_FORMAT_WAV) {
+		// patch RIFF and data chunk sizes
+		PutLE32(size, 36 + s->frames * 4);
+		fseek(f, 4, SEEK_SET);
+		fwrite(size, 1, 4, f);
+		PutLE32(size, s->frames * 4);
+		fseek(f, 40, SEEK_SET);
+		fwrite(size, 1, 4, f);
+	}
+	fclose(f);
+}
+
+Int32 HostCodec_Open(const char *in_name, const char *out_name)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Attaches the host codec to its input and output files
+//
+// Input:     in_name - input WAV/raw file
+//            out_name - output WAV/raw file, NULL discards output
+//
+// Returns:   1 on success, 0 on failure
+//
+// Calls:     HostStream_OpenRead, HostStream_OpenWrite, GetSampleFreq
+//
+// Notes:     Call after DSP_Init so GetSampleFreq is valid
+///////////////////////////////////////////////////////////////////////
+{
+	extern float GetSampleFreq();
+	Uint32 fs = (Uint32)GetSampleFreq();
+
+	if(!HostStream_OpenRead(&CodecIn, in_name)) {
+		fprintf(stderr, "cannot read %s\n", in_name);
+		return 0;
+	}
+	if(CodecIn.rate && CodecIn.rate != fs)
+		fprintf(stderr, "warning: %s is %u Hz, program runs at %u Hz\n",
+			in_name, CodecIn.rate, fs);
+	if(out_name) {
+		if(!HostStream_OpenWrite(&CodecOut, out_name, fs)) {
+			fprintf(stderr, "cannot write %s\n", out_name);
+			return 0;
+		}
+		OutOpen = 1;
+	}
+	SampleCount = 0;
+	return 1;
+}
+
+void HostCodec_Close()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Flushes pending output and closes the codec files
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     HostStream_Write, HostStream_Close
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	if(OutOpen && CodecOut.count)
+		HostStream_Write(&CodecOut, CodecOut.buf, CodecOut.count);
+	CodecOut.count = 0;
+	OutOpen = 0;
+	HostStream_Close(&CodecIn);
+	HostStream_Close(&CodecOut);
+}
+
+Int32 HostCodec_IsDataReady()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Checks for another input sample, refilling the block
+//
+// Input:     None
+//
+// Returns:   Non-zero while input samples remain
+//
+// Calls:     HostStream_Map
+//
+// Notes:     Plays the role of the McASP receive interrupt.  A mapped
+//            file is taken a window at a time, in place.
+///////////////////////////////////////////////////////////////////////
+{
+	if(CodecIn.pos < CodecIn.count)
+		return 1;
+	if(CodecIn.file == NULL)
+		return 0;
+	CodecIn.pos = 0;
+	CodecIn.count = CodecIn.map ? HOST_MAP_WINDOW / 4 : HOST_BLOCK;
+	if((CodecIn.words = HostStream_Map(&CodecIn, &CodecIn.count)) == NULL)
+		CodecIn.count = 0;
+	return CodecIn.count != 0;
+}
+
+Uint32 HostCodec_Read()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the next input codec word
+//
+// Input:     None
+//
+// Returns:   Packed L/R samples, 0 once the input is exhausted
+//
+// Calls:     HostCodec_IsDataReady
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	if(!HostCodec_IsDataReady())
+		return 0;
+	SampleCount++;
+	return CodecIn.words[CodecIn.pos++];
+}
+
+const Uint32 *HostCodec_ReadBlock(Uint32 *count)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the next input codec words without copying them
+//
+// Input:     count - number of words wanted, set to the number returned
+//
+// Returns:   Pointer to *count packed L/R words, NULL once the input
+//            is exhausted
+//
+// Calls:     HostCodec_IsDataReady
+//
+// Notes:     May return fewer words than wanted; call again for the
+//            rest.  The words are valid until the next read.
+///////////////////////////////////////////////////////////////////////
+{
+	const Uint32 *p;
+
+	if(!HostCodec_IsDataReady()) {
+		*count = 0;
+		return NULL;
+	}
+	if(*count > CodecIn.count - CodecIn.pos)
+		*count = CodecIn.count - CodecIn.pos;
+	p = CodecIn.words + CodecIn.pos;
+	CodecIn.pos += *count;
+	SampleCount += *count;
+	return p;
+}
+
+void HostCodec_Write(Uint32 data)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Queues one output codec word
+//
+// Input:     data - packed L/R samples
+//
+// Returns:   Nothing
+//
+// Calls:     HostStream_Write
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	if(!OutOpen)
+		return;
+	CodecOut.buf[CodecOut.count++] = data;
+	if(CodecOut.count == HOST_BLOCK) {
+		HostStream_Write(&CodecOut, CodecOut.buf, CodecOut.count);
+		CodecOut.count = 0;
+	}
+}
+
+void HostCodec_WriteBlock(const Uint32 *data, Uint32 count)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Queues a block of output codec words
+//
+// Input:     data - packed L/R samples
+//            count - number of words
+//
+// Returns:   Nothing
+//
+// Calls:     HostStream_Write, HostCodec_Write
+//
+// Notes:     Written straight from data when nothing is queued
+///////////////////////////////////////////////////////////////////////
+{
+	if(!OutOpen)
+		return;
+	if(CodecOut.count == 0)
+		HostStream_Write(&CodecOut, data, count);
+	else
+		while(count--)
+			HostCodec_Write(*data++);
+}
+
+Uint32 HostCodec_GetSampleCount()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the number of samples read since HostCodec_Open
+//
+// Input:     None
+//
+// Returns:   Sample count
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	return SampleCount;
+}
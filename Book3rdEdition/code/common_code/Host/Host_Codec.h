@@ -0,0 +1,57 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Host_Codec.h
+//
+// Synopsis: Declarations for Host_Codec.c, the file-backed codec used
+//           in place of the AIC3106/McASP on a POSIX host
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	HOST_CODEC_H_INCLUDED
+#define HOST_CODEC_H_INCLUDED
+
+#include <stddef.h>
+#include "Host_Target.h"
+
+// stream formats understood by HostCodec_Open
+enum {HOST_FORMAT_WAV, HOST_FORMAT_RAW, HOST_FORMAT_NOISE};
+
+// one direction of the codec (input or output file)
+typedef struct {
+	void  *file;			// FILE *, kept opaque for the ISR files
+	Uint8  format;			// HOST_FORMAT_WAV, _RAW or _NOISE
+	Uint8  channels;		// 1 or 2 channels in the file
+	Uint8  writing;			// non-zero for an output stream
+	Uint32 rate;			// sample rate from the WAV header
+	Uint32 frames;			// frames remaining (input) or written (output)
+	Uint32 count;			// codec words in the current block
+	Uint32 pos;				// next codec word in the current block
+	Uint32 seed;			// noise generator state
+	Uint32 *words;			// current block of input words, in buf or the mapping
+	void  *map;				// mapped input file, NULL when read with stdio
+	size_t map_size;
+	Uint32 *next;			// next codec word in the mapping
+	size_t ahead, behind;	// mapping read ahead to, released up to (bytes)
+	Uint32 buf[4096];		// block of packed L/R codec words
+} HostStream;
+
+// defined in Host_Codec.c
+Int32  HostStream_OpenRead(HostStream *, const char *);
+Int32  HostStream_OpenWrite(HostStream *, const char *, Uint32);
+Uint32 HostStream_Read(HostStream *, Uint32 *, Uint32);
+Uint32 *HostStream_Map(HostStream *, Uint32 *);
+void   HostStream_Write(HostStream *, const Uint32 *, Uint32);
+void   HostStream_Close(HostStream *);
+
+Int32  HostCodec_Open(const char *, const char *);
+void   HostCodec_Close();
+Int32  HostCodec_IsDataReady();
+Uint32 HostCodec_Read();
+const Uint32 *HostCodec_ReadBlock(Uint32 *);
+void   HostCodec_Write(Uint32);
+void   HostCodec_WriteBlock(const Uint32 *, Uint32);
+Uint32 HostCodec_GetSampleCount();
+
+#endif
@@ -0,0 +1,349 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Host_EDMA.c
+//
+// Synopsis: Emulates the EDMA3 channel controller servicing the McASP
+//           for the frame programs.  The controller's register window
+//           is mapped at its OMAP-L138 address, so EDMA_Init programs
+//           PaRAM sets 64-69 exactly as on the board.  A producer
+//           thread then moves one frame every BUFFER_COUNT/Fs seconds
+//           (HOST_FRAME_SIZE sets it in programs with SetFrameSize),
+//           reloads the linked PaRAM sets and raises EDMA_ISR, while
+//           main() polls IsBufferReady/ProcessBuffer as it does on the
+//           board.  Every over_run is reported with a timestamp; programs
+//           using FrameQueue report their dropped and late frames.
+//
+///////////////////////////////////////////////////////////////////////
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include "DSP_Config.h"
+#include "Host_Codec.h"
+#include "Host_EDMA.h"
+
+#define EDMA3_0_CC_SIZE		0x8000		// CC registers and PaRAM
+#define EDMA_LINK_NULL		0xFFFF
+#define EDMA_OPT_TCINTEN	0x00100000
+#define EDMA_OPT_TCC(opt)	(((opt) >> 12) & 0x3F)
+
+// supplied by the EDMA frame programs
+extern void EDMA_ISR() __attribute__((weak));
+extern int  IsBufferReady() __attribute__((weak));
+// supplied by programs using the FrameQueue
+extern Uint32 GetDroppedFrames() __attribute__((weak));
+extern Uint32 GetLateFrames() __attribute__((weak));
+// supplied by programs with a run time frame length
+extern Int32 SetFrameSize(Uint32) __attribute__((weak));
+
+static pthread_t ProducerThread;
+static struct timespec StartTime;
+static Uint32 FrameCount = 0, OverrunCount = 0, FrameSize = 0, Flush = 0;
+static double Period = 0;
+
+#define CC_REG(addr)	(*(volatile Uint32 *)(uintptr_t)(addr))
+
+static void __attribute__((constructor)) MapEDMA()
+{
+	void *p = mmap((void *)(uintptr_t)EDMA3_0_CC_BASE, EDMA3_0_CC_SIZE, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+	if(p != (void *)(uintptr_t)EDMA3_0_CC_BASE) {
+		fprintf(stderr, "cannot map EDMA3 registers at 0x%08X\n", EDMA3_0_CC_BASE);
+		if(p != MAP_FAILED)
+			munmap(p, EDMA3_0_CC_SIZE);
+	}
+}
+
+static void __attribute__((constructor)) SetHostFrameSize()
+{
+	const char *s = getenv("HOST_FRAME_SIZE");
+
+	// before main(), so the program's own EDMA_Init uses it
+	if(s && SetFrameSize && !SetFrameSize(strtoul(s, NULL, 0))) {
+		fprintf(stderr, "HOST_FRAME_SIZE=%s is not a supported frame length\n", s);
+		exit(1);
+	}
+}
+
+double HostEDMA_GetTime()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the time since the EDMA emulator started
+//
+// Input:     None
+//
+// Returns:   Elapsed time in seconds
+//
+// Calls:     clock_gettime
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (t.tv_sec - StartTime.tv_sec) + 1e-9 * (t.tv_nsec - StartTime.tv_nsec);
+}
+
+static Uint8 IsMcASPData(Uint32 addr)
+{
+	return addr >= (Uint32)(uintptr_t)McASP0_Base && addr < (Uint32)(uintptr_t)McASP0_Base + sizeof(McASP);
+}
+
+static void Transfer(volatile EDMA_params *param)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Performs the A/B transfer described by a PaRAM set
+//
+// Input:     param - active PaRAM set for the event
+//
+// Returns:   Nothing
+//
+// Calls:     HostCodec_ReadBlock, HostCodec_WriteBlock, HostCodec_Read,
+//            HostCodec_Write
+//
+// Notes:     A McASP data port as source reads the input file, as
+//            destination writes the output file.  Buffer addresses
+//            are 32 bits, which is why the host build links -no-pie.
+//            A frame of contiguous codec words is copied in one go,
+//            straight from the mapped input file.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 acnt = param->a_b_count & 0xFFFF, bcnt = param->a_b_count >> 16;
+	Int16 sbidx = param->src_dest_b_index & 0xFFFF;
+	Int16 dbidx = param->src_dest_b_index >> 16;
+	Uint32 src = param->source, dest = param->dest, b, n, word;
+	const Uint32 *p;
+
+	if(IsMcASPData(src) && acnt == 4 && dbidx == 4) {
+		for(b = 0; b < bcnt; b += n) {
+			n = bcnt - b;
+			if((p = HostCodec_ReadBlock(&n)) == NULL) {
+				memset((void *)(uintptr_t)(dest + b * 4), 0, (bcnt - b) * 4);	// input finished
+				break;
+			}
+			memcpy((void *)(uintptr_t)(dest + b * 4), p, n * 4);
+		}
+		return;
+	}
+	if(IsMcASPData(dest) && acnt == 4 && sbidx == 4) {
+		HostCodec_WriteBlock((const Uint32 *)(uintptr_t)src, bcnt);
+		return;
+	}
+	for(b = 0; b < bcnt; b++) {
+		if(IsMcASPData(src)) {
+			word = HostCodec_Read();
+			memcpy((void *)(uintptr_t)(dest + b * dbidx), &word, acnt < 4 ? acnt : 4);
+		}
+		else if(IsMcASPData(dest)) {
+			word = 0;
+			memcpy(&word, (void *)(uintptr_t)(src + b * sbidx), acnt < 4 ? acnt : 4);
+			HostCodec_Write(word);
+		}
+		else
+			memcpy((void *)(uintptr_t)(dest + b * dbidx), (void *)(uintptr_t)(src + b * sbidx), acnt);
+	}
+}
+
+static Uint32 ServiceEvent(Uint32 event)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Completes one frame on an event channel and reloads it
+//
+// Input:     event - EDMA3_EVENT_MCASP0_RX or EDMA3_EVENT_MCASP0_TX
+//
+// Returns:   Interrupt pending bit raised by the completion, 0 if none
+//
+// Calls:     Transfer
+//
+// Notes:     On completion the linked PaRAM set is copied into the
+//            event's set, as the EDMA3 does with link_reload
+///////////////////////////////////////////////////////////////////////
+{
+	volatile EDMA_params *param = (volatile EDMA_params *)(uintptr_t)EDMA3_0_PARAM(event);
+	Uint32 link, opt = param->option;
+
+	if(!(CC_REG(EDMA3_0_CC_EESR) & (1 << event)))
+		return 0;
+	Transfer(param);
+	link = param->link_reload & 0xFFFF;
+	if(link != EDMA_LINK_NULL)
+		memcpy((void *)param, (void *)(uintptr_t)(EDMA3_0_CC_BASE + link), sizeof(EDMA_params));
+	else
+		param->a_b_count = 0;
+	return (opt & EDMA_OPT_TCINTEN) ? 1 << EDMA_OPT_TCC(opt) : 0;
+}
+
+static void RaiseInterrupt(Uint32 pending)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Raises EDMA3_CC0_INT1 and reports any overrun
+//
+// Input:     pending - interrupt pending bits from ServiceEvent
+//
+// Returns:   Nothing
+//
+// Calls:     EDMA_ISR
+//
+// Notes:     Programs with a FrameQueue count their own dropped and
+//            late frames, and new ones are reported at each interrupt.
+//            For the others a frame still ready when the next one
+//            completes is an over_run.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 missed = 0;
+	double t;
+
+	CC_REG(EDMA3_0_CC_IPR) |= pending;
+	if(!(CC_REG(EDMA3_0_CC_IPR) & CC_REG(EDMA3_0_CC_IESR)) || !(IER & 0x0100) || !(CSR & 1))
+		return;
+
+	if(!GetDroppedFrames && IsBufferReady && IsBufferReady())	// previous frame still unprocessed
+		missed = 1;
+	CC_REG(EDMA3_0_CC_ICR) = 0;
+	if(EDMA_ISR)
+		EDMA_ISR();
+	CC_REG(EDMA3_0_CC_IPR) &= ~CC_REG(EDMA3_0_CC_ICR);
+	if(GetDroppedFrames)
+		missed = GetDroppedFrames() + (GetLateFrames ? GetLateFrames() : 0) - OverrunCount;
+
+	if(missed) {
+		t = HostEDMA_GetTime();
+		OverrunCount += missed;
+		fprintf(stderr, "EDMA over_run: frame %u at %.6f s (%.3f ms after frame %u was ready)\n",
+			FrameCount, t, 1e3 * (t - (FrameCount - 1) * Period), FrameCount - 1);
+	}
+}
+
+Int32 HostEDMA_Step()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Moves one frame through the emulated McASP/EDMA
+//
+// Input:     None
+//
+// Returns:   1 if a frame was moved, 0 once the input is finished
+//
+// Calls:     ServiceEvent, RaiseInterrupt
+//
+// Notes:     Two extra frames flush the triple buffer, so the output
+//            carries the board's 2*BUFFER_COUNT sample latency.  Call
+//            directly (with no frame clock) in HOST_ISR_POLLED mode.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 pending;
+
+	if(Flush == 0)
+		return 0;
+	if(!HostCodec_IsDataReady())
+		Flush--;
+	pending = ServiceEvent(EDMA3_EVENT_MCASP0_TX);
+	pending |= ServiceEvent(EDMA3_EVENT_MCASP0_RX);
+	FrameCount++;
+	RaiseInterrupt(pending);
+	return 1;
+}
+
+static void *ProducerTask(void *arg)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Stands in for the McASP and EDMA hardware
+//
+// Input:     arg - unused
+//
+// Returns:   Never, ends the process at end of input
+//
+// Calls:     HostEDMA_Step
+//
+// Notes:     Frames are paced at GetSampleFreq, scaled by HOST_EDMA_SPEED
+//            (e.g. 2 runs twice real time).  HOST_EDMA_SPEED=0 drops
+//            the frame clock: each frame waits until the last one has
+//            been processed, so no over_run can occur and a program
+//            runs as fast as ProcessBuffer allows.
+///////////////////////////////////////////////////////////////////////
+{
+	const char *s = getenv("HOST_EDMA_SPEED");
+	double speed = s ? atof(s) : 1.0;
+	struct timespec next = StartTime;
+	long long ns;
+
+	if(speed < 0)
+		speed = 1.0;
+	if(speed > 0)
+		Period /= speed;
+
+	while(Flush) {
+		if(speed == 0) {
+			while(IsBufferReady && IsBufferReady())	// lockstep with main()
+				sched_yield();
+		}
+		else {
+			ns = next.tv_nsec + (long long)(Period * 1e9);
+			next.tv_sec += ns / 1000000000;
+			next.tv_nsec = ns % 1000000000;
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+		}
+		HostEDMA_Step();
+	}
+
+	fprintf(stderr, "EDMA: %u frames of %u samples, %u over_run(s), %.3f s of audio in %.3f s\n",
+		FrameCount, FrameSize, OverrunCount, FrameCount * FrameSize / GetSampleFreq(),
+		HostEDMA_GetTime());
+	HostCodec_Close();
+	exit(OverrunCount != 0);
+	return arg;
+}
+
+void HostEDMA_Start(Uint8 threaded)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Starts the emulated McASP/EDMA frame transfers
+//
+// Input:     threaded - non-zero to open the codec and start the
+//                       frame clock thread, 0 for HostEDMA_Step
+//
+// Returns:   Nothing
+//
+// Calls:     HostCodec_Open
+//
+// Notes:     Called by EnableInterrupts_EDMA after EDMA_Init has set
+//            up the PaRAM.  The thread's codec files come from
+//            HOST_CODEC_IN and HOST_CODEC_OUT; in polled mode the
+//            caller opens the codec.
+///////////////////////////////////////////////////////////////////////
+{
+	volatile EDMA_params *rx = (volatile EDMA_params *)(uintptr_t)EDMA3_0_PARAM(EDMA3_EVENT_MCASP0_RX);
+	const char *in = getenv("HOST_CODEC_IN");
+
+	FrameSize = rx->a_b_count >> 16;
+	if(FrameSize == 0) {
+		fprintf(stderr, "EDMA_Init has not configured the McASP receive event\n");
+		exit(1);
+	}
+	Flush = 2;
+	Period = FrameSize / GetSampleFreq();
+	clock_gettime(CLOCK_MONOTONIC, &StartTime);
+	if(!threaded)
+		return;
+
+	if(in == NULL || !HostCodec_Open(in, getenv("HOST_CODEC_OUT"))) {
+		fprintf(stderr, "HOST_CODEC_IN must name the input WAV/raw file\n");
+		exit(1);
+	}
+	if(pthread_create(&ProducerThread, NULL, ProducerTask, NULL)) {
+		fprintf(stderr, "cannot start EDMA thread\n");
+		exit(1);
+	}
+}
+
+Uint32 HostEDMA_GetFrameCount()
+{
+	return FrameCount;
+}
+
+Uint32 HostEDMA_GetOverrunCount()
+{
+	return OverrunCount;
+}
@@ -0,0 +1,23 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Host_EDMA.h
+//
+// Synopsis: Declarations for Host_EDMA.c, the EDMA3/McASP emulator
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	HOST_EDMA_H_INCLUDED
+#define HOST_EDMA_H_INCLUDED
+
+#include "Host_Target.h"
+
+// defined in Host_EDMA.c
+void   HostEDMA_Start(Uint8);
+Int32  HostEDMA_Step();
+Uint32 HostEDMA_GetFrameCount();
+Uint32 HostEDMA_GetOverrunCount();
+double HostEDMA_GetTime();
+
+#endif
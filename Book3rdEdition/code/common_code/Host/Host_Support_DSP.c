@@ -0,0 +1,361 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Host_Support_DSP.c
+//
+// Synopsis: POSIX implementation of the LCDK_Support_DSP.h interface.
+//           The codec is replaced by Host_Codec.c, and Codec_ISR is
+//           called back-to-back with no sample clock, so a program
+//           runs as fast as the host can execute it.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "DSP_Config.h"
+#include "Host_Codec.h"
+#include "Host_EDMA.h"
+#include "Host_Support_DSP.h"
+#include "FrameTimer.h"
+
+// control registers declared in the host c6x.h
+volatile unsigned int ISTP, IER, ICR, CSR;
+
+static float SampleFreq = 0.0F;
+static Uint8 LEDs = 0;
+static Uint8 InterruptMode = HOST_ISR_THREAD;
+static pthread_t InterruptThread;
+static FrameTimer CodecTimer;
+
+// supplied by per-sample programs; frame programs using EDMA omit it
+extern void Codec_ISR() __attribute__((weak));
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the current sample frequency as determined by
+//            SampleRateSetting in DSP_Config.h
+//
+// Input:     None
+//
+// Returns:   Sample frequency in floating point format
+//
+// Calls:     None
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+float GetSampleFreq()
+{
+	return SampleFreq;
+}
+
+void Host_SetInterruptMode(Uint8 mode)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Selects who calls Codec_ISR once interrupts are enabled
+//
+// Input:     mode - HOST_ISR_POLLED: the caller loops on
+//                   HostCodec_IsDataReady and calls Codec_ISR itself
+//                   HOST_ISR_THREAD: EnableInterrupts starts a thread
+//                   that calls Codec_ISR until the input runs out
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Call before DSP_Init.  The host main.c selects polled mode;
+//            programs with their own main() get the thread.
+///////////////////////////////////////////////////////////////////////
+{
+	InterruptMode = mode;
+}
+
+static void InitTiming()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up the execution time report
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     FrameTimer_GetTickRate, FrameTimer_SetDumpInterval
+//
+// Notes:     HOST_TIMING=s prints the FrameTimers every s seconds of
+//            signal and at exit; HOST_TIMING=0 prints them at exit only
+///////////////////////////////////////////////////////////////////////
+{
+	const char *s = getenv("HOST_TIMING");
+
+	FrameTimer_GetTickRate();			// calibrate before the first frame
+	if(s != NULL) {
+		FrameTimer_SetDumpInterval(atof(s));
+		atexit(FrameTimer_DumpAll);
+	}
+}
+
+static Int32 OpenCodecFromEnvironment()
+{
+	const char *in = getenv("HOST_CODEC_IN");
+
+	if(in == NULL) {
+		fprintf(stderr, "HOST_CODEC_IN must name the input WAV/raw file\n");
+		return 0;
+	}
+	return HostCodec_Open(in, getenv("HOST_CODEC_OUT"));
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Initializes the host codec
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     Init_Interrupts, Init_AIC3106, InitTiming, EnableInterrupts
+//
+// Notes:     SampleRateSetting is defined in DSP_Config.h.  In thread
+//            mode the codec files come from HOST_CODEC_IN/HOST_CODEC_OUT.
+///////////////////////////////////////////////////////////////////////
+void DSP_Init()
+{
+	Init_Interrupts();
+	Init_AIC3106(SampleRateSetting);
+	InitTiming();
+	if(InterruptMode == HOST_ISR_THREAD && !OpenCodecFromEnvironment())
+		exit(1);
+	EnableInterrupts();
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Initializes the host codec for EDMA use
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     Init_Interrupts_EDMA, Init_AIC3106, InitTiming,
+//            EnableInterrupts_EDMA
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+void DSP_Init_EDMA()
+{
+	Init_Interrupts_EDMA();
+	Init_AIC3106(SampleRateSetting);
+	InitTiming();
+	EnableInterrupts_EDMA();
+}
+
+Int32 InitLEDs()
+{
+	LEDs = 0;
+	return 1;
+}
+
+Uint32 WriteLEDs(Uint8 led_bits)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Records the user LED state
+//
+// Input:     led_bits - USER_LEDx bits
+//
+// Returns:   1 always
+//
+// Calls:     Nothing
+//
+// Notes:     Read back with Host_ReadLEDs
+///////////////////////////////////////////////////////////////////////
+{
+	LEDs = led_bits;
+	return 1;
+}
+
+Uint8 Host_ReadLEDs()
+{
+	return LEDs;
+}
+
+Int32 ReadSwitches()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Reads the user DIP switches
+//
+// Input:     None
+//
+// Returns:   Switch state from HOST_SWITCHES, 0 if unset
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	const char *sw = getenv("HOST_SWITCHES");
+
+	return sw ? (Int32)(strtol(sw, NULL, 0) & 0xF) : 0;
+}
+
+void InitDigitalOutputs()
+{
+	WriteLEDs(0);
+}
+
+void WriteDigitalOutputs(Uint8 data)
+{
+	WriteLEDs(data);
+}
+
+void Init_Interrupts()
+{
+	ISTP = 0x11800000;
+}
+
+void Host_RunCodecISR()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Calls Codec_ISR once, timing it
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     Codec_ISR, FrameTimer_Start, FrameTimer_Stop
+//
+// Notes:     The deadline is one sample period
+///////////////////////////////////////////////////////////////////////
+{
+	FrameTimer_Start(&CodecTimer);
+	Codec_ISR();
+	FrameTimer_Stop(&CodecTimer);
+}
+
+static void *InterruptTask(void *arg)
+{
+	while(HostCodec_IsDataReady())
+		Host_RunCodecISR();
+	HostCodec_Close();
+	exit(0);								// the program's main() never returns
+	return arg;
+}
+
+void EnableInterrupts()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Enables the codec interrupt
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     In thread mode this starts the thread standing in for
+//            the McASP interrupt.  It ends the process at end of input.
+///////////////////////////////////////////////////////////////////////
+{
+	IER |= 0x1002;
+	ICR = 0xffff;
+	CSR |= 1;
+	if(Codec_ISR)
+		FrameTimer_Init(&CodecTimer, "Codec_ISR", 1 / SampleFreq);
+	if(InterruptMode == HOST_ISR_THREAD && Codec_ISR) {
+		if(pthread_create(&InterruptThread, NULL, InterruptTask, NULL)) {
+			fprintf(stderr, "cannot start interrupt thread\n");
+			exit(1);
+		}
+	}
+}
+
+void Init_Interrupts_EDMA()
+{
+	ISTP = 0x11800000;
+}
+
+void EnableInterrupts_EDMA()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Enables the EDMA3_CC0_INT1 interrupt
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     HostEDMA_Start
+//
+// Notes:     Starts the emulated McASP/EDMA transfers set up by EDMA_Init;
+//            in polled mode the caller moves frames with HostEDMA_Step
+///////////////////////////////////////////////////////////////////////
+{
+	IER |= 0x0102;
+	ICR = 0xffff;
+	CSR |= 1;
+	HostEDMA_Start(InterruptMode == HOST_ISR_THREAD);
+}
+
+// the I2C link has nothing to talk to on the host
+void   Init_I2C() {}
+void   Reset_I2C() {}
+Uint32 Write_I2C(Uint16 addr, Uint8 *pdata, Uint16 num_bytes) { return num_bytes; }
+Uint32 WriteRead_I2C(Uint16 addr, Uint8 *pdata, Uint16 num_wr, Uint16 num_rd) { return num_rd; }
+Uint32 Read_I2C(Uint16 addr, Uint8 *pdata, Uint16 num_bytes) { return num_bytes; }
+Uint32 AIC3106_write_reg(Uint8 address, Uint8 data) { return 1; }
+Uint32 Reset_AIC3106() { return 1; }
+void   Init_McASP0() {}
+
+Uint32 Init_AIC3106(Uint8 nFs)
+{
+	return SetSampleRate_AIC3106(nFs);
+}
+
+Uint32 SetSampleRate_AIC3106(Uint8 nFs)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets the sample rate to one of the enumerated values
+//
+// Input:     nFs - selects sample rate to use
+//
+// Returns:   1 always
+//
+// Calls:     Nothing
+//
+// Notes:     Update SampleFreq variable with new Fs
+///////////////////////////////////////////////////////////////////////
+{
+	switch(nFs) {
+	case AIC3106Fs96kHz:	SampleFreq = 96000.0F;	break;
+	case AIC3106Fs32kHz:	SampleFreq = 32000.0F;	break;
+	case AIC3106Fs24kHz:	SampleFreq = 24000.0F;	break;
+	case AIC3106Fs16kHz:	SampleFreq = 16000.0F;	break;
+	case AIC3106Fs12kHz:	SampleFreq = 12000.0F;	break;
+	case AIC3106Fs8kHz:		SampleFreq = 8000.0F;	break;
+	//case AIC3106Fs48kHz:
+	default:				SampleFreq = 48000.0F;	break;
+	}
+	return 1;
+}
+
+Uint32 ReadCodecData()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Read codec receive data
+//
+// Input:     None
+//
+// Returns:   Next packed L/R word from the input file
+//
+// Calls:     HostCodec_Read
+//
+// Notes:     Assumes data is ready
+///////////////////////////////////////////////////////////////////////
+{
+	return HostCodec_Read();
+}
+
+void WriteCodecData(Uint32 data)
+{
+	HostCodec_Write(data);
+}
+
+Uint32 CheckForOverrun()
+{
+	return 0;								// the host never drops input samples
+}
+
+// UART2 maps to the console
+void  Init_UART2(Uint32 baud_rate) {}
+void  Write_UART2(Uint8 c) { putchar(c); }
+void  Puts_UART2(char *s) { fputs(s, stdout); }
+Uint8 Read_UART2() { int c = getchar(); return c == EOF ? 0 : c; }
+Uint8 IsDataReady_UART2() { return 0; }
+Uint8 IsTxReady_UART2() { return 1; }
@@ -0,0 +1,24 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Host_Support_DSP.h
+//
+// Synopsis: Host-only additions to the LCDK_Support_DSP.h interface
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	HOST_SUPPORT_DSP_H_INCLUDED
+#define HOST_SUPPORT_DSP_H_INCLUDED
+
+#include "Host_Target.h"
+
+// interrupt modes for Host_SetInterruptMode
+enum {HOST_ISR_THREAD, HOST_ISR_POLLED};
+
+// defined in Host_Support_DSP.c
+void  Host_SetInterruptMode(Uint8);
+void  Host_RunCodecISR();
+Uint8 Host_ReadLEDs();
+
+#endif
@@ -0,0 +1,37 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Host_Target.h
+//
+// Synopsis: Forced include for building DSP programs on a POSIX host
+//           (gcc/clang -include Host_Target.h).  Supplies the TI
+//           standard types ahead of any tistdtypes.h copy so the
+//           unmodified project headers compile off-target.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	HOST_TARGET_H_INCLUDED
+#define HOST_TARGET_H_INCLUDED
+
+#define DSPBOARDTYPE_HOST
+
+// tistdtypes.h is skipped once _TI_STD_TYPES is defined, so the
+// sizes below must match the C6x definitions (LP64 and ILP32 hosts)
+#define _TI_STD_TYPES
+
+typedef int                     Int;
+typedef unsigned                Uns;
+typedef char                    Char;
+typedef char                    *String;
+typedef void                    *Ptr;
+typedef unsigned short          Bool;
+
+typedef unsigned int            Uint32;
+typedef unsigned short          Uint16;
+typedef unsigned char           Uint8;
+typedef int                     Int32;
+typedef short                   Int16;
+typedef char                    Int8;
+
+#endif
@@ -0,0 +1,159 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: multi.c
+//
+// Synopsis: Host main program running many channels of a per-channel
+//           algorithm (AMreceiver.c, BPSK_rcvr.c, ...) with
+//           StreamSched.c.  Build with -DSTREAM_ALGORITHM=<name> of
+//           the algorithm's StreamAlgorithm.
+//
+//           usage: program [-c channels] [-j workers] [-b block]
+//                          [-n samples] [input.wav [output.wav]]
+//
+//           -c  channels (default 256)
+//           -j  worker threads (default: one per core)
+//           -b  samples per block (default 256)
+//           -n  samples per channel with no input (default 480000)
+//
+//           With an input file every channel receives it, and all
+//           outputs are checked to be the same as channel 0's, which
+//           is written to output.wav.  With no input each channel gets
+//           its own noise (seed = channel + 1).  The throughput of
+//           all channels together is printed.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "Host_Codec.h"
+#include "StreamSched.h"
+
+#ifndef STREAM_ALGORITHM
+#error "build with -DSTREAM_ALGORITHM=<StreamAlgorithm of the program>"
+#endif
+extern const StreamAlgorithm STREAM_ALGORITHM;
+
+// HostCodec_Open, unused here, refers to the program's sample rate
+float GetSampleFreq()
+{
+	return 48000.0F;
+}
+
+static double Now()
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+	const StreamAlgorithm *a = &STREAM_ALGORITHM;
+	Uint32 channels = 256, workers = 0, block = 256, samples = 480000;
+	Uint32 c, i, n, done = 0, differ = 0, rate = 48000;
+	static HostStream in, out;
+	static Uint32 words[4096];
+	StreamSched sched;
+	StreamChannel *ch;
+	float *x, *y;
+	Uint32 *seed, *w;
+	double start, elapsed;
+	int opt;
+
+	while((opt = getopt(argc, argv, "c:j:b:n:")) != -1) {
+		switch(opt) {
+		case 'c':	channels = atoi(optarg);	break;
+		case 'j':	workers = atoi(optarg);		break;
+		case 'b':	block = atoi(optarg);		break;
+		case 'n':	samples = atoi(optarg);		break;
+		default:	argc = 0;					break;
+		}
+	}
+	if(argc == 0 || argc - optind > 2 || channels == 0 || block == 0) {
+		fprintf(stderr, "usage: %s [-c channels] [-j workers] [-b block] [-n samples] "
+			"[input.wav [output.wav]]\n", argv[0]);
+		return 2;
+	}
+	if(block > 4096)
+		block = 4096;
+	if(optind < argc) {
+		if(!HostStream_OpenRead(&in, argv[optind]))
+			return 1;
+		samples = in.frames;
+		if(in.rate)
+			rate = in.rate;
+	}
+	if(optind + 1 < argc && !HostStream_OpenWrite(&out, argv[optind + 1], rate))
+		return 1;
+
+	ch = calloc(channels, sizeof(StreamChannel));
+	x = malloc((size_t)channels * block * sizeof(float));
+	y = malloc((size_t)channels * block * sizeof(float));
+	seed = malloc(channels * sizeof(Uint32));
+	if(!ch || !x || !y || !seed || !StreamSched_Init(&sched, a, ch, channels, workers)) {
+		fprintf(stderr, "%s: cannot create %u channels\n", argv[0], channels);
+		return 1;
+	}
+	for(c = 0; c < channels; c++) {
+		ch[c].in = in.file ? x : x + (size_t)c * block;
+		ch[c].out = y + (size_t)c * block;
+		seed[c] = c + 1;
+	}
+
+	start = Now();
+	while(done < samples) {
+		n = samples - done < block ? samples - done : block;
+		if(in.file) {
+			// one input for all channels, from the codec channel the ISR reads
+			if((w = HostStream_Map(&in, &n)) == NULL)
+				break;
+			for(i = 0; i < n; i++)
+				x[i] = ((Int16 *)w)[2 * i + a->input];
+		}
+		else {
+			// the host codec's noise, one seed per channel
+			for(c = 0; c < channels; c++)
+				for(i = 0; i < n; i++) {
+					seed[c] = seed[c] * 1664525 + 1013904223;
+					x[(size_t)c * block + i] = (Int16)(seed[c] >> 16) >> 2;
+				}
+		}
+
+		StreamSched_Run(&sched, n);
+
+		if(in.file)
+			for(c = 1; c < channels; c++)
+				if(memcmp(ch[c].out, y, n * sizeof(float))) {
+					differ++;
+					break;
+				}
+		if(out.file) {
+			for(i = 0; i < n; i++)
+				words[i] = (Uint16)(Int16)y[i] | (Uint32)(Uint16)(Int16)y[i] << 16;
+			HostStream_Write(&out, words, n);
+		}
+		done += n;
+	}
+	elapsed = Now() - start;
+
+	printf("%s: %u channels x %u samples in %.3f s, %.3g channel-samples/s "
+		"(%.0fx real time at %u Hz), %u workers, %u steals\n",
+		a->name, channels, done, elapsed, (double)channels * done / elapsed,
+		(double)channels * done / rate / elapsed, rate, sched.workers, sched.steals);
+	if(in.file)
+		printf("%s: %u of %u blocks with a channel differing from channel 0\n",
+			a->name, differ, (done + block - 1) / block);
+
+	StreamSched_Close(&sched);
+	if(in.file)
+		HostStream_Close(&in);
+	if(out.file)
+		HostStream_Close(&out);
+	return differ != 0;
+}
@@ -0,0 +1,132 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: parallel.c
+//
+// Synopsis: Converts the IIR filters of coefficient files to parallel
+//           form with ParallelIIR.c and checks each against its
+//           cascade, before a program is changed to use the parallel
+//           form.
+//
+//           usage: parallel [-m snr:dB] [-n samples] file.c ...
+//
+//           -m  tolerance, as for Golden/golden.c (default snr:90)
+//           -n  samples of seeded noise to compare (default 480000)
+//
+//           A file is the .c that sos_dump2c.m (rows of 5), SOS2C.m
+//           (rows of 6) or IIR_dump2C.m (B then A) writes; the first
+//           array initialized in it is taken as SOS rows if it is
+//           declared [5] or [6] wide, otherwise it and the next are
+//           the numerator and denominator.  The parallel sections are
+//           printed as {b0, b1, a1, a2} rows with the direct gain d,
+//           followed by the comparison.  The exit status is 1 if any
+//           file has no parallel form or fails the comparison.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "ParallelIIR.h"
+#include "CoeffFile.h"
+
+#define PARALLEL_MAX_VALUES	1024
+
+static Int32 Convert(const char *name, const char *mode, Uint32 samples)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Converts and checks the filter of one file
+//
+// Input:     name - coefficient file
+//            mode - tolerance, as for Golden_ParseMode
+//            samples - length of the comparison
+//
+// Returns:   1 if the parallel form passed, 0 if not
+//
+// Calls:     CoeffFile_Read, CoeffFile_NextArray, ParallelIIR_InitSOS,
+//            ParallelIIR_InitTF, ParallelIIR_Check, Golden_Report
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	static float b[PARALLEL_MAX_VALUES], a[PARALLEL_MAX_VALUES];
+	Uint32 nb, na, width, k;
+	ParallelIIR f;
+	Golden check;
+	char *text, *pos;
+	Int32 ok;
+
+	text = CoeffFile_Read(name);
+	if(text == NULL) {
+		fprintf(stderr, "parallel: cannot read %s\n", name);
+		return 0;
+	}
+	pos = text;
+	nb = CoeffFile_NextArray(&pos, b, PARALLEL_MAX_VALUES, &width);
+	if(nb == 0) {
+		fprintf(stderr, "parallel: no coefficients in %s\n", name);
+		free(text);
+		return 0;
+	}
+	if(width > 1) {
+		printf("%s: %u sections of %u\n", name, nb / width, width);
+		ok = ParallelIIR_InitSOS(&f, b, nb / width, width, 1);
+	}
+	else {
+		na = CoeffFile_NextArray(&pos, a, PARALLEL_MAX_VALUES, &width);
+		if(na != nb) {
+			fprintf(stderr, "parallel: %s has %u numerator and %u denominator values\n",
+				name, nb, na);
+			free(text);
+			return 0;
+		}
+		printf("%s: transfer function of %u coefficients\n", name, nb);
+		ok = ParallelIIR_InitTF(&f, b, a, nb);
+	}
+	free(text);
+	if(!ok) {
+		printf("%s: FAIL, no parallel form (repeated poles, or more zeros than poles)\n",
+			name);
+		return 0;
+	}
+
+	printf("d = %g\n", f.direct);
+	for(k = 0; k < f.sections; k++)
+		printf("{%12g, %12g, %12g, %12g},\n", f.c[4*k], f.c[4*k+1], f.c[4*k+2],
+			f.c[4*k+3]);
+	Golden_Init(&check, (char *)name, GOLDEN_SNR, 90);
+	Golden_ParseMode(&check, mode);
+	ParallelIIR_Check(&f, &check, samples, 1);
+	ok = Golden_Report(&check);
+	ParallelIIR_Close(&f);
+	return ok;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *mode = "snr:90";
+	Uint32 samples = 480000, failed = 0;
+	Golden check;
+	int opt, i;
+
+	while((opt = getopt(argc, argv, "m:n:")) != -1) {
+		switch(opt) {
+		case 'm':	mode = optarg;			break;
+		case 'n':	samples = atoi(optarg);	break;
+		default:	argc = 0;				break;
+		}
+	}
+	if(argc - optind < 1) {
+		fprintf(stderr, "usage: %s [-m snr:dB] [-n samples] file.c ...\n", argv[0]);
+		return 2;
+	}
+	if(!Golden_ParseMode(&check, mode)) {
+		fprintf(stderr, "parallel: unknown mode %s\n", mode);
+		return 2;
+	}
+
+	for(i = optind; i < argc; i++)
+		if(!Convert(argv[i], mode, samples))
+			failed++;
+	return failed != 0;
+}
@@ -0,0 +1,145 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: tune.c
+//
+// Synopsis: Host main program choosing the frame length of an EDMA
+//           frame program with SetFrameSize (FiltFrm_6748,
+//           Frame_EDMA_6748).  Link it in place of the program's
+//           main.c.  Each frame length is run on seeded noise with
+//           no frame clock, ProcessBuffer is timed, and the shortest
+//           frame whose p99 time fits in the given share of the frame
+//           period is chosen.  Shorter frames mean less latency
+//           (NUM_BUFFERS-1 frames), longer ones less overhead per
+//           sample.
+//
+//           usage: program [-f fraction] [-s seconds] [size ...]
+//
+//           -f  share of the frame period ProcessBuffer may take at
+//               p99 (default 0.5)
+//           -s  seconds of signal per size (default 2, at least 500
+//               frames are run)
+//           size  frame lengths to try (default 16, 32, ... up to the
+//                 largest SetFrameSize accepts)
+//
+//           The chosen length is printed last, for HOST_FRAME_SIZE or
+//           a call to SetFrameSize before EDMA_Init in main().  The
+//           exit status is 1 if no length fits.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "DSP_Config.h"
+#include "Host_Codec.h"
+#include "Host_EDMA.h"
+#include "Host_Support_DSP.h"
+#include "FrameTimer.h"
+
+#define TUNE_MAX_SIZES	32
+
+// supplied by the frame program
+extern void ZeroBuffers();
+extern void EDMA_Init();
+extern void ProcessBuffer();
+extern int  IsBufferReady();
+extern Int32 SetFrameSize(Uint32);
+extern void GetProcessTiming(FrameTimerStats *);
+
+static Int32 Measure(Uint32 size, float seconds, FrameTimerStats *s)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Times ProcessBuffer at one frame length
+//
+// Input:     size - McASP samples (L+R) per frame
+//            seconds - signal to run
+//            s - receives the ProcessBuffer statistics
+//
+// Returns:   1 on success, 0 if the program rejects the length
+//
+// Calls:     SetFrameSize, ZeroBuffers, EDMA_Init, DSP_Init_EDMA,
+//            HostCodec_Open, HostEDMA_Step, ProcessBuffer,
+//            GetProcessTiming
+//
+// Notes:     The first frame is left out of the statistics, it
+//            carries the cache misses of the new buffer layout
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 samples, frames = 0;
+	char noise[32];
+
+	if(!SetFrameSize(size))
+		return 0;
+	ZeroBuffers();
+	EDMA_Init();
+	DSP_Init_EDMA();
+	samples = (Uint32)(seconds * GetSampleFreq());
+	if(samples < 500 * size)
+		samples = 500 * size;
+	sprintf(noise, "noise:%u:1", samples);
+	if(!HostCodec_Open(noise, NULL))
+		exit(1);
+
+	while(HostEDMA_Step()) {
+		if(IsBufferReady()) {
+			ProcessBuffer();
+			if(++frames == 1)
+				SetFrameSize(size);			// drop the first frame's time
+		}
+	}
+	HostCodec_Close();
+	GetProcessTiming(s);
+	return 1;
+}
+
+int main(int argc, char *argv[])
+{
+	Uint32 sizes[TUNE_MAX_SIZES], count = 0, i, best = 0, listed;
+	float fraction = 0.5, seconds = 2;
+	FrameTimerStats s;
+	int opt;
+
+	while((opt = getopt(argc, argv, "f:s:")) != -1) {
+		switch(opt) {
+		case 'f':	fraction = atof(optarg);	break;
+		case 's':	seconds = atof(optarg);		break;
+		default:	argc = 0;					break;
+		}
+	}
+	if(argc == 0 || argc - optind > TUNE_MAX_SIZES || fraction <= 0) {
+		fprintf(stderr, "usage: %s [-f fraction] [-s seconds] [size ...]\n", argv[0]);
+		return 2;
+	}
+	for(; optind < argc; optind++)
+		sizes[count++] = strtoul(argv[optind], NULL, 0);
+	listed = count;
+	if(count == 0)
+		for(i = 16; i && count < TUNE_MAX_SIZES; i <<= 1)
+			sizes[count++] = i;				// the end is found by SetFrameSize
+
+	Host_SetInterruptMode(HOST_ISR_POLLED);
+
+	printf("  size   period us    mean us     p99 us     max us   p99 load\n");
+	for(i = 0; i < count; i++) {
+		if(!Measure(sizes[i], seconds, &s)) {
+			if(!listed)
+				break;						// past the largest supported length
+			fprintf(stderr, "%s: frame length %u is not supported\n", argv[0], sizes[i]);
+			continue;
+		}
+		printf("%6u %11.1f %10.2f %10.2f %10.2f %9.1f%%%s\n", sizes[i], s.period,
+			s.mean, s.p99, s.max, 100 * s.p99 / s.period,
+			s.p99 <= fraction * s.period ? "" : "  late");
+		if(s.p99 <= fraction * s.period && (best == 0 || sizes[i] < best))
+			best = sizes[i];
+	}
+
+	if(best == 0) {
+		printf("no frame length keeps p99 within %.0f%% of the frame period\n", 100 * fraction);
+		return 1;
+	}
+	printf("frame length %u: p99 within %.0f%% of its %.2f ms period\n",
+		best, 100 * fraction, 1e3 * best / GetSampleFreq());
+	return 0;
+}
@@ -0,0 +1,122 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: c6x.h
+//
+// Synopsis: Host stand-in for the TI compiler's c6x.h.  Provides the
+//           interrupt keyword, the control registers, the time stamp
+//           counter and the C6000 intrinsics used by the example
+//           programs.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	C6X_H_INCLUDED
+#define C6X_H_INCLUDED
+
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ISRs are plain functions on the host; Host_Support_DSP.c calls them
+#define interrupt
+
+// control registers, defined in Host_Support_DSP.c
+extern volatile unsigned int ISTP, IER, ICR, CSR;
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Float to int conversion with saturation (SPINT)
+//
+// Input:     x - value to convert
+//
+// Returns:   x rounded to nearest and bounded to the Int32 range
+//
+// Calls:     lrintf
+//
+// Notes:     Programs use _spint(x * 65536) >> 16 to bound to 16 bits
+///////////////////////////////////////////////////////////////////////
+static inline int _spint(float x)
+{
+	if(x >= 2147483647.0F)
+		return 0x7FFFFFFF;
+	if(x <= -2147483648.0F)
+		return (int)0x80000000;
+	if(x != x)							// NaN converts to the negative limit
+		return (int)0x80000000;
+	return (int)lrintf(x);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Double to int conversion with saturation (DPINT)
+//
+// Input:     x - value to convert
+//
+// Returns:   x rounded to nearest and bounded to the Int32 range
+//
+// Calls:     lrint
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+static inline int _dpint(double x)
+{
+	if(x >= 2147483647.0)
+		return 0x7FFFFFFF;
+	if(x <= -2147483648.0 || x != x)
+		return (int)0x80000000;
+	return (int)lrint(x);
+}
+
+static inline float _fabsf(float x)		{ return fabsf(x); }
+static inline double _fabs(double x)	{ return fabs(x); }
+
+// saturating 32-bit add/subtract (SADD/SSUB)
+static inline int _sadd(int a, int b)
+{
+	long long s = (long long)a + b;
+	return s > 0x7FFFFFFF ? 0x7FFFFFFF : s < -0x7FFFFFFF - 1 ? (int)0x80000000 : (int)s;
+}
+
+static inline int _ssub(int a, int b)
+{
+	long long s = (long long)a - b;
+	return s > 0x7FFFFFFF ? 0x7FFFFFFF : s < -0x7FFFFFFF - 1 ? (int)0x80000000 : (int)s;
+}
+
+// leftmost bit detect (LMBD): leading bits equal to the low bit of a
+static inline unsigned int _lmbd(unsigned int a, unsigned int b)
+{
+	b = (a & 1) ? b : ~b;
+	return b ? __builtin_clz(b) : 32;
+}
+
+#define _nassert(x)		((void)0)
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Reads the time stamp counter (TSCL)
+//
+// Input:     None
+//
+// Returns:   Low 32 bits of the host cycle counter
+//
+// Calls:     __rdtsc, or clock_gettime where there is no TSC
+//
+// Notes:     TSCL is read-only here; the DSP's "TSCL = 0" start-up
+//            write is not needed since the host counter always runs
+///////////////////////////////////////////////////////////////////////
+static inline unsigned int _host_tscl(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return (unsigned int)__rdtsc();
+#else
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (unsigned int)(t.tv_sec * 1000000000ULL + t.tv_nsec);
+#endif
+}
+
+#define TSCL	_host_tscl()
+
+#endif
@@ -0,0 +1,86 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: main.c
+//
+// Synopsis: Host main program that runs an example program over a
+//           file with no sample clock.  Per-sample programs get one
+//           Codec_ISR per input sample; frame programs (link this in
+//           place of their own main.c) also get ProcessBuffer as each
+//           frame completes, and EDMA programs are stepped a frame at
+//           a time, so no frame is ever late.
+//
+//           usage: program input.wav [output.wav]
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "DSP_Config.h"
+#include "Host_Codec.h"
+#include "Host_EDMA.h"
+#include "Host_Support_DSP.h"
+#include "FrameTimer.h"
+
+// the parts of the program present decide how it is driven
+extern void Codec_ISR() __attribute__((weak));
+extern void StartUp() __attribute__((weak));
+extern void ZeroBuffers() __attribute__((weak));
+extern void EDMA_Init() __attribute__((weak));
+extern void ProcessBuffer() __attribute__((weak));
+extern int  IsBufferReady() __attribute__((weak));
+
+static void ProcessReadyBuffers()
+{
+	if(ProcessBuffer && IsBufferReady && IsBufferReady())
+		ProcessBuffer();
+}
+
+int main(int argc, char *argv[])
+{
+	if(argc < 2 || argc > 3) {
+		fprintf(stderr, "usage: %s input.wav [output.wav]\n", argv[0]);
+		return 2;
+	}
+	if(!Codec_ISR && !EDMA_Init) {
+		fprintf(stderr, "%s: no Codec_ISR or EDMA_Init to drive\n", argv[0]);
+		return 2;
+	}
+
+	// same start-up order as the programs' own main(), but Codec_ISR
+	// and the EDMA frames are driven from the loops below
+	Host_SetInterruptMode(HOST_ISR_POLLED);
+	if(ZeroBuffers)
+		ZeroBuffers();
+	if(EDMA_Init) {
+		EDMA_Init();
+		DSP_Init_EDMA();
+	}
+	else
+		DSP_Init();
+	if(!HostCodec_Open(argv[1], argc > 2 ? argv[2] : NULL))
+		return 1;
+
+	// call StartUp for application specific code
+	if(StartUp)
+		StartUp();
+
+	if(EDMA_Init) {
+		// one frame at a time, processed before the next one moves
+		while(HostEDMA_Step()) {
+			ProcessReadyBuffers();
+			FrameTimer_Poll();
+		}
+	}
+	else {
+		// one interrupt per input sample, as fast as the host allows
+		while(HostCodec_IsDataReady()) {
+			Host_RunCodecISR();
+			ProcessReadyBuffers();
+			FrameTimer_Poll();
+		}
+	}
+
+	HostCodec_Close();
+	return 0;
+}
@@ -0,0 +1,38 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+// linker command file for OMAP-L138 DSP using EABI ELF, as
+// link6748e.cmd but with a 16 MB heap in external memory, for programs
+// whose common_code/Lib engines allocate more than 1 KB at Init
+
+-l rts6740_elf.lib
+
+-stack           0x00000400      // stack
+-heap            0x01000000      // heap, in SDRAM
+
+MEMORY
+{
+    VECTORS:     o = 0x11800000  l = 0x00000200 // accessible by DSP and ARM
+    DSPRAM:      o = 0x11800200  l = 0x0003FE00 // accessible by DSP and ARM
+    SHAREDRAM:   o = 0x80000000  l = 0x00020000
+    SDRAM:       o = 0xC0000000  l = 0x08000000 // external mDDR2
+}
+
+SECTIONS
+{
+    "vectors"	>   VECTORS
+    .neardata   >   DSPRAM
+    .rodata     >   DSPRAM
+    .bss        >   DSPRAM
+    .cinit      >   DSPRAM
+    .cio        >   DSPRAM
+    .const      >   DSPRAM
+    .stack      >   DSPRAM
+    .sysmem     >   SDRAM
+    .text       >   DSPRAM
+    .switch     >   DSPRAM
+    .far        >   DSPRAM
+    .fardata    >   DSPRAM
+	"SHARED_SRAM" >   SHAREDRAM
+	"CE0"  >   SDRAM
+}
@@ -0,0 +1,254 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Biquad.c
+//
+// Synopsis: Cascaded second order sections, see Biquad.h.  Biquad_Run
+//           passes the whole block through section 0, then through
+//           section 1 in place, and so on; each section's loop keeps
+//           its five coefficients and its state in locals.  A single
+//           sample instead goes through all the sections at once, so
+//           it is never stored between them.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include "Biquad.h"
+#include "Publish.h"
+
+// no a*b + c is fused into an FMA where the target has one (-mfma,
+// -mavx512f, -march=native): GCC fuses Biquad.c and BiquadBank.c in
+// different places, so the bank would not be bit-exact with Biquad
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+static void DF1(const float *c, float *s, const float *x, float *y, Uint32 n)
+{
+	float b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+	float x1 = s[0], x2 = s[1], y1 = s[2], y2 = s[3], x0, y0;
+	Uint32 i;
+
+	for(i = 0; i < n; i++) {
+		x0 = x[i];
+		y0 = b0*x0 + b1*x1 + b2*x2 - a1*y1 - a2*y2;
+		x2 = x1;
+		x1 = x0;
+		y2 = y1;
+		y1 = y0;
+		y[i] = y0;
+	}
+	s[0] = x1;
+	s[1] = x2;
+	s[2] = y1;
+	s[3] = y2;
+}
+
+static void DF2(const float *c, float *s, const float *x, float *y, Uint32 n)
+{
+	float b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+	float w1 = s[0], w2 = s[1], w0;
+	Uint32 i;
+
+	for(i = 0; i < n; i++) {
+		w0 = x[i] - a1*w1 - a2*w2;
+		y[i] = b0*w0 + b1*w1 + b2*w2;
+		w2 = w1;
+		w1 = w0;
+	}
+	s[0] = w1;
+	s[1] = w2;
+}
+
+static void DF2T(const float *c, float *s, const float *x, float *y, Uint32 n)
+{
+	float b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+	float s1 = s[0], s2 = s[1], x0, y0;
+	Uint32 i;
+
+	for(i = 0; i < n; i++) {
+		x0 = x[i];
+		y0 = b0*x0 + s1;
+		s1 = b1*x0 - a1*y0 + s2;
+		s2 = b2*x0 - a2*y0;
+		y[i] = y0;
+	}
+	s[0] = s1;
+	s[1] = s2;
+}
+
+// one sample through every section, the ISR case; the value passed
+// from section to section stays in a register
+static float Sample(const Biquad *f, float v)
+{
+	const float *c = f->c;
+	float *s = f->state, *end = f->state + 4 * f->sections, s0, s1, x0;
+
+	if(f->form == BIQUAD_DF2)
+		for(; s < end; s += 4, c += 5) {
+			s0 = s[0];
+			s1 = s[1];
+			x0 = v - c[3]*s0 - c[4]*s1;
+			v = c[0]*x0 + c[1]*s0 + c[2]*s1;
+			s[0] = x0;
+			s[1] = s0;
+		}
+	else if(f->form == BIQUAD_DF2T)
+		for(; s < end; s += 4, c += 5) {
+			x0 = v;
+			s1 = s[1];
+			v = c[0]*x0 + s[0];
+			s[0] = c[1]*x0 - c[3]*v + s1;
+			s[1] = c[2]*x0 - c[4]*v;
+		}
+	else
+		for(; s < end; s += 4, c += 5) {
+			x0 = v;
+			s0 = s[0];
+			s1 = s[2];
+			v = c[0]*x0 + c[1]*s0 + c[2]*s[1] - c[3]*s1 - c[4]*s[3];
+			s[0] = x0;
+			s[1] = s0;
+			s[2] = v;
+			s[3] = s1;
+		}
+	return v;
+}
+
+void Biquad_Row(float *c, const float *row, Uint32 width)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Converts one SOS row to the coefficients the filters use
+//
+// Input:     c - receives b0, b1, b2, a1, a2
+//            row - {b0, b1, b2, -a1, -a2} if width is 5,
+//                  {b0, b1, b2, a0, a1, a2} if width is 6
+//            width - 5 or 6
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     A 6-wide row is divided by its a0, unless a0 is 0
+///////////////////////////////////////////////////////////////////////
+{
+	float a0;
+
+	if(width == 5) {
+		c[0] = row[0];
+		c[1] = row[1];
+		c[2] = row[2];
+		c[3] = -row[3];
+		c[4] = -row[4];
+	}
+	else {
+		a0 = row[3] != 0 ? row[3] : 1;
+		c[0] = row[0] / a0;
+		c[1] = row[1] / a0;
+		c[2] = row[2] / a0;
+		c[3] = row[4] / a0;
+		c[4] = row[5] / a0;
+	}
+}
+
+Int32 Biquad_Init(Biquad *f, const float *sos, Uint32 sections, Uint32 width,
+	Int32 form, float gain)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up a cascade and clears its state
+//
+// Input:     f - filter
+//            sos - sections rows of width coefficients, such as B[0]
+//                  of a coeff.h from sos_dump2c.m
+//            sections - number of rows
+//            width - 5 for rows {b0, b1, b2, -a1, -a2} (sos_dump2c.m),
+//                    6 for rows {b0, b1, b2, a0, a1, a2} (MATLAB sos)
+//            form - BIQUAD_DF1, BIQUAD_DF2 or BIQUAD_DF2T
+//            gain - overall gain, 1 if it is in the rows already
+//
+// Returns:   1 on success, 0 if out of memory or an argument is bad
+//
+// Calls:     malloc, Biquad_Row, Biquad_Reset
+//
+// Notes:     The coefficients are copied, so sos may be changed or
+//            freed afterwards.  f->memory is published last
+//            (Publish.h), so an ISR that finds it non-NULL may use the
+//            filter even if Init ran in StartUp after the interrupts
+//            were enabled.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 k;
+	void *memory;
+
+	f->memory = NULL;
+	if(sections == 0 || (width != 5 && width != 6)
+		|| form < BIQUAD_DF1 || form > BIQUAD_DF2T)
+		return 0;
+	memory = malloc(sections * (5 + 4) * sizeof(float));
+	if(memory == NULL)
+		return 0;
+	f->sections = sections;
+	f->form = form;
+	f->gain = gain;
+	f->c = memory;
+	f->state = f->c + 5 * sections;
+
+	for(k = 0; k < sections; k++)
+		Biquad_Row(f->c + 5 * k, sos + k * width, width);
+
+	Biquad_Reset(f);
+	PUBLISH(f->memory, memory);
+	return 1;
+}
+
+void Biquad_Run(Biquad *f, const float *x, float *y, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters a block of one channel
+//
+// Input:     f - filter from Biquad_Init
+//            x - n new inputs
+//            y - receives the n outputs, may be x
+//            n - samples, 1 for a per-sample filter
+//
+// Returns:   Nothing
+//
+// Calls:     Sample, DF1, DF2, DF2T
+//
+// Notes:     Section k+1 filters the outputs of section k in y
+///////////////////////////////////////////////////////////////////////
+{
+	const float *in = x;
+	Uint32 k, i;
+
+	if(n == 1) {
+		y[0] = f->gain != 1 ? Sample(f, x[0]) * f->gain : Sample(f, x[0]);
+		return;
+	}
+	for(k = 0; k < f->sections; k++) {
+		if(f->form == BIQUAD_DF2)
+			DF2(f->c + 5 * k, f->state + 4 * k, in, y, n);
+		else if(f->form == BIQUAD_DF2T)
+			DF2T(f->c + 5 * k, f->state + 4 * k, in, y, n);
+		else
+			DF1(f->c + 5 * k, f->state + 4 * k, in, y, n);
+		in = y;
+	}
+	if(f->gain != 1)
+		for(i = 0; i < n; i++)
+			y[i] *= f->gain;
+}
+
+void Biquad_Reset(Biquad *f)
+{
+	Uint32 i;
+
+	for(i = 0; i < 4 * f->sections; i++)
+		f->state[i] = 0;
+}
+
+void Biquad_Close(Biquad *f)
+{
+	free(f->memory);
+	f->memory = NULL;
+}
@@ -0,0 +1,58 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Biquad.h
+//
+// Synopsis: IIR filter as a cascade of second order sections (SOS),
+//           one channel.  The coefficients are the rows of a SOS
+//           matrix, either 5 per section as sos_dump2c.m writes them,
+//           {b0, b1, b2, -a1, -a2}, or 6 as MATLAB's tf2sos and
+//           zp2sos return them, {b0, b1, b2, a0, a1, a2}.  The state
+//           of every section is kept between calls, and each call
+//           filters a whole block one section at a time so that a
+//           section's coefficients and state stay in registers:
+//
+//           #include "coeff.h"                  // float B[B_SIZE][5]
+//           Biquad_Init(&iir, B[0], B_SIZE, 5, BIQUAD_DF2, 1);
+//           Biquad_Run(&iir, &input, &output, 1);   // in Codec_ISR
+//
+//           Section k computes, for its input x and output y,
+//
+//           DF1:   y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2
+//           DF2:   w = x - a1*w1 - a2*w2,  y = b0*w + b1*w1 + b2*w2
+//           DF2T:  y = b0*x + s1,  s1 = b1*x - a1*y + s2,
+//                  s2 = b2*x - a2*y
+//
+//           in that order of operations, so a cascade of DF2 sections
+//           is bit-exact with the hand-written sections of chapters 12
+//           and 21.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	BIQUAD_H_INCLUDED
+#define BIQUAD_H_INCLUDED
+
+#include "tistdtypes.h"
+
+#define BIQUAD_DF1	0		// direct form I, 4 state values per section
+#define BIQUAD_DF2	1		// direct form II, 2 state values per section
+#define BIQUAD_DF2T	2		// transposed direct form II, 2 per section
+
+typedef struct {
+	Uint32 sections;		// second order sections in the cascade
+	Int32  form;			// BIQUAD_DF1, BIQUAD_DF2 or BIQUAD_DF2T
+	float  gain;			// applied to the output of the last section
+	float  *c;				// b0, b1, b2, a1, a2 of each section, a0 divided out
+	float  *state;			// 4 values per section, x1 x2 y1 y2 or w1 w2 (s1 s2)
+	void   *memory;			// set last by Biquad_Init, so non-NULL means ready
+} Biquad;
+
+// defined in Biquad.c
+Int32 Biquad_Init(Biquad *, const float *, Uint32, Uint32, Int32, float);
+void  Biquad_Run(Biquad *, const float *, float *, Uint32);
+void  Biquad_Reset(Biquad *);
+void  Biquad_Close(Biquad *);
+void  Biquad_Row(float *, const float *, Uint32);
+
+#endif
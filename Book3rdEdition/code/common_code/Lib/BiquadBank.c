@@ -0,0 +1,346 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: BiquadBank.c
+//
+// Synopsis: Multi-channel cascaded second order sections, see
+//           BiquadBank.h.  The loops are those of Biquad.c with each
+//           float replaced by a vector of channels, and the same
+//           order of operations, so every lane rounds as Biquad does.
+//           The portable build uses a vector of one float.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include "BiquadBank.h"
+#include "Publish.h"
+
+// no a*b + c is fused into an FMA where the target has one (-mfma,
+// -mavx512f, -march=native): GCC fuses Biquad.c and BiquadBank.c in
+// different places, so the bank would not be bit-exact with Biquad
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(BIQUADBANK_NO_SIMD)
+#define BIQUADBANK_VLEN	1
+#elif defined(__AVX512F__)
+#include <immintrin.h>
+#define BIQUADBANK_VLEN	16
+typedef __m512 BankVec;
+#define BankLoad(p)			_mm512_loadu_ps(p)
+#define BankStore(p, v)		_mm512_storeu_ps(p, v)
+#define BankAdd(a, b)		_mm512_add_ps(a, b)
+#define BankSub(a, b)		_mm512_sub_ps(a, b)
+#define BankMul(a, b)		_mm512_mul_ps(a, b)
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define BIQUADBANK_VLEN	8
+typedef __m256 BankVec;
+#define BankLoad(p)			_mm256_loadu_ps(p)
+#define BankStore(p, v)		_mm256_storeu_ps(p, v)
+#define BankAdd(a, b)		_mm256_add_ps(a, b)
+#define BankSub(a, b)		_mm256_sub_ps(a, b)
+#define BankMul(a, b)		_mm256_mul_ps(a, b)
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define BIQUADBANK_VLEN	4
+typedef __m128 BankVec;
+#define BankLoad(p)			_mm_loadu_ps(p)
+#define BankStore(p, v)		_mm_storeu_ps(p, v)
+#define BankAdd(a, b)		_mm_add_ps(a, b)
+#define BankSub(a, b)		_mm_sub_ps(a, b)
+#define BankMul(a, b)		_mm_mul_ps(a, b)
+#else
+#define BIQUADBANK_VLEN	1
+#endif
+
+#if BIQUADBANK_VLEN == 1
+typedef float BankVec;
+#define BankLoad(p)			(*(p))
+#define BankStore(p, v)		(*(p) = (v))
+#define BankAdd(a, b)		((a) + (b))
+#define BankSub(a, b)		((a) - (b))
+#define BankMul(a, b)		((a) * (b))
+#endif
+
+// one vector of channels through one section, n frames of stride floats;
+// c and s point at the vector's lanes of coefficient and state 0
+static void DF1(const float *c, float *s, Uint32 lanes, const float *x, float *y,
+	Uint32 stride, Uint32 n)
+{
+	BankVec b0 = BankLoad(c), b1 = BankLoad(c + lanes), b2 = BankLoad(c + 2 * lanes);
+	BankVec a1 = BankLoad(c + 3 * lanes), a2 = BankLoad(c + 4 * lanes);
+	BankVec x1 = BankLoad(s), x2 = BankLoad(s + lanes);
+	BankVec y1 = BankLoad(s + 2 * lanes), y2 = BankLoad(s + 3 * lanes), x0, y0;
+	Uint32 i;
+
+	for(i = 0; i < n; i++, x += stride, y += stride) {
+		x0 = BankLoad(x);
+		y0 = BankSub(BankSub(BankAdd(BankAdd(BankMul(b0, x0), BankMul(b1, x1)),
+			BankMul(b2, x2)), BankMul(a1, y1)), BankMul(a2, y2));
+		x2 = x1;
+		x1 = x0;
+		y2 = y1;
+		y1 = y0;
+		BankStore(y, y0);
+	}
+	BankStore(s, x1);
+	BankStore(s + lanes, x2);
+	BankStore(s + 2 * lanes, y1);
+	BankStore(s + 3 * lanes, y2);
+}
+
+static void DF2(const float *c, float *s, Uint32 lanes, const float *x, float *y,
+	Uint32 stride, Uint32 n)
+{
+	BankVec b0 = BankLoad(c), b1 = BankLoad(c + lanes), b2 = BankLoad(c + 2 * lanes);
+	BankVec a1 = BankLoad(c + 3 * lanes), a2 = BankLoad(c + 4 * lanes);
+	BankVec w1 = BankLoad(s), w2 = BankLoad(s + lanes), w0;
+	Uint32 i;
+
+	for(i = 0; i < n; i++, x += stride, y += stride) {
+		w0 = BankSub(BankSub(BankLoad(x), BankMul(a1, w1)), BankMul(a2, w2));
+		BankStore(y, BankAdd(BankAdd(BankMul(b0, w0), BankMul(b1, w1)), BankMul(b2, w2)));
+		w2 = w1;
+		w1 = w0;
+	}
+	BankStore(s, w1);
+	BankStore(s + lanes, w2);
+}
+
+static void DF2T(const float *c, float *s, Uint32 lanes, const float *x, float *y,
+	Uint32 stride, Uint32 n)
+{
+	BankVec b0 = BankLoad(c), b1 = BankLoad(c + lanes), b2 = BankLoad(c + 2 * lanes);
+	BankVec a1 = BankLoad(c + 3 * lanes), a2 = BankLoad(c + 4 * lanes);
+	BankVec s1 = BankLoad(s), s2 = BankLoad(s + lanes), x0, y0;
+	Uint32 i;
+
+	for(i = 0; i < n; i++, x += stride, y += stride) {
+		x0 = BankLoad(x);
+		y0 = BankAdd(BankMul(b0, x0), s1);
+		s1 = BankAdd(BankSub(BankMul(b1, x0), BankMul(a1, y0)), s2);
+		s2 = BankSub(BankMul(b2, x0), BankMul(a2, y0));
+		BankStore(y, y0);
+	}
+	BankStore(s, s1);
+	BankStore(s + lanes, s2);
+}
+
+// one frame of a vector of channels through every section, the ISR
+// case; the vector passed from section to section stays in a register
+static void Sample(BiquadBank *b, Uint32 m, const float *x, float *y)
+{
+	const float *c = b->c + m;
+	float *s = b->state + m, *end = s + 4 * b->sections * b->lanes;
+	Uint32 l = b->lanes;
+	BankVec v = BankLoad(x), s0, s1, x0;
+
+	if(b->form == BIQUAD_DF2)
+		for(; s < end; s += 4 * l, c += 5 * l) {
+			s0 = BankLoad(s);
+			s1 = BankLoad(s + l);
+			x0 = BankSub(BankSub(v, BankMul(BankLoad(c + 3 * l), s0)),
+				BankMul(BankLoad(c + 4 * l), s1));
+			v = BankAdd(BankAdd(BankMul(BankLoad(c), x0), BankMul(BankLoad(c + l), s0)),
+				BankMul(BankLoad(c + 2 * l), s1));
+			BankStore(s, x0);
+			BankStore(s + l, s0);
+		}
+	else if(b->form == BIQUAD_DF2T)
+		for(; s < end; s += 4 * l, c += 5 * l) {
+			x0 = v;
+			s1 = BankLoad(s + l);
+			v = BankAdd(BankMul(BankLoad(c), x0), BankLoad(s));
+			BankStore(s, BankAdd(BankSub(BankMul(BankLoad(c + l), x0),
+				BankMul(BankLoad(c + 3 * l), v)), s1));
+			BankStore(s + l, BankSub(BankMul(BankLoad(c + 2 * l), x0),
+				BankMul(BankLoad(c + 4 * l), v)));
+		}
+	else
+		for(; s < end; s += 4 * l, c += 5 * l) {
+			x0 = v;
+			s0 = BankLoad(s);
+			s1 = BankLoad(s + 2 * l);
+			v = BankSub(BankSub(BankAdd(BankAdd(BankMul(BankLoad(c), x0),
+				BankMul(BankLoad(c + l), s0)), BankMul(BankLoad(c + 2 * l), BankLoad(s + l))),
+				BankMul(BankLoad(c + 3 * l), s1)), BankMul(BankLoad(c + 4 * l), BankLoad(s + 3 * l)));
+			BankStore(s, x0);
+			BankStore(s + l, s0);
+			BankStore(s + 2 * l, v);
+			BankStore(s + 3 * l, s1);
+		}
+	BankStore(y, v);
+}
+
+// n frames of the vector of channels m.. through every section
+static void Cascade(BiquadBank *b, Uint32 m, const float *x, float *y, Uint32 stride,
+	Uint32 n)
+{
+	const float *c = b->c + m, *in = x;
+	float *s = b->state + m;
+	Uint32 k, l = b->lanes;
+
+	if(n == 1) {
+		Sample(b, m, x, y);
+		return;
+	}
+	for(k = 0; k < b->sections; k++, c += 5 * l, s += 4 * l, in = y) {
+		if(b->form == BIQUAD_DF2)
+			DF2(c, s, l, in, y, stride, n);
+		else if(b->form == BIQUAD_DF2T)
+			DF2T(c, s, l, in, y, stride, n);
+		else
+			DF1(c, s, l, in, y, stride, n);
+	}
+}
+
+Int32 BiquadBank_Init(BiquadBank *b, const float *sos, Uint32 sections, Uint32 width,
+	Uint32 channels, Uint32 block, Int32 form, float gain)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up a bank of cascades and clears their state
+//
+// Input:     b - bank
+//            sos - sections rows of width coefficients, given to
+//                  every channel, see Biquad_Init
+//            sections - number of rows
+//            width - 5 (sos_dump2c.m) or 6 (MATLAB sos)
+//            channels - number of channels
+//            block - most frames per BiquadBank_Run, 1 in an ISR
+//            form - BIQUAD_DF1, BIQUAD_DF2 or BIQUAD_DF2T
+//            gain - overall gain, 1 if it is in the rows already
+//
+// Returns:   1 on success, 0 if out of memory or an argument is bad
+//
+// Calls:     malloc, Biquad_Row, BiquadBank_Reset
+//
+// Notes:     b->memory is published last (Publish.h), so an ISR that
+//            finds it non-NULL may use the bank even if Init ran in
+//            StartUp after the interrupts were enabled
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 k, j, m, lanes;
+	float c[5];
+	void *memory;
+
+	b->memory = NULL;
+	if(sections == 0 || channels == 0 || block == 0 || (width != 5 && width != 6)
+		|| form < BIQUAD_DF1 || form > BIQUAD_DF2T)
+		return 0;
+	lanes = (channels + BIQUADBANK_VLEN - 1) / BIQUADBANK_VLEN * BIQUADBANK_VLEN;
+	memory = malloc((sections * (5 + 4) * lanes + block * BIQUADBANK_VLEN) * sizeof(float));
+	if(memory == NULL)
+		return 0;
+	b->channels = channels;
+	b->sections = sections;
+	b->form = form;
+	b->gain = gain;
+	b->lanes = lanes;
+	b->block = block;
+	b->c = memory;
+	b->state = b->c + 5 * sections * lanes;
+	b->part = b->state + 4 * sections * lanes;
+
+	// the padding lanes get all zero sections, so they stay 0
+	for(k = 0; k < sections; k++) {
+		Biquad_Row(c, sos + k * width, width);
+		for(j = 0; j < 5; j++)
+			for(m = 0; m < lanes; m++)
+				b->c[(5 * k + j) * lanes + m] = m < channels ? c[j] : 0;
+	}
+
+	BiquadBank_Reset(b);
+	PUBLISH(b->memory, memory);
+	return 1;
+}
+
+Int32 BiquadBank_SetChannel(BiquadBank *b, Uint32 channel, const float *sos,
+	Uint32 width)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Gives one channel its own sections
+//
+// Input:     b - bank from BiquadBank_Init
+//            channel - 0..channels-1
+//            sos - b->sections rows of width coefficients
+//            width - 5 or 6, see Biquad_Init
+//
+// Returns:   1 on success, 0 if channel or width is bad
+//
+// Calls:     Biquad_Row
+//
+// Notes:     The channel's state is kept.  Call it before the ISR
+//            runs the bank, or between its calls.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 k, j;
+	float c[5];
+
+	if(channel >= b->channels || (width != 5 && width != 6))
+		return 0;
+	for(k = 0; k < b->sections; k++) {
+		Biquad_Row(c, sos + k * width, width);
+		for(j = 0; j < 5; j++)
+			b->c[(5 * k + j) * b->lanes + channel] = c[j];
+	}
+	return 1;
+}
+
+void BiquadBank_Run(BiquadBank *b, const float *x, float *y, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters a block of frames
+//
+// Input:     b - bank from BiquadBank_Init
+//            x - n frames of b->channels inputs each
+//            y - receives the n frames of outputs, may be x
+//            n - frames, 1 for a per-sample filter
+//
+// Returns:   Nothing
+//
+// Calls:     Cascade
+//
+// Notes:     The channels of a padded last vector are copied into
+//            b->part, block frames at a time, and back out
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 m, i, j, k, full, rest, ch = b->channels;
+
+	full = ch / BIQUADBANK_VLEN * BIQUADBANK_VLEN;
+	for(m = 0; m < full; m += BIQUADBANK_VLEN)
+		Cascade(b, m, x + m, y + m, ch, n);
+
+	rest = ch - full;
+	for(i = 0; rest != 0 && i < n; i += k) {
+		k = n - i < b->block ? n - i : b->block;
+		for(j = 0; j < k; j++)
+			for(m = 0; m < rest; m++)
+				b->part[j * BIQUADBANK_VLEN + m] = x[(i + j) * ch + full + m];
+		Cascade(b, full, b->part, b->part, BIQUADBANK_VLEN, k);
+		for(j = 0; j < k; j++)
+			for(m = 0; m < rest; m++)
+				y[(i + j) * ch + full + m] = b->part[j * BIQUADBANK_VLEN + m];
+	}
+
+	if(b->gain != 1)
+		for(i = 0; i < n * ch; i++)
+			y[i] *= b->gain;
+}
+
+void BiquadBank_Reset(BiquadBank *b)
+{
+	Uint32 i;
+
+	for(i = 0; i < 4 * b->sections * b->lanes; i++)
+		b->state[i] = 0;
+	for(i = 0; i < b->block * BIQUADBANK_VLEN; i++)
+		b->part[i] = 0;
+}
+
+void BiquadBank_Close(BiquadBank *b)
+{
+	free(b->memory);
+	b->memory = NULL;
+}
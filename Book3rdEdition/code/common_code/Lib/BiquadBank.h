@@ -0,0 +1,57 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: BiquadBank.h
+//
+// Synopsis: The Biquad cascade for many channels at once.  A biquad
+//           is serial in time, one sample waits for the last, so the
+//           parallel work is across channels: each coefficient and
+//           state value is stored for all the channels side by side
+//           (structure of arrays), and one SSE, AVX or AVX-512
+//           instruction advances 4, 8 or 16 channels by a sample.
+//           The samples are frames of one value per channel, as the
+//           interleaved L/R codec words are:
+//
+//           BiquadBank_Init(&bank, SOS[0], 4, 6, 2, 1, BIQUAD_DF2, 1);
+//           frame[0] = q; frame[1] = i;          // in Codec_ISR
+//           BiquadBank_Run(&bank, frame, frame, 1);
+//
+//           Every channel starts with the same sections, and
+//           BiquadBank_SetChannel gives one channel its own.  A channel
+//           count that is not a whole number of vectors is padded, so
+//           2 channels cost one vector, not two scalar chains.  Each
+//           channel's output is bit-exact with a Biquad of the same
+//           sections, as Host/BiquadBank/biquadbank.c checks.  Build
+//           with BIQUADBANK_NO_SIMD for the portable C path.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	BIQUADBANK_H_INCLUDED
+#define BIQUADBANK_H_INCLUDED
+
+#include "tistdtypes.h"
+#include "Biquad.h"
+
+typedef struct {
+	Uint32 channels;		// filtered side by side
+	Uint32 sections;		// second order sections in each cascade
+	Int32  form;			// BIQUAD_DF1, BIQUAD_DF2 or BIQUAD_DF2T
+	float  gain;			// applied to the output of the last section
+	Uint32 lanes;			// channels rounded up to whole vectors
+	Uint32 block;			// most frames per BiquadBank_Run
+	float  *c;				// coefficient j of section k, channel m at c[(5*k+j)*lanes+m]
+	float  *state;			// state j of section k, channel m at state[(4*k+j)*lanes+m]
+	float  *part;			// block frames of the last vector, when it is padded
+	void   *memory;			// set last by BiquadBank_Init, so non-NULL means ready
+} BiquadBank;
+
+// defined in BiquadBank.c
+Int32 BiquadBank_Init(BiquadBank *, const float *, Uint32, Uint32, Uint32, Uint32,
+	Int32, float);
+Int32 BiquadBank_SetChannel(BiquadBank *, Uint32, const float *, Uint32);
+void  BiquadBank_Run(BiquadBank *, const float *, float *, Uint32);
+void  BiquadBank_Reset(BiquadBank *);
+void  BiquadBank_Close(BiquadBank *);
+
+#endif
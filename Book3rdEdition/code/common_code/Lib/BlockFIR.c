@@ -0,0 +1,382 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: BlockFIR.c
+//
+// Synopsis: Block FIR filters, see BlockFIR.h.  The vector loops keep
+//           four vectors of outputs per channel in registers while
+//           the taps are broadcast one at a time, so each input is
+//           loaded once per tap and vector, with no horizontal sums.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "BlockFIR.h"
+
+#if defined(BLOCKFIR_NO_SIMD)
+#define BLOCKFIR_VLEN	1
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define BLOCKFIR_VLEN	8
+typedef __m256 FirVec;
+#define FirZero()		_mm256_setzero_ps()
+#define FirSet(c)		_mm256_set1_ps(c)
+#define FirLoad(p)		_mm256_loadu_ps(p)
+#define FirStore(p, v)	_mm256_storeu_ps(p, v)
+#define FirMac(a, c, p)	_mm256_add_ps(a, _mm256_mul_ps(FirLoad(p), c))
+#define FirAdd(a, b)	_mm256_add_ps(a, b)
+#define FirSub(a, b)	_mm256_sub_ps(a, b)
+#define FirMul(a, b)	_mm256_mul_ps(a, b)
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define BLOCKFIR_VLEN	4
+typedef __m128 FirVec;
+#define FirZero()		_mm_setzero_ps()
+#define FirSet(c)		_mm_set1_ps(c)
+#define FirLoad(p)		_mm_loadu_ps(p)
+#define FirStore(p, v)	_mm_storeu_ps(p, v)
+#define FirMac(a, c, p)	_mm_add_ps(a, _mm_mul_ps(FirLoad(p), c))
+#define FirAdd(a, b)	_mm_add_ps(a, b)
+#define FirSub(a, b)	_mm_sub_ps(a, b)
+#define FirMul(a, b)	_mm_mul_ps(a, b)
+#else
+#define BLOCKFIR_VLEN	1
+#endif
+
+#define BLOCKFIR_BLOCK	(4 * BLOCKFIR_VLEN)	// outputs per pass over the taps
+
+static float Dot(const float *h, Uint32 taps, const float *x)
+{
+	float y = 0;
+	Uint32 j;
+
+	for(j = 0; j < taps; j++)
+		y += x[-(Int32)j] * h[j];
+	return y;
+}
+
+void BlockFIR(const float *h, Uint32 taps, const float *x, float *y, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters a block of one channel
+//
+// Input:     h - coefficients h[0..taps-1], B[] of coeff.h
+//            taps - number of coefficients, N+1
+//            x - taps-1 earlier inputs, oldest first, then the n new ones
+//            y - receives the n outputs
+//            n - outputs to compute
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     y[i] = sum of h[j] * x[i+taps-1-j].  The caller moves the
+//            last taps-1 inputs to the front of x for the next block.
+///////////////////////////////////////////////////////////////////////
+{
+	const float *p;
+	Uint32 i = 0, j;
+#if BLOCKFIR_VLEN > 1
+	FirVec c, a0, a1, a2, a3;
+
+	for(; i + BLOCKFIR_BLOCK <= n; i += BLOCKFIR_BLOCK) {
+		a0 = a1 = a2 = a3 = FirZero();
+		p = x + i + taps - 1;
+		for(j = 0; j < taps; j++, p--) {
+			c = FirSet(h[j]);
+			a0 = FirMac(a0, c, p);
+			a1 = FirMac(a1, c, p + BLOCKFIR_VLEN);
+			a2 = FirMac(a2, c, p + 2 * BLOCKFIR_VLEN);
+			a3 = FirMac(a3, c, p + 3 * BLOCKFIR_VLEN);
+		}
+		FirStore(y + i, a0);
+		FirStore(y + i + BLOCKFIR_VLEN, a1);
+		FirStore(y + i + 2 * BLOCKFIR_VLEN, a2);
+		FirStore(y + i + 3 * BLOCKFIR_VLEN, a3);
+	}
+	for(; i + BLOCKFIR_VLEN <= n; i += BLOCKFIR_VLEN) {
+		a0 = FirZero();
+		p = x + i + taps - 1;
+		for(j = 0; j < taps; j++, p--)
+			a0 = FirMac(a0, FirSet(h[j]), p);
+		FirStore(y + i, a0);
+	}
+#else
+	float c, a0, a1, a2, a3;
+
+	for(; i + 4 <= n; i += 4) {
+		a0 = a1 = a2 = a3 = 0;
+		p = x + i + taps - 1;
+		for(j = 0; j < taps; j++, p--) {
+			c = h[j];
+			a0 += p[0] * c;
+			a1 += p[1] * c;
+			a2 += p[2] * c;
+			a3 += p[3] * c;
+		}
+		y[i] = a0;
+		y[i + 1] = a1;
+		y[i + 2] = a2;
+		y[i + 3] = a3;
+	}
+#endif
+	for(; i < n; i++)
+		y[i] = Dot(h, taps, x + i + taps - 1);
+}
+
+void BlockFIR_Stereo(const float *h, Uint32 taps, const float *xl, const float *xr,
+	float *yl, float *yr, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters a block of both channels with the same filter
+//
+// Input:     h - coefficients h[0..taps-1], B[] of coeff.h
+//            taps - number of coefficients, N+1
+//            xl, xr - taps-1 earlier inputs, oldest first, then the n
+//                     new ones, of each channel
+//            yl, yr - receive the n outputs of each channel
+//            n - outputs per channel
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Each tap is loaded once for both channels.  The vector
+//            loop holds eight accumulators, which fits the 16 SSE/AVX
+//            registers of x86-64.
+///////////////////////////////////////////////////////////////////////
+{
+	const float *p, *q;
+	Uint32 i = 0, j;
+#if BLOCKFIR_VLEN > 1
+	FirVec c, l0, l1, l2, l3, r0, r1, r2, r3;
+
+	for(; i + BLOCKFIR_BLOCK <= n; i += BLOCKFIR_BLOCK) {
+		l0 = l1 = l2 = l3 = r0 = r1 = r2 = r3 = FirZero();
+		p = xl + i + taps - 1;
+		q = xr + i + taps - 1;
+		for(j = 0; j < taps; j++, p--, q--) {
+			c = FirSet(h[j]);
+			l0 = FirMac(l0, c, p);
+			l1 = FirMac(l1, c, p + BLOCKFIR_VLEN);
+			l2 = FirMac(l2, c, p + 2 * BLOCKFIR_VLEN);
+			l3 = FirMac(l3, c, p + 3 * BLOCKFIR_VLEN);
+			r0 = FirMac(r0, c, q);
+			r1 = FirMac(r1, c, q + BLOCKFIR_VLEN);
+			r2 = FirMac(r2, c, q + 2 * BLOCKFIR_VLEN);
+			r3 = FirMac(r3, c, q + 3 * BLOCKFIR_VLEN);
+		}
+		FirStore(yl + i, l0);
+		FirStore(yl + i + BLOCKFIR_VLEN, l1);
+		FirStore(yl + i + 2 * BLOCKFIR_VLEN, l2);
+		FirStore(yl + i + 3 * BLOCKFIR_VLEN, l3);
+		FirStore(yr + i, r0);
+		FirStore(yr + i + BLOCKFIR_VLEN, r1);
+		FirStore(yr + i + 2 * BLOCKFIR_VLEN, r2);
+		FirStore(yr + i + 3 * BLOCKFIR_VLEN, r3);
+	}
+	for(; i + BLOCKFIR_VLEN <= n; i += BLOCKFIR_VLEN) {
+		l0 = r0 = FirZero();
+		p = xl + i + taps - 1;
+		q = xr + i + taps - 1;
+		for(j = 0; j < taps; j++, p--, q--) {
+			c = FirSet(h[j]);
+			l0 = FirMac(l0, c, p);
+			r0 = FirMac(r0, c, q);
+		}
+		FirStore(yl + i, l0);
+		FirStore(yr + i, r0);
+	}
+#else
+	float c, l0, l1, r0, r1;
+
+	for(; i + 2 <= n; i += 2) {
+		l0 = l1 = r0 = r1 = 0;
+		p = xl + i + taps - 1;
+		q = xr + i + taps - 1;
+		for(j = 0; j < taps; j++, p--, q--) {
+			c = h[j];
+			l0 += p[0] * c;
+			l1 += p[1] * c;
+			r0 += q[0] * c;
+			r1 += q[1] * c;
+		}
+		yl[i] = l0;
+		yl[i + 1] = l1;
+		yr[i] = r0;
+		yr[i + 1] = r1;
+	}
+#endif
+	for(; i < n; i++) {
+		yl[i] = Dot(h, taps, xl + i + taps - 1);
+		yr[i] = Dot(h, taps, xr + i + taps - 1);
+	}
+}
+
+Int32 BlockFIR_Symmetry(const float *h, Uint32 taps)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Finds whether a filter has linear phase
+//
+// Input:     h - coefficients h[0..taps-1]
+//            taps - number of coefficients, N+1
+//
+// Returns:   BLOCKFIR_SYMMETRIC if h[j] == h[N-j] for all j,
+//            BLOCKFIR_ANTISYMMETRIC if h[j] == -h[N-j], else
+//            BLOCKFIR_GENERAL
+//
+// Calls:     Nothing
+//
+// Notes:     Exact comparison: fir_dump2c prints mirrored taps
+//            identically.  Always BLOCKFIR_GENERAL when built with
+//            BLOCKFIR_NO_FOLD.
+///////////////////////////////////////////////////////////////////////
+{
+#ifdef BLOCKFIR_NO_FOLD
+	return BLOCKFIR_GENERAL;
+#else
+	Uint32 j;
+	Int32 symmetric = 1, antisymmetric = 1;
+
+	for(j = 0; j < taps; j++) {
+		symmetric &= h[j] == h[taps - 1 - j];
+		antisymmetric &= h[j] == -h[taps - 1 - j];
+	}
+	if(symmetric)
+		return BLOCKFIR_SYMMETRIC;
+	return antisymmetric ? BLOCKFIR_ANTISYMMETRIC : BLOCKFIR_GENERAL;
+#endif
+}
+
+static float FoldedDot(const float *h, Uint32 taps, Int32 symmetry, const float *x)
+{
+	float y = 0;
+	Uint32 j, half = taps / 2;
+
+	if(symmetry > 0)
+		for(j = 0; j < half; j++)
+			y += (x[taps - 1 - j] + x[j]) * h[j];
+	else
+		for(j = 0; j < half; j++)
+			y += (x[taps - 1 - j] - x[j]) * h[j];
+	if(taps & 1)
+		y += x[half] * h[half];
+	return y;
+}
+
+void BlockFIR_Folded(const float *h, Uint32 taps, Int32 symmetry, const float *x,
+	float *y, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters a block of one channel with a linear phase filter
+//
+// Input:     h - coefficients h[0..taps-1]
+//            taps - number of coefficients, N+1
+//            symmetry - from BlockFIR_Symmetry; BLOCKFIR_GENERAL runs
+//                       BlockFIR
+//            x - taps-1 earlier inputs, oldest first, then the n new ones
+//            y - receives the n outputs
+//            n - outputs to compute, 1 for a per-sample filter
+//
+// Returns:   Nothing
+//
+// Calls:     BlockFIR
+//
+// Notes:     The inputs that share a coefficient are added (or
+//            subtracted) first, so each output takes (N+1)/2
+//            multiplies.  The sums differ from BlockFIR's by float
+//            rounding only.
+///////////////////////////////////////////////////////////////////////
+{
+	const float *p, *q;
+	Uint32 i = 0, j, half = taps / 2;
+#if BLOCKFIR_VLEN > 1
+	FirVec c, a0, a1, a2, a3;
+#endif
+
+	if(symmetry == BLOCKFIR_GENERAL) {
+		BlockFIR(h, taps, x, y, n);
+		return;
+	}
+#if BLOCKFIR_VLEN > 1
+	// p runs back from the newest input of each output, q forward from its oldest
+	for(; i + BLOCKFIR_BLOCK <= n; i += BLOCKFIR_BLOCK) {
+		a0 = a1 = a2 = a3 = FirZero();
+		p = x + i + taps - 1;
+		q = x + i;
+		if(symmetry > 0)
+			for(j = 0; j < half; j++, p--, q++) {
+				c = FirSet(h[j]);
+				a0 = FirAdd(a0, FirMul(FirAdd(FirLoad(p), FirLoad(q)), c));
+				a1 = FirAdd(a1, FirMul(FirAdd(FirLoad(p + BLOCKFIR_VLEN), FirLoad(q + BLOCKFIR_VLEN)), c));
+				a2 = FirAdd(a2, FirMul(FirAdd(FirLoad(p + 2 * BLOCKFIR_VLEN), FirLoad(q + 2 * BLOCKFIR_VLEN)), c));
+				a3 = FirAdd(a3, FirMul(FirAdd(FirLoad(p + 3 * BLOCKFIR_VLEN), FirLoad(q + 3 * BLOCKFIR_VLEN)), c));
+			}
+		else
+			for(j = 0; j < half; j++, p--, q++) {
+				c = FirSet(h[j]);
+				a0 = FirAdd(a0, FirMul(FirSub(FirLoad(p), FirLoad(q)), c));
+				a1 = FirAdd(a1, FirMul(FirSub(FirLoad(p + BLOCKFIR_VLEN), FirLoad(q + BLOCKFIR_VLEN)), c));
+				a2 = FirAdd(a2, FirMul(FirSub(FirLoad(p + 2 * BLOCKFIR_VLEN), FirLoad(q + 2 * BLOCKFIR_VLEN)), c));
+				a3 = FirAdd(a3, FirMul(FirSub(FirLoad(p + 3 * BLOCKFIR_VLEN), FirLoad(q + 3 * BLOCKFIR_VLEN)), c));
+			}
+		if(taps & 1) {
+			c = FirSet(h[half]);
+			a0 = FirMac(a0, c, q);
+			a1 = FirMac(a1, c, q + BLOCKFIR_VLEN);
+			a2 = FirMac(a2, c, q + 2 * BLOCKFIR_VLEN);
+			a3 = FirMac(a3, c, q + 3 * BLOCKFIR_VLEN);
+		}
+		FirStore(y + i, a0);
+		FirStore(y + i + BLOCKFIR_VLEN, a1);
+		FirStore(y + i + 2 * BLOCKFIR_VLEN, a2);
+		FirStore(y + i + 3 * BLOCKFIR_VLEN, a3);
+	}
+	for(; i + BLOCKFIR_VLEN <= n; i += BLOCKFIR_VLEN) {
+		a0 = FirZero();
+		p = x + i + taps - 1;
+		q = x + i;
+		for(j = 0; j < half; j++, p--, q++) {
+			c = FirSet(h[j]);
+			a0 = FirAdd(a0, FirMul(symmetry > 0 ? FirAdd(FirLoad(p), FirLoad(q))
+				: FirSub(FirLoad(p), FirLoad(q)), c));
+		}
+		if(taps & 1)
+			a0 = FirMac(a0, FirSet(h[half]), q);
+		FirStore(y + i, a0);
+	}
+#else
+	float c, a0, a1, a2, a3;
+
+	for(; i + 4 <= n; i += 4) {
+		a0 = a1 = a2 = a3 = 0;
+		p = x + i + taps - 1;
+		q = x + i;
+		if(symmetry > 0)
+			for(j = 0; j < half; j++, p--, q++) {
+				c = h[j];
+				a0 += (p[0] + q[0]) * c;
+				a1 += (p[1] + q[1]) * c;
+				a2 += (p[2] + q[2]) * c;
+				a3 += (p[3] + q[3]) * c;
+			}
+		else
+			for(j = 0; j < half; j++, p--, q++) {
+				c = h[j];
+				a0 += (p[0] - q[0]) * c;
+				a1 += (p[1] - q[1]) * c;
+				a2 += (p[2] - q[2]) * c;
+				a3 += (p[3] - q[3]) * c;
+			}
+		if(taps & 1) {
+			c = h[half];
+			a0 += q[0] * c;
+			a1 += q[1] * c;
+			a2 += q[2] * c;
+			a3 += q[3] * c;
+		}
+		y[i] = a0;
+		y[i + 1] = a1;
+		y[i + 2] = a2;
+		y[i + 3] = a3;
+	}
+#endif
+	for(; i < n; i++)
+		y[i] = FoldedDot(h, taps, symmetry, x + i);
+}
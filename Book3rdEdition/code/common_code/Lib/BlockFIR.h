@@ -0,0 +1,43 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: BlockFIR.h
+//
+// Synopsis: Block FIR filter for the frame programs.  Several outputs
+//           are computed per pass over the coefficients, each in its
+//           own accumulator (register blocking), with SSE or AVX
+//           vectors on the host.  Every output is summed in the same
+//           order as the scalar loop
+//
+//               for(j = 0; j <= N; j++) y += x[k-j] * B[j];
+//
+//           so the results are bit-exact with it.  Build with
+//           BLOCKFIR_NO_SIMD for the portable C path.
+//
+//           Most fir_dump2c designs have linear phase, B[j] == B[N-j]
+//           (or -B[N-j] for Hilbert transformers and differentiators).
+//           BlockFIR_Symmetry finds this once when a filter is loaded
+//           and BlockFIR_Folded then adds the two inputs that share a
+//           coefficient before the multiply, halving the multiplies.
+//           Build with BLOCKFIR_NO_FOLD to keep the unfolded sums.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	BLOCKFIR_H_INCLUDED
+#define BLOCKFIR_H_INCLUDED
+
+#include "tistdtypes.h"
+
+// coefficient symmetry, from BlockFIR_Symmetry
+#define BLOCKFIR_GENERAL		0
+#define BLOCKFIR_SYMMETRIC		1	// h[j] ==  h[N-j]
+#define BLOCKFIR_ANTISYMMETRIC	(-1)	// h[j] == -h[N-j]
+
+// defined in BlockFIR.c
+void BlockFIR(const float *, Uint32, const float *, float *, Uint32);
+void BlockFIR_Stereo(const float *, Uint32, const float *, const float *, float *, float *, Uint32);
+Int32 BlockFIR_Symmetry(const float *, Uint32);
+void BlockFIR_Folded(const float *, Uint32, Int32, const float *, float *, Uint32);
+
+#endif
@@ -0,0 +1,419 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: BlockIIR.c
+//
+// Synopsis: Block state-space IIR filter, see BlockIIR.h.  The block
+//           matrices are not formed algebraically: Init runs the DF2T
+//           recursion itself, in double, from an impulse and from each
+//           unit state, and records the outputs and final states.  Each
+//           vector of outputs is summed in registers over the inputs
+//           that reach it, the last of which reach only part of the
+//           vector, so h carries a vector's worth of leading zeros.
+//
+//           The state stays in double between blocks.  Phi of a direct
+//           form with clustered poles has entries in the hundreds for a
+//           short block, and a float state rounded at every block
+//           boundary and multiplied by it cost 50 dB of SNR on the 4th
+//           order lowpass of HW03.4 at L = 32; the p*p products are few
+//           enough to do in double.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include "BlockIIR.h"
+#include "Publish.h"
+#include "Biquad.h"
+
+#if defined(BLOCKIIR_NO_SIMD)
+#define BLOCKIIR_VLEN	1
+#elif defined(__AVX512F__)
+#include <immintrin.h>
+#define BLOCKIIR_VLEN	16
+typedef __m512 BlockVec;
+#define BlockLoad(p)		_mm512_loadu_ps(p)
+#define BlockStore(p, v)	_mm512_storeu_ps(p, v)
+#define BlockAdd(a, b)		_mm512_add_ps(a, b)
+#define BlockMul(a, b)		_mm512_mul_ps(a, b)
+#define BlockSet(a)			_mm512_set1_ps(a)
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define BLOCKIIR_VLEN	8
+typedef __m256 BlockVec;
+#define BlockLoad(p)		_mm256_loadu_ps(p)
+#define BlockStore(p, v)	_mm256_storeu_ps(p, v)
+#define BlockAdd(a, b)		_mm256_add_ps(a, b)
+#define BlockMul(a, b)		_mm256_mul_ps(a, b)
+#define BlockSet(a)			_mm256_set1_ps(a)
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define BLOCKIIR_VLEN	4
+typedef __m128 BlockVec;
+#define BlockLoad(p)		_mm_loadu_ps(p)
+#define BlockStore(p, v)	_mm_storeu_ps(p, v)
+#define BlockAdd(a, b)		_mm_add_ps(a, b)
+#define BlockMul(a, b)		_mm_mul_ps(a, b)
+#define BlockSet(a)			_mm_set1_ps(a)
+#else
+#define BLOCKIIR_VLEN	1
+#endif
+
+#if BLOCKIIR_VLEN == 1
+typedef float BlockVec;
+#define BlockLoad(p)		(*(p))
+#define BlockStore(p, v)	(*(p) = (v))
+#define BlockAdd(a, b)		((a) + (b))
+#define BlockMul(a, b)		((a) * (b))
+#define BlockSet(a)			(a)
+#endif
+
+// one sample through the DF2T cascade, in double, for Init
+static double StepDouble(const BlockIIR *f, double *s, double v)
+{
+	const float *b, *a;
+	Uint32 q = f->order, k, j;
+	double x0;
+
+	for(k = 0; k < f->sections; k++, s += q) {
+		b = f->c + k * (2 * q + 1);
+		a = b + q;
+		x0 = v;
+		v = b[0]*x0 + s[0];
+		for(j = 1; j < q; j++)
+			s[j-1] = b[j]*x0 - a[j]*v + s[j];
+		s[q-1] = b[q]*x0 - a[q]*v;
+	}
+	return v;
+}
+
+// the same recursion in float, for blocks shorter than L; with 2nd
+// order sections it is Biquad's DF2T, and the state it leaves is float
+// values however it was held before
+static void Scalar(BlockIIR *f, const float *x, float *y, Uint32 n)
+{
+	const float *b, *a;
+	double *s;
+	float x0, v;
+	Uint32 q = f->order, i, k, j;
+
+	for(i = 0; i < n; i++) {
+		v = x[i];
+		for(k = 0, s = f->state; k < f->sections; k++, s += q) {
+			b = f->c + k * (2 * q + 1);
+			a = b + q;
+			x0 = v;
+			v = b[0]*x0 + (float)s[0];
+			for(j = 1; j < q; j++)
+				s[j-1] = b[j]*x0 - a[j]*v + (float)s[j];
+			s[q-1] = b[q]*x0 - a[q]*v;
+		}
+		y[i] = v * f->gain;
+	}
+}
+
+static float Dot(const float *u, const float *v, Uint32 n)
+{
+	float part[BLOCKIIR_VLEN], sum = 0;
+	BlockVec acc = BlockSet(0);
+	Uint32 i;
+
+	for(i = 0; i < n; i += BLOCKIIR_VLEN)
+		acc = BlockAdd(acc, BlockMul(BlockLoad(u + i), BlockLoad(v + i)));
+	BlockStore(part, acc);
+	for(i = 0; i < BLOCKIIR_VLEN; i++)
+		sum += part[i];
+	return sum;
+}
+
+// one block of L samples through the matrices
+static void Block(BlockIIR *f, const float *x, float *y)
+{
+	Uint32 L = f->block, p = f->states, i, j, k, m;
+	double *s = f->state, acc;
+	float *in = f->in;
+	BlockVec y0, y1;
+
+	for(i = 0; i < L; i++)
+		in[i] = x[i];
+
+	for(m = 0; m < p; m++) {
+		acc = Dot(f->R + m * L, in, L);
+		for(k = 0; k < p; k++)
+			acc += f->Phi[m * p + k] * s[k];
+		f->next[m] = acc;
+	}
+
+	// two sums, so that one need not wait for the other's adds
+	for(i = 0; i < L; i += BLOCKIIR_VLEN) {
+		y0 = BlockSet(0);
+		y1 = BlockSet(0);
+		for(k = 0; k < p; k++)
+			y0 = BlockAdd(y0, BlockMul(BlockLoad(f->O + k * L + i), BlockSet((float)s[k])));
+		for(j = 0; j + 1 < i + BLOCKIIR_VLEN; j += 2) {
+			y0 = BlockAdd(y0, BlockMul(BlockLoad(f->h + i - j), BlockSet(in[j])));
+			y1 = BlockAdd(y1, BlockMul(BlockLoad(f->h + i - j - 1), BlockSet(in[j+1])));
+		}
+		if(j < i + BLOCKIIR_VLEN)
+			y0 = BlockAdd(y0, BlockMul(BlockLoad(f->h + i - j), BlockSet(in[j])));
+		BlockStore(y + i, BlockAdd(y0, y1));
+	}
+
+	for(m = 0; m < p; m++)
+		s[m] = f->next[m];
+}
+
+// allocates the arrays once the coefficients' size is known; returns
+// the memory, or NULL
+static void *Alloc(BlockIIR *f, Uint32 sections, Uint32 order, float gain,
+	Uint32 block)
+{
+	Uint32 L, p = sections * order, pad = BLOCKIIR_VLEN - 1;
+	double *memory;
+
+	L = (block + BLOCKIIR_VLEN - 1) / BLOCKIIR_VLEN * BLOCKIIR_VLEN;
+	memory = malloc((2 * p + p * p) * sizeof(double)
+		+ (sections * (2 * order + 1) + L + pad + L + 2 * p * L) * sizeof(float));
+	if(memory == NULL)
+		return NULL;
+	f->sections = sections;
+	f->order = order;
+	f->states = p;
+	f->block = L;
+	f->gain = gain;
+	f->state = memory;
+	f->next = f->state + p;
+	f->Phi = f->next + p;
+	f->c = (float *)(f->Phi + p * p);
+	f->in = f->c + sections * (2 * order + 1);
+	f->h = f->in + L + pad;
+	f->O = f->h + L;
+	f->R = f->O + p * L;
+	return memory;
+}
+
+// fills h, O, Phi and R from the coefficients; returns 0 if out of
+// memory
+static Int32 Matrices(BlockIIR *f)
+{
+	Uint32 L = f->block, p = f->states, n, k, m;
+	double *s;
+
+	s = malloc(p * sizeof(double));
+	if(s == NULL)
+		return 0;
+	for(n = 1; n < BLOCKIIR_VLEN; n++)
+		f->h[-(Int32)n] = 0;
+
+	// impulse response, and the state after L-n steps of it is the
+	// state input n leaves at the end of the block
+	for(m = 0; m < p; m++)
+		s[m] = 0;
+	for(n = 0; n < L; n++) {
+		f->h[n] = StepDouble(f, s, n == 0) * f->gain;
+		for(m = 0; m < p; m++)
+			f->R[m * L + L - 1 - n] = s[m];
+	}
+
+	// response to, and state after a block from, each unit state
+	for(k = 0; k < p; k++) {
+		for(m = 0; m < p; m++)
+			s[m] = m == k;
+		for(n = 0; n < L; n++)
+			f->O[k * L + n] = StepDouble(f, s, 0) * f->gain;
+		for(m = 0; m < p; m++)
+			f->Phi[m * p + k] = s[m];
+	}
+
+	free(s);
+	return 1;
+}
+
+Int32 BlockIIR_InitSOS(BlockIIR *f, const float *sos, Uint32 sections, Uint32 width,
+	float gain, Uint32 block)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up a block filter from second order sections
+//
+// Input:     f - filter
+//            sos - sections rows of width coefficients, as for
+//                  Biquad_Init
+//            sections - number of rows
+//            width - 5 for rows {b0, b1, b2, -a1, -a2} (sos_dump2c.m),
+//                    6 for rows {b0, b1, b2, a0, a1, a2} (MATLAB sos)
+//            gain - overall gain, 1 if it is in the rows already
+//            block - samples per block, rounded up to whole vectors
+//
+// Returns:   1 on success, 0 if out of memory or an argument is bad
+//
+// Calls:     malloc, Biquad_Row, BlockIIR_Reset
+//
+// Notes:     A block costs about (block/2 + 2*order) products per
+//            sample, with order 2*sections, against 5*sections for
+//            the recursion; a block of 32 to 64 suits an 8th order
+//            filter
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 k;
+	void *memory;
+
+	f->memory = NULL;
+	if(sections == 0 || block == 0 || (width != 5 && width != 6))
+		return 0;
+	memory = Alloc(f, sections, 2, gain, block);
+	if(memory == NULL)
+		return 0;
+
+	for(k = 0; k < sections; k++)
+		Biquad_Row(f->c + 5 * k, sos + k * width, width);
+
+	if(!Matrices(f)) {
+		free(memory);
+		return 0;
+	}
+	BlockIIR_Reset(f);
+	PUBLISH(f->memory, memory);
+	return 1;
+}
+
+Int32 BlockIIR_InitTF(BlockIIR *f, const float *b, const float *a, Uint32 order,
+	Uint32 block)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up a block filter from one transfer function
+//
+// Input:     f - filter
+//            b - order+1 numerator coefficients, such as the B of an
+//                IIR_dump2C.m header
+//            a - order+1 denominator coefficients, a[0] is divided out
+//            order - of the filter, 1 or more
+//            block - samples per block, rounded up to whole vectors
+//
+// Returns:   1 on success, 0 if out of memory or an argument is bad
+//
+// Calls:     malloc, BlockIIR_Reset
+//
+// Notes:     The filter is a single DF2T section of the whole order.
+//            A high order direct form is as sensitive here as in the
+//            sample-by-sample loop, so factor it into sections when
+//            BlockIIR_Check reports a poor SNR.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 j;
+	float a0;
+	void *memory;
+
+	f->memory = NULL;
+	if(order == 0 || block == 0 || a[0] == 0)
+		return 0;
+	memory = Alloc(f, 1, order, 1, block);
+	if(memory == NULL)
+		return 0;
+
+	a0 = a[0];
+	for(j = 0; j <= order; j++)
+		f->c[j] = b[j] / a0;
+	for(j = 1; j <= order; j++)
+		f->c[order + j] = a[j] / a0;
+
+	if(!Matrices(f)) {
+		free(memory);
+		return 0;
+	}
+	BlockIIR_Reset(f);
+	PUBLISH(f->memory, memory);
+	return 1;
+}
+
+void BlockIIR_Run(BlockIIR *f, const float *x, float *y, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters n samples of one channel
+//
+// Input:     f - filter from BlockIIR_InitSOS or BlockIIR_InitTF
+//            x - n new inputs
+//            y - receives the n outputs, may be x
+//            n - samples, any number
+//
+// Returns:   Nothing
+//
+// Calls:     Block, Scalar
+//
+// Notes:     Whole blocks of f->block samples go through the matrices
+//            and the rest through the recursion, so a caller that
+//            passes multiples of f->block never runs the slow path
+///////////////////////////////////////////////////////////////////////
+{
+	for(; n >= f->block; n -= f->block, x += f->block, y += f->block)
+		Block(f, x, y);
+	if(n > 0)
+		Scalar(f, x, y, n);
+}
+
+void BlockIIR_Reset(BlockIIR *f)
+{
+	Uint32 m;
+
+	for(m = 0; m < f->states; m++)
+		f->state[m] = 0;
+}
+
+void BlockIIR_Close(BlockIIR *f)
+{
+	free(f->memory);
+	f->memory = NULL;
+}
+
+static void RunBlocks(void *f, const float *in, float *out, Uint32 n)
+{
+	BlockIIR_Run(f, in, out, n);
+}
+
+// the reference: the recursion in double, from the same coefficients
+static void RunDouble(void *filter, const float *in, float *out, Uint32 n)
+{
+	BlockIIR *f = filter;
+	Uint32 i;
+
+	for(i = 0; i < n; i++)
+		out[i] = StepDouble(f, f->state, in[i]) * f->gain;
+}
+
+Int32 BlockIIR_Check(BlockIIR *f, Golden *g, Uint32 samples, Uint32 seed)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Compares the block filter with its own sample-by-sample
+//            recursion, evaluated in double
+//
+// Input:     f - filter from BlockIIR_InitSOS or BlockIIR_InitTF
+//            g - comparison from Golden_Init, normally GOLDEN_SNR
+//            samples - length of the random test stream
+//            seed - of the stream
+//
+// Returns:   1 if the block outputs are within g's tolerance, 0 if not
+//            or out of memory
+//
+// Calls:     malloc, Golden_RunKernels, Golden_Passed, BlockIIR_Reset
+//
+// Notes:     The stream comes in blocks of random length, so partial
+//            blocks and the hand-over of the state between the block
+//            and float recursion paths are tested too.  The float
+//            recursion alone can be the worse of the two: 105 dB
+//            against 111 dB in 64-sample blocks for the 8th order SOS
+//            of DFII8th, 63 dB against 69 dB for the 4th order direct
+//            form of HW03.4 (Host/BlockIIR/blockiir.c).
+//            f is reset before and after.
+///////////////////////////////////////////////////////////////////////
+{
+	BlockIIR ref = *f;
+	Uint32 m;
+
+	ref.state = malloc(f->states * sizeof(double));
+	if(ref.state == NULL)
+		return 0;
+	for(m = 0; m < f->states; m++)
+		ref.state[m] = 0;
+	BlockIIR_Reset(f);
+
+	Golden_RunKernels(g, RunDouble, &ref, RunBlocks, f, samples, 0, seed);
+
+	free(ref.state);
+	BlockIIR_Reset(f);
+	return Golden_Passed(g);
+}
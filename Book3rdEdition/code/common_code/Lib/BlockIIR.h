@@ -0,0 +1,67 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: BlockIIR.h
+//
+// Synopsis: One channel of IIR filter evaluated a block at a time in
+//           state-space form, for long recordings through a high order
+//           filter where there are no other channels to run side by
+//           side.  The filter is a cascade of transposed direct form II
+//           sections, from SOS rows or from one transfer function, and
+//           its state s is every section's delay values.  For a block
+//           of L inputs x, Init has worked out (in double) the matrices
+//           that give
+//
+//           y = O s + H x,        s' = Phi s + R x
+//
+//           O being the response to each state value, H the Toeplitz
+//           matrix of the impulse response, Phi = A^L and R the state
+//           left by each input.  Every output of a block is then a sum
+//           of products, with no sample waiting for the one before it,
+//           and the sums vectorize along time.  A block shorter than L
+//           runs the recursion sample by sample on the same state:
+//
+//           BlockIIR_InitSOS(&iir, tmp[0], tmp_SECTIONS, 6, 1, 64);
+//           BlockIIR_Run(&iir, x, y, n);           // any n
+//
+//           The block outputs round differently from the recursion, so
+//           they are not bit-exact with it; BlockIIR_Check measures
+//           their error on a stream of random blocks against the
+//           recursion run in double.  Build with BLOCKIIR_NO_SIMD for
+//           the portable C loops, which are slower than the recursion.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	BLOCKIIR_H_INCLUDED
+#define BLOCKIIR_H_INCLUDED
+
+#include "tistdtypes.h"
+#include "Golden.h"
+
+typedef struct {
+	Uint32 sections;		// DF2T sections in the cascade
+	Uint32 order;			// of each section, 2 for SOS rows
+	Uint32 states;			// sections*order values in s
+	Uint32 block;			// L, a whole number of vectors
+	float  gain;			// applied to the output of the last section
+	double *state;			// s, section k's values at state[k*order]
+	double *next;			// s' while a block is computed
+	double *Phi;			// state m from state value k at Phi[m*states+k]
+	float  *c;				// b0..b[order], a1..a[order] of each section
+	float  *h;				// L impulse response values, with zeros before h[0]
+	float  *O;				// output n from state value k at O[k*L+n]
+	float  *R;				// state m from input n at R[m*L+n]
+	float  *in;				// copy of the block, so y may be x
+	void   *memory;			// set last by BlockIIR_Init*, so non-NULL means ready
+} BlockIIR;
+
+// defined in BlockIIR.c
+Int32 BlockIIR_InitSOS(BlockIIR *, const float *, Uint32, Uint32, float, Uint32);
+Int32 BlockIIR_InitTF(BlockIIR *, const float *, const float *, Uint32, Uint32);
+void  BlockIIR_Run(BlockIIR *, const float *, float *, Uint32);
+void  BlockIIR_Reset(BlockIIR *);
+void  BlockIIR_Close(BlockIIR *);
+Int32 BlockIIR_Check(BlockIIR *, Golden *, Uint32, Uint32);
+
+#endif
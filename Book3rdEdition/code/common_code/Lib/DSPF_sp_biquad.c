@@ -0,0 +1,226 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: DSPF_sp_biquad.c
+//
+// Synopsis: DSPF_sp_biquad for the host, see DSPF_sp_biquad.h.  The
+//           recursion is serial in time, so the SIMD path looks ahead:
+//           a vector of V outputs is the section's response to the two
+//           delays plus its impulse response convolved with the V
+//           inputs, both worked out (in double) at the start of the
+//           call.  The delays for the next vector then follow exactly
+//           from its last two inputs and outputs, as the recursion
+//           would leave them, so no rounding is carried from vector to
+//           vector.  Calls shorter than 4 vectors, and the samples left
+//           over, run the natural C loop of TI's DSPF_sp_biquad_cn.
+//           Build with DSPF_BIQUAD_NO_SIMD for that loop alone.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include "DSPF_sp_biquad.h"
+#include "Golden.h"
+
+#if defined(DSPF_BIQUAD_NO_SIMD)
+#define DSPF_BIQUAD_VLEN	1
+#elif defined(__AVX512F__)
+#include <immintrin.h>
+#define DSPF_BIQUAD_VLEN	16
+typedef __m512 BiquadVec;
+#define BiquadLoad(p)		_mm512_loadu_ps(p)
+#define BiquadStore(p, v)	_mm512_storeu_ps(p, v)
+#define BiquadAdd(a, b)		_mm512_add_ps(a, b)
+#define BiquadMul(a, b)		_mm512_mul_ps(a, b)
+#define BiquadSet(a)		_mm512_set1_ps(a)
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define DSPF_BIQUAD_VLEN	8
+typedef __m256 BiquadVec;
+#define BiquadLoad(p)		_mm256_loadu_ps(p)
+#define BiquadStore(p, v)	_mm256_storeu_ps(p, v)
+#define BiquadAdd(a, b)		_mm256_add_ps(a, b)
+#define BiquadMul(a, b)		_mm256_mul_ps(a, b)
+#define BiquadSet(a)		_mm256_set1_ps(a)
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define DSPF_BIQUAD_VLEN	4
+typedef __m128 BiquadVec;
+#define BiquadLoad(p)		_mm_loadu_ps(p)
+#define BiquadStore(p, v)	_mm_storeu_ps(p, v)
+#define BiquadAdd(a, b)		_mm_add_ps(a, b)
+#define BiquadMul(a, b)		_mm_mul_ps(a, b)
+#define BiquadSet(a)		_mm_set1_ps(a)
+#else
+#define DSPF_BIQUAD_VLEN	1
+#endif
+
+#define DSPF_BIQUAD_CHECK_SECTIONS	8	// random sections DSPF_sp_biquad_Check tries
+
+// TI's natural C version, the reference
+static void Natural(const float *x, const float *b, const float *a, float *delay,
+	float *y, int nx)
+{
+	float a1 = a[1], a2 = a[2], b0 = b[0], b1 = b[1], b2 = b[2];
+	float d0 = delay[0], d1 = delay[1], x_i;
+	int i;
+
+	for(i = 0; i < nx; i++) {
+		x_i = x[i];
+		y[i] = b0 * x_i + d0;
+		d0 = b1 * x_i - a1 * y[i] + d1;
+		d1 = b2 * x_i - a2 * y[i];
+	}
+	delay[0] = d0;
+	delay[1] = d1;
+}
+
+#if DSPF_BIQUAD_VLEN > 1
+// the first V samples of the response to a unit input (h, after V-1
+// zeros) and to each unit delay (o0, o1) with no input
+static void Responses(const float *b, const float *a, float *h, float *o0, float *o1)
+{
+	double d[3][2] = {{0, 0}, {1, 0}, {0, 1}}, x0, v;
+	float *out[3];
+	Int32 n, k;
+
+	out[0] = h + DSPF_BIQUAD_VLEN - 1;
+	out[1] = o0;
+	out[2] = o1;
+	for(n = 0; n < DSPF_BIQUAD_VLEN - 1; n++)
+		h[n] = 0;
+	for(k = 0; k < 3; k++)
+		for(n = 0; n < DSPF_BIQUAD_VLEN; n++) {
+			x0 = k == 0 && n == 0;
+			v = b[0] * x0 + d[k][0];
+			d[k][0] = b[1] * x0 - a[1] * v + d[k][1];
+			d[k][1] = b[2] * x0 - a[2] * v;
+			out[k][n] = (float)v;
+		}
+}
+#endif
+
+void DSPF_sp_biquad(float *restrict x, float *b, float *a, float *delay,
+	float *restrict y, const int nx)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters nx samples through one DF2T biquad
+//
+// Input:     x - nx inputs
+//            b - b0, b1, b2
+//            a - a0 (not read), a1, a2
+//            delay - the section's two delays, updated
+//            y - receives the nx outputs
+//            nx - samples, 2 or more for TI's version (any here)
+//
+// Returns:   Nothing
+//
+// Calls:     Responses, Natural
+//
+// Notes:     Outputs of the SIMD path differ from the natural C loop
+//            only by rounding; DSPF_sp_biquad_Check measures how much.
+///////////////////////////////////////////////////////////////////////
+{
+	Int32 i = 0;
+#if DSPF_BIQUAD_VLEN > 1
+	float h[2 * DSPF_BIQUAD_VLEN - 1], o0[DSPF_BIQUAD_VLEN], o1[DSPF_BIQUAD_VLEN];
+	float *hz = h + DSPF_BIQUAD_VLEN - 1, d0, d1, x1, x2, y1, y2;
+	BiquadVec acc0, acc1, ov0, ov1;
+	Int32 j;
+
+	if(nx >= 4 * DSPF_BIQUAD_VLEN) {
+		Responses(b, a, h, o0, o1);
+		ov0 = BiquadLoad(o0);
+		ov1 = BiquadLoad(o1);
+		d0 = delay[0];
+		d1 = delay[1];
+		for(; i + DSPF_BIQUAD_VLEN <= nx; i += DSPF_BIQUAD_VLEN) {
+			acc0 = BiquadMul(ov0, BiquadSet(d0));
+			acc1 = BiquadMul(ov1, BiquadSet(d1));
+			for(j = 0; j < DSPF_BIQUAD_VLEN; j += 2) {
+				acc0 = BiquadAdd(acc0, BiquadMul(BiquadLoad(hz - j), BiquadSet(x[i+j])));
+				acc1 = BiquadAdd(acc1, BiquadMul(BiquadLoad(hz - j - 1), BiquadSet(x[i+j+1])));
+			}
+			x1 = x[i + DSPF_BIQUAD_VLEN - 1];
+			x2 = x[i + DSPF_BIQUAD_VLEN - 2];
+			BiquadStore(y + i, BiquadAdd(acc0, acc1));
+
+			// the delays the recursion leaves after the last two samples
+			y1 = y[i + DSPF_BIQUAD_VLEN - 1];
+			y2 = y[i + DSPF_BIQUAD_VLEN - 2];
+			d0 = b[1] * x1 - a[1] * y1 + (b[2] * x2 - a[2] * y2);
+			d1 = b[2] * x1 - a[2] * y1;
+		}
+		delay[0] = d0;
+		delay[1] = d1;
+	}
+#endif
+	Natural(x + i, b, a, delay, y + i, nx - i);
+}
+
+// one section and its delays, as a Golden kernel's state
+typedef struct {
+	float b[3], a[3], delay[2];
+} Section;
+
+static void RunNatural(void *state, const float *in, float *out, Uint32 n)
+{
+	Section *s = state;
+
+	Natural(in, s->b, s->a, s->delay, out, n);
+}
+
+static void RunHost(void *state, const float *in, float *out, Uint32 n)
+{
+	Section *s = state;
+
+	DSPF_sp_biquad((float *)in, s->b, s->a, s->delay, out, n);
+}
+
+Int32 DSPF_sp_biquad_Check(Golden *g, Uint32 samples, Uint32 seed)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Conformance check of DSPF_sp_biquad against TI's natural
+//            C version
+//
+// Input:     g - comparison from Golden_Init, such as GOLDEN_SNR at
+//                90 dB (GOLDEN_EXACT passes only a NO_SIMD build)
+//            samples - length of the random test stream, shared by
+//                      the sections
+//            seed - of the sections and the stream
+//
+// Returns:   1 if every output is within g's tolerance, 0 if not
+//
+// Calls:     Golden_RunKernels, Golden_Passed
+//
+// Notes:     Each section has a random pole pair of radius 0.5 to
+//            0.999 and a zero pair on the unit circle.  The calls
+//            are of random length from 1 to 256, so the natural C
+//            tail and the hand-over of the delays between calls are
+//            tested too.  a[0] is set to a value that would break the
+//            filter if it were read.
+///////////////////////////////////////////////////////////////////////
+{
+	Section ref, cand;
+	double r, pole, zero;
+	Uint32 k;
+
+	for(k = 0; k < DSPF_BIQUAD_CHECK_SECTIONS; k++) {
+		seed = seed * 1664525 + 1013904223;
+		r = 0.5 + 0.499 * (seed >> 8) / 16777216.0;
+		seed = seed * 1664525 + 1013904223;
+		pole = 3.14159265358979 * (seed >> 8) / 16777216.0;
+		seed = seed * 1664525 + 1013904223;
+		zero = 3.14159265358979 * (seed >> 8) / 16777216.0;
+
+		ref.b[0] = 1;
+		ref.b[1] = (float)(-2 * cos(zero));
+		ref.b[2] = 1;
+		ref.a[0] = -1e30F;
+		ref.a[1] = (float)(-2 * r * cos(pole));
+		ref.a[2] = (float)(r * r);
+		ref.delay[0] = ref.delay[1] = 0;
+		cand = ref;
+		Golden_RunKernels(g, RunNatural, &ref, RunHost, &cand,
+			samples / DSPF_BIQUAD_CHECK_SECTIONS, 0, seed);
+	}
+	return Golden_Passed(g);
+}
@@ -0,0 +1,37 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: DSPF_sp_biquad.h
+//
+// Synopsis: Host (source) version of TI DSPLIB's DSPF_sp_biquad, for
+//           frame programs that call it and are built off the board,
+//           where dsplib.a674 cannot be linked.  The call is the same:
+//
+//           DSPF_sp_biquad(x, B[k], &B[k][3], delay[k], y, n);
+//
+//           one transposed direct form II section on nx samples,
+//
+//           y = b0*x + d0,  d0 = b1*x - a1*y + d1,  d1 = b2*x - a2*y
+//
+//           with b = {b0, b1, b2}, a = {a0, a1, a2} (a0 is not read, so
+//           a SOS2C.m row {b0, b1, b2, 1, a1, a2} is b and b + 3) and
+//           the two delays carried between calls in delay.  x and y
+//           should be different buffers, as TI requires.  Programs
+//           that include TI's own DSPF_sp_biquad.h get the same
+//           function; on the board link dsplib instead of this file.
+//           DSPF_sp_biquad_Check is declared where it is called
+//           (Host/DSPF/dspf.c), so this header adds nothing to TI's.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	DSPF_SP_BIQUAD_H_INCLUDED
+#define DSPF_SP_BIQUAD_H_INCLUDED
+
+#include "tistdtypes.h"
+
+// defined in DSPF_sp_biquad.c
+void DSPF_sp_biquad(float *restrict x, float *b, float *a, float *delay,
+			float *restrict y, const int nx);
+
+#endif
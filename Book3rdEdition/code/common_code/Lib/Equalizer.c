@@ -0,0 +1,263 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Equalizer.c
+//
+// Synopsis: Graphic equalizer engine, see Equalizer.h.  Of the three
+//           kernels one is live, one may still be fading out, and the
+//           third is the only one main() writes.  main() builds only
+//           while no kernel is pending, and Run clears pending only
+//           after moving live and previous, so the two never write
+//           the same kernel or pointer at the same time.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include "Equalizer.h"
+#include "Publish.h"
+#include "BlockFIR.h"
+
+static void Sum(float *h, const float **band, const float *gain, Uint32 bands,
+	Uint32 taps)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Builds a kernel as the weighted sum of all the bands
+//
+// Input:     h - receives taps coefficients
+//            band - band filters
+//            gain - gain of each band
+//            bands - number of bands
+//            taps - coefficients per band
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Each coefficient is summed band 0 first, as the original
+//            UpdateCoefficients did, so a kernel from the same gains
+//            has the same coefficients as its B[].  The output is
+//            within 1 LSB of the old filter's, since Run folds the
+//            kernel; it is bit-exact with -DBLOCKFIR_NO_FOLD.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i, k;
+
+	for(i = 0; i < taps; i++)
+		h[i] = band[0][i] * gain[0];
+	for(k = 1; k < bands; k++)
+		for(i = 0; i < taps; i++)
+			h[i] += band[k][i] * gain[k];
+}
+
+static void Add(float *h, const float *base, const float *band, float change,
+	Uint32 taps)
+{
+	Uint32 i;
+
+	for(i = 0; i < taps; i++)
+		h[i] = base[i] + band[i] * change;
+}
+
+Int32 Equalizer_Init(Equalizer *e, const float *const *band, Uint32 bands,
+	Uint32 taps, const float *gain, Uint32 block, Uint32 fade)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up an equalizer and builds its first kernel
+//
+// Input:     e - engine
+//            band - the band filters, taps coefficients each, such
+//                   as B_LP[] of coeff_LP.h, kept by reference
+//            bands - number of bands, any
+//            taps - coefficients per band, N+1
+//            gain - starting gain of each band, or NULL for all 1
+//            block - most outputs per Equalizer_Run, 1 in an ISR
+//            fade - samples to crossfade over after each update, 0
+//                   to switch kernels at once
+//
+// Returns:   1 on success, 0 if out of memory or an argument is 0
+//
+// Calls:     malloc, Sum, BlockFIR_Symmetry, Equalizer_Reset
+//
+// Notes:     e->memory is published last (Publish.h), so an ISR that
+//            finds it non-NULL may use the engine even if Init ran in
+//            StartUp after the interrupts were enabled
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 k, length = taps - 1 + block;
+	void *memory;
+	float *p;
+
+	e->memory = NULL;
+	if(bands == 0 || taps == 0 || block == 0)
+		return 0;
+	memory = malloc(bands * sizeof(const float *)
+		+ (2 * bands + 3 * taps + 2 * length + 2 * block) * sizeof(float));
+	if(memory == NULL)
+		return 0;
+	e->bands = bands;
+	e->taps = taps;
+	e->block = block;
+	e->fade = fade;
+	e->step = fade ? 1.0f / fade : 0;
+	e->band = memory;
+	p = (float *)(e->band + bands);
+	e->gain = p;
+	p += bands;
+	e->built = p;
+	p += bands;
+	for(k = 0; k < 3; k++) {
+		e->kernel[k].h = p;
+		p += taps;
+	}
+	e->line.x = p;
+	e->line.length = length;
+	p += 2 * length;
+	e->y = p;
+	p += block;
+	e->old = p;
+
+	for(k = 0; k < bands; k++) {
+		e->band[k] = band[k];
+		e->gain[k] = e->built[k] = gain ? gain[k] : 1;
+	}
+	Sum(e->kernel[0].h, e->band, e->built, bands, taps);
+	e->kernel[0].symmetry = BlockFIR_Symmetry(e->kernel[0].h, taps);
+	e->increments = 0;
+	e->live = e->previous = &e->kernel[0];
+	e->pending = NULL;
+
+	Equalizer_Reset(e);
+	PUBLISH(e->memory, memory);
+	return 1;
+}
+
+void Equalizer_SetGain(Equalizer *e, Uint32 band, float gain)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets the gain wanted for a band
+//
+// Input:     e - engine
+//            band - 0..bands-1
+//            gain - linear gain, 1 for the band filter as designed
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Takes effect at the next Equalizer_Update
+///////////////////////////////////////////////////////////////////////
+{
+	if(band < e->bands)
+		e->gain[band] = gain;
+}
+
+Int32 Equalizer_Update(Equalizer *e)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Builds and publishes a kernel for gains that changed
+//
+// Input:     e - engine
+//
+// Returns:   1 if a kernel was published, 0 if no gain changed or the
+//            last kernel has not been taken by Equalizer_Run yet
+//
+// Calls:     Add, Sum, BlockFIR_Symmetry
+//
+// Notes:     Call from main(), never from the ISR.  Gains changed
+//            meanwhile are picked up by a later call.
+///////////////////////////////////////////////////////////////////////
+{
+	EqualizerKernel *next, *live;
+	Uint32 k, changed = 0, last = 0;
+	float g;
+
+	if(e->memory == NULL || e->pending != NULL)
+		return 0;
+	EQUALIZER_BARRIER();				// read live and previous after pending
+	for(k = 0; k < e->bands; k++)
+		if(e->gain[k] != e->built[k]) {
+			changed++;
+			last = k;
+		}
+	if(changed == 0)
+		return 0;
+
+	// the spare kernel is neither filtering nor fading out
+	live = e->live;
+	for(next = e->kernel; next == live || next == e->previous; next++)
+		;
+
+	if(changed == 1 && e->increments < EQUALIZER_REBUILD) {
+		g = e->gain[last];
+		Add(next->h, live->h, e->band[last], g - e->built[last], e->taps);
+		e->built[last] = g;
+		e->increments++;
+	}
+	else {
+		for(k = 0; k < e->bands; k++)
+			e->built[k] = e->gain[k];
+		Sum(next->h, e->band, e->built, e->bands, e->taps);
+		e->increments = 0;
+	}
+	next->symmetry = BlockFIR_Symmetry(next->h, e->taps);
+
+	EQUALIZER_BARRIER();				// kernel written before it is published
+	e->pending = next;
+	return 1;
+}
+
+void Equalizer_Run(Equalizer *e, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters the last n samples put into the delay line
+//
+// Input:     e - engine
+//            n - outputs, at most e->block
+//
+// Returns:   Nothing, the outputs are in e->y
+//
+// Calls:     DelayLine_Window, BlockFIR_Folded
+//
+// Notes:     A published kernel is taken at the start of a block once
+//            the last crossfade is over.  While fading, the old kernel
+//            runs too, so those samples cost two filters.
+///////////////////////////////////////////////////////////////////////
+{
+	const float *p = DelayLine_Window(&e->line, e->taps - 1 + n);
+	EqualizerKernel *k = e->pending, *live;
+	Uint32 i, m;
+	float a;
+
+	if(k != NULL && e->faded == e->fade) {
+		EQUALIZER_BARRIER();			// read the kernel after the pointer
+		e->previous = e->live;
+		e->live = k;
+		e->faded = 0;
+		EQUALIZER_BARRIER();			// swap seen before the spare is reused
+		e->pending = NULL;
+	}
+
+	live = e->live;
+	BlockFIR_Folded(live->h, e->taps, live->symmetry, p, e->y, n);
+	if(e->faded < e->fade) {
+		m = e->fade - e->faded < n ? e->fade - e->faded : n;
+		k = e->previous;
+		BlockFIR_Folded(k->h, e->taps, k->symmetry, p, e->old, m);
+		for(i = 0; i < m; i++) {
+			a = ++e->faded * e->step;
+			e->y[i] = e->old[i] + a * (e->y[i] - e->old[i]);
+		}
+	}
+}
+
+void Equalizer_Reset(Equalizer *e)
+{
+	Uint32 i;
+
+	for(i = 0; i < 2 * e->line.length; i++)
+		e->line.x[i] = 0;
+	e->line.head = 0;
+	e->faded = e->fade;
+}
+
+void Equalizer_Close(Equalizer *e)
+{
+	free(e->memory);
+	e->memory = NULL;
+}
@@ -0,0 +1,86 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Equalizer.h
+//
+// Synopsis: Graphic equalizer engine: one FIR whose kernel is the
+//           gain-weighted sum of any number of band filters, so each
+//           sample costs one filter however many bands there are.
+//           The main loop builds a new kernel in a spare buffer and
+//           publishes it with a single pointer store; the ISR picks
+//           it up at the start of its next block and crossfades from
+//           the old kernel's output to the new one's over fade
+//           samples, so a slider move never plays a half-written or
+//           clicking filter:
+//
+//           Equalizer_Init(&eq, bands, 5, N+1, gains, 1, 64);
+//           while(1) {                                // main loop
+//               Equalizer_SetGain(&eq, 0, new_gain_lp);
+//               Equalizer_Update(&eq);
+//           }
+//           DelayLine_Put(&eq.line, input);           // Codec_ISR
+//           Equalizer_Run(&eq, 1);                    // eq.y[0]
+//
+//           When one gain changes, the kernel is updated by adding
+//           that band times the change, taps multiplies instead of
+//           bands*taps; the full sum is redone every
+//           EQUALIZER_REBUILD such updates to drop the rounding.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	EQUALIZER_H_INCLUDED
+#define EQUALIZER_H_INCLUDED
+
+#include "tistdtypes.h"
+#include "DelayLine.h"
+
+#define EQUALIZER_REBUILD	64		// one-band updates between full sums
+
+// the ISR and main() share one core on the DSP, so only the compiler
+// could reorder there: h[] and symmetry are not volatile, and without
+// a barrier their stores may sink past the volatile pending = next.
+// The TI optimizer moves nothing across an asm statement.  Host
+// threads need a real fence.
+#ifdef DSPBOARDTYPE_HOST
+#define EQUALIZER_BARRIER()	__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define EQUALIZER_BARRIER()	asm("")
+#endif
+
+typedef struct {
+	float  *h;				// taps coefficients, the weighted sum of the bands
+	Int32  symmetry;		// of h, BLOCKFIR_SYMMETRIC etc.
+} EqualizerKernel;
+
+typedef struct {
+	Uint32 bands;			// band filters summed
+	Uint32 taps;			// coefficients of each band filter, N+1
+	Uint32 block;			// most outputs per Equalizer_Run
+	Uint32 fade;			// crossfade length in samples, 0 to switch at once
+	float  step;			// 1/fade
+	const float **band;		// band filters, kept by reference
+	volatile float *gain;	// wanted gains, from Equalizer_SetGain
+	float  *built;			// gains of the newest kernel
+	Uint32 increments;		// one-band updates since the last full sum
+	EqualizerKernel kernel[3];	// filtering, fading out, and being built
+	EqualizerKernel * volatile live;		// filters the input, ISR side
+	EqualizerKernel * volatile previous;	// faded out after a swap, ISR side
+	EqualizerKernel * volatile pending;		// published by main, taken by Run
+	Uint32 faded;			// samples of the crossfade done, fade when none
+	DelayLine line;			// last taps-1+block inputs
+	float  *y;				// outputs of the last Equalizer_Run
+	float  *old;			// the previous kernel's outputs while fading
+	void   *memory;			// set last by Equalizer_Init, so non-NULL means ready
+} Equalizer;
+
+// defined in Equalizer.c
+Int32 Equalizer_Init(Equalizer *, const float *const *, Uint32, Uint32, const float *,
+	Uint32, Uint32);
+void  Equalizer_SetGain(Equalizer *, Uint32, float);
+Int32 Equalizer_Update(Equalizer *);
+void  Equalizer_Run(Equalizer *, Uint32);
+void  Equalizer_Reset(Equalizer *);
+void  Equalizer_Close(Equalizer *);
+
+#endif
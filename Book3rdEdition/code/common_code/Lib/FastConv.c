@@ -0,0 +1,241 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: FastConv.c
+//
+// Synopsis: Direct form and overlap-save FFT FIR filters, see
+//           FastConv.h.  The FFT form transforms the last taps-1+n
+//           inputs, zero padded to size, multiplies by the filter's
+//           spectrum and transforms back; outputs taps-1 onwards are
+//           free of circular wrap-around.  Two channels share one
+//           complex FFT, one in the real part and one in the
+//           imaginary part, since h is real.  The inverse FFT is
+//           fft_c of the conjugate, with 1/size folded into H.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <c6x.h>
+#include "FastConv.h"
+
+#define FASTCONV_TRIALS		3		// timed runs of each form, the fastest counts
+
+static Uint32 TimeRun(FastConv *c, Uint8 mode)
+{
+	Uint32 i, t, best = 0xFFFFFFFF;
+
+	c->mode = mode;
+	for(i = 0; i < FASTCONV_TRIALS; i++) {
+		t = TSCL;
+		FastConv_Run(c, c->block);
+		t = TSCL - t;
+		if(t < best)
+			best = t;
+	}
+	return best;
+}
+
+Int32 FastConv_Init(FastConv *c, const float *h, Uint32 taps, Uint32 block,
+	Uint32 channels, Uint8 mode)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up a filter and chooses its form
+//
+// Input:     c - engine
+//            h - coefficients h[0..taps-1], B[] of coeff.h, kept by
+//                reference
+//            taps - number of coefficients, N+1
+//            block - most outputs per FastConv_Run, e.g. the frame
+//            channels - 1 or 2
+//            mode - FASTCONV_DIRECT, FASTCONV_FFT, or FASTCONV_AUTO to
+//                   time both on this processor and keep the faster
+//
+// Returns:   1 on success, 0 if out of memory or an argument is 0
+//
+// Calls:     malloc, BlockFIR_Symmetry, TapFIR_Select, init_W, fft_c,
+//            FastConv_Run
+//
+// Notes:     The FFT form is kept in FASTCONV_AUTO only if it needs
+//            under FASTCONV_MARGIN of direct form's time, so a
+//            filter near the crossover stays bit-exact.  Call outside
+//            real time: the timing runs a few blocks of each form.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i, k, length = taps - 1 + block, direct, fft;
+	size_t bytes;
+	float *p;
+
+	c->memory = NULL;
+	if(taps == 0 || block == 0 || channels == 0 || channels > 2)
+		return 0;
+	c->h = h;
+	c->taps = taps;
+	c->block = block;
+	c->channels = channels;
+	c->symmetry = BlockFIR_Symmetry(h, taps);
+	c->fixed = c->symmetry == BLOCKFIR_GENERAL ? TapFIR_Select(taps) : NULL;
+	c->direct_cycles = c->fft_cycles = 0;
+	c->size = 0;
+	if(mode != FASTCONV_DIRECT)
+		for(c->size = 2; c->size < length; c->size <<= 1)
+			;
+
+	// spectra first, for COMPLEX alignment, then lines and outputs
+	bytes = 3 * c->size * sizeof(COMPLEX) + 2 * (2 * length + block) * sizeof(float);
+	if((c->memory = malloc(bytes)) == NULL)
+		return 0;
+	c->H = c->memory;
+	c->W = c->H + c->size;
+	c->X = c->W + c->size;
+	p = (float *)(c->X + c->size);
+	for(k = 0; k < 2; k++) {
+		c->line[k].x = p;
+		c->line[k].length = length;
+		p += 2 * length;
+		c->y[k] = p;
+		p += block;
+	}
+	FastConv_Reset(c);
+
+	if(c->size) {
+		// spectrum of the zero padded coefficients
+		init_W(c->size, c->W);
+		for(i = 0; i < c->size; i++) {
+			c->H[i].real = i < taps ? h[i] : 0;
+			c->H[i].imag = 0;
+		}
+		fft_c(c->size, c->H, c->W);
+		for(i = 0; i < c->size; i++) {
+			c->H[i].real /= c->size;
+			c->H[i].imag /= c->size;
+		}
+	}
+
+	c->mode = mode == FASTCONV_FFT ? FASTCONV_FFT : FASTCONV_DIRECT;
+	if(mode == FASTCONV_AUTO) {
+#ifndef DSPBOARDTYPE_HOST
+		TSCL = 0;						// any write starts the counter
+#endif
+		direct = TimeRun(c, FASTCONV_DIRECT);
+		fft = TimeRun(c, FASTCONV_FFT);
+		c->direct_cycles = (float)direct / block;
+		c->fft_cycles = (float)fft / block;
+		c->mode = fft < FASTCONV_MARGIN * direct ? FASTCONV_FFT : FASTCONV_DIRECT;
+		FastConv_Reset(c);
+	}
+	return 1;
+}
+
+void FastConv_Run(FastConv *c, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters the last n samples put into the delay lines
+//
+// Input:     c - engine
+//            n - outputs per channel, at most c->block
+//
+// Returns:   Nothing, the outputs are in c->y[0] (and c->y[1])
+//
+// Calls:     BlockFIR, BlockFIR_Stereo, BlockFIR_Folded, c->fixed,
+//            DelayLine_Window, fft_c
+//
+// Notes:     Put exactly n samples into each line since the last call
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i, m = c->taps - 1 + n;
+	const float *p = DelayLine_Window(&c->line[0], m), *q = DelayLine_Window(&c->line[1], m);
+	COMPLEX *X = c->X, *H = c->H;
+	float re, im;
+
+	if(c->mode == FASTCONV_DIRECT) {
+		if(c->symmetry != BLOCKFIR_GENERAL) {
+			BlockFIR_Folded(c->h, c->taps, c->symmetry, p, c->y[0], n);
+			if(c->channels == 2)
+				BlockFIR_Folded(c->h, c->taps, c->symmetry, q, c->y[1], n);
+		}
+		else if(c->fixed) {
+			c->fixed(c->h, p, c->y[0], n);
+			if(c->channels == 2)
+				c->fixed(c->h, q, c->y[1], n);
+		}
+		else if(c->channels == 2)
+			BlockFIR_Stereo(c->h, c->taps, p, q, c->y[0], c->y[1], n);
+		else
+			BlockFIR(c->h, c->taps, p, c->y[0], n);
+		return;
+	}
+
+	// both channels in one complex segment, zero padded
+	for(i = 0; i < m; i++) {
+		X[i].real = p[i];
+		X[i].imag = c->channels == 2 ? q[i] : 0;
+	}
+	for(; i < c->size; i++)
+		X[i].real = X[i].imag = 0;
+	fft_c(c->size, X, c->W);
+
+	// multiply by the spectrum, conjugated for the inverse transform
+	for(i = 0; i < c->size; i++) {
+		re = X[i].real * H[i].real - X[i].imag * H[i].imag;
+		im = X[i].real * H[i].imag + X[i].imag * H[i].real;
+		X[i].real = re;
+		X[i].imag = -im;
+	}
+	fft_c(c->size, X, c->W);
+
+	// the first taps-1 outputs wrap around, the rest are the frame's
+	X += c->taps - 1;
+	for(i = 0; i < n; i++)
+		c->y[0][i] = X[i].real;
+	if(c->channels == 2)
+		for(i = 0; i < n; i++)
+			c->y[1][i] = -X[i].imag;
+}
+
+void FastConv_Process(void *state, const float *in, float *out, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters a block of channel 0, as a block kernel
+//
+// Input:     state - the FastConv
+//            in - n inputs
+//            out - receives n outputs
+//            n - samples, any number
+//
+// Returns:   Nothing
+//
+// Calls:     DelayLine_Put, FastConv_Run
+//
+// Notes:     Same form as the StreamSched and Golden kernels
+///////////////////////////////////////////////////////////////////////
+{
+	FastConv *c = state;
+	Uint32 i, k;
+
+	while(n) {
+		k = n < c->block ? n : c->block;
+		for(i = 0; i < k; i++)
+			DelayLine_Put(&c->line[0], in[i]);
+		FastConv_Run(c, k);
+		for(i = 0; i < k; i++)
+			out[i] = c->y[0][i];
+		in += k;
+		out += k;
+		n -= k;
+	}
+}
+
+void FastConv_Reset(FastConv *c)
+{
+	Uint32 k, i;
+
+	for(k = 0; k < 2; k++) {
+		for(i = 0; i < 2 * c->line[k].length; i++)
+			c->line[k].x[i] = 0;
+		c->line[k].head = 0;
+	}
+}
+
+void FastConv_Close(FastConv *c)
+{
+	free(c->memory);
+	c->memory = NULL;
+}
@@ -0,0 +1,72 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: FastConv.h
+//
+// Synopsis: FIR filter engine for frame programs that runs either in
+//           direct form (BlockFIR) or as an overlap-save FFT
+//           convolution (fft_c), whichever is faster for the filter
+//           length and frame size on the processor it runs on.
+//           Samples are put into the engine's delay lines, then a
+//           frame of outputs is computed at once:
+//
+//           FastConv_Init(&fir, B, N+1, frame, 2, FASTCONV_AUTO);
+//           for(i = 0; i < frame; i++) {
+//               DelayLine_Put(&fir.line[0], left[i]);
+//               DelayLine_Put(&fir.line[1], right[i]);
+//           }
+//           FastConv_Run(&fir, frame);   // fir.y[0], fir.y[1]
+//
+//           Direct form is bit-exact with the scalar FIR loop unless
+//           the coefficients are symmetric or antisymmetric, when it
+//           runs folded (BlockFIR_Folded); folding and the FFT form
+//           differ from it by float rounding (about 1e-7 of full
+//           scale).  Unfolded, it uses the TapFIR.c filter for the
+//           tap count if there is one.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	FASTCONV_H_INCLUDED
+#define FASTCONV_H_INCLUDED
+
+#include "tistdtypes.h"
+#include "fft.h"
+#include "DelayLine.h"
+#include "BlockFIR.h"
+#include "TapFIR.h"
+
+// forms of the filter
+#define FASTCONV_AUTO		0	// time both at FastConv_Init, keep the faster
+#define FASTCONV_DIRECT		1
+#define FASTCONV_FFT		2
+
+#define FASTCONV_MARGIN		0.8	// FFT form is kept if it takes under this share of direct's time
+
+typedef struct {
+	const float *h;			// coefficients h[0..taps-1]
+	Uint32 taps;
+	Uint32 block;			// most outputs per FastConv_Run
+	Uint32 channels;		// 1 or 2, filtered with the same h
+	Uint32 size;			// FFT length, a power of 2 >= taps-1+block, 0 in direct form
+	Uint8  mode;			// FASTCONV_DIRECT or FASTCONV_FFT
+	Int32  symmetry;		// BLOCKFIR_SYMMETRIC etc., folds direct form
+	TapFIR fixed;			// TapFIR_Select(taps) if not folded, else NULL
+	float  direct_cycles;	// measured cycles per output sample with
+	float  fft_cycles;		//   FASTCONV_AUTO, else 0
+	DelayLine line[2];		// last taps-1+block inputs of each channel
+	float  *y[2];			// block outputs of each channel, from FastConv_Run
+	COMPLEX *H;				// filter spectrum, scaled by 1/size
+	COMPLEX *W;				// twiddle factors for fft_c
+	COMPLEX *X;				// segment being transformed
+	void   *memory;
+} FastConv;
+
+// defined in FastConv.c
+Int32 FastConv_Init(FastConv *, const float *, Uint32, Uint32, Uint32, Uint8);
+void  FastConv_Run(FastConv *, Uint32);
+void  FastConv_Process(void *, const float *, float *, Uint32);
+void  FastConv_Reset(FastConv *);
+void  FastConv_Close(FastConv *);
+
+#endif
@@ -0,0 +1,321 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: FixedFIR.c
+//
+// Synopsis: Fixed-point FIR filter, see FixedFIR.h.  The delay line is
+//           mirrored as in DelayLine.h, so each output is one dot
+//           product of the reversed coefficients with a contiguous
+//           window of Int16 samples.  pmaddwd multiplies eight pairs
+//           and adds neighbouring products into four 32-bit lanes.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include "FixedFIR.h"
+#include "Publish.h"
+
+#if defined(FIXEDFIR_NO_SIMD)
+#define FIXEDFIR_VLEN	1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define FIXEDFIR_VLEN	16
+typedef __m256i FixVec;
+#define FixZero()		_mm256_setzero_si256()
+#define FixLoad(p)		_mm256_loadu_si256((const __m256i *)(p))
+#define FixMadd(a, b)	_mm256_madd_epi16(a, b)
+#define FixAdd32(a, b)	_mm256_add_epi32(a, b)
+#define FixAdd64(a, b)	_mm256_add_epi64(a, b)
+#define FixSign(a)		_mm256_srai_epi32(a, 31)
+#define FixLow(a, b)	_mm256_unpacklo_epi32(a, b)
+#define FixHigh(a, b)	_mm256_unpackhi_epi32(a, b)
+#define FixStore(p, v)	_mm256_storeu_si256((__m256i *)(p), v)
+#define FixHalf(a)		_mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1))
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define FIXEDFIR_VLEN	8
+typedef __m128i FixVec;
+#define FixZero()		_mm_setzero_si128()
+#define FixLoad(p)		_mm_loadu_si128((const __m128i *)(p))
+#define FixMadd(a, b)	_mm_madd_epi16(a, b)
+#define FixAdd32(a, b)	_mm_add_epi32(a, b)
+#define FixAdd64(a, b)	_mm_add_epi64(a, b)
+#define FixSign(a)		_mm_srai_epi32(a, 31)
+#define FixLow(a, b)	_mm_unpacklo_epi32(a, b)
+#define FixHigh(a, b)	_mm_unpackhi_epi32(a, b)
+#define FixStore(p, v)	_mm_storeu_si128((__m128i *)(p), v)
+#define FixHalf(a)		(a)
+#else
+#define FIXEDFIR_VLEN	1
+#endif
+
+static long long Dot(const FixedFIR *f, const Int16 *x)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sums the products of the coefficients and a window
+//
+// Input:     f - filter
+//            x - f->length samples, oldest first
+//
+// Returns:   The exact sum
+//
+// Calls:     Nothing
+//
+// Notes:     In 32-bit mode FixedFIR_Init has shown the sum fits
+///////////////////////////////////////////////////////////////////////
+{
+	const Int16 *h = f->h;
+	Uint32 j, n = f->length;
+	long long wide = 0;
+	Int32 sum = 0;
+#if FIXEDFIR_VLEN > 1
+	Int32 lane[FIXEDFIR_VLEN / 2];
+	long long lane64[FIXEDFIR_VLEN / 4];
+	FixVec a, b, p;
+
+	if(f->simd) {
+		a = b = FixZero();
+		if(f->wide) {
+			// sign extend each pair's 32-bit sum into 64-bit lanes
+			for(j = 0; j < n; j += FIXEDFIR_VLEN) {
+				p = FixMadd(FixLoad(h + j), FixLoad(x + j));
+				a = FixAdd64(a, FixLow(p, FixSign(p)));
+				b = FixAdd64(b, FixHigh(p, FixSign(p)));
+			}
+			FixStore(lane64, FixAdd64(a, b));
+			for(j = 0; j < FIXEDFIR_VLEN / 4; j++)
+				wide += lane64[j];
+			return wide;
+		}
+		// length is a multiple of two vectors
+		for(j = 0; j < n; j += 2 * FIXEDFIR_VLEN) {
+			a = FixAdd32(a, FixMadd(FixLoad(h + j), FixLoad(x + j)));
+			b = FixAdd32(b, FixMadd(FixLoad(h + j + FIXEDFIR_VLEN), FixLoad(x + j + FIXEDFIR_VLEN)));
+		}
+		FixStore(lane, FixAdd32(a, b));
+		for(j = 0; j < FIXEDFIR_VLEN / 2; j++)
+			sum += lane[j];
+		return sum;
+	}
+#endif
+	if(f->wide) {
+		for(j = 0; j < n; j++)
+			wide += (Int32)h[j] * x[j];
+		return wide;
+	}
+	for(j = 0; j < n; j++)
+		sum += (Int32)h[j] * x[j];
+	return sum;
+}
+
+#if FIXEDFIR_VLEN > 1
+static void Dot4(const FixedFIR *f, const Int16 *x, Int32 *y)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sums four consecutive outputs at once
+//
+// Input:     f - filter, 32-bit mode
+//            x - f->length+3 samples, oldest first
+//            y - receives the sums of the windows at x, x+1, x+2, x+3
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Each coefficient vector is loaded once for four outputs,
+//            and the four horizontal sums share one transpose
+///////////////////////////////////////////////////////////////////////
+{
+	const Int16 *h = f->h;
+	Uint32 j, n = f->length;
+	FixVec c, a0, a1, a2, a3;
+	__m128i s0, s1, s2, s3;
+
+	a0 = a1 = a2 = a3 = FixZero();
+	for(j = 0; j < n; j += FIXEDFIR_VLEN) {
+		c = FixLoad(h + j);
+		a0 = FixAdd32(a0, FixMadd(c, FixLoad(x + j)));
+		a1 = FixAdd32(a1, FixMadd(c, FixLoad(x + j + 1)));
+		a2 = FixAdd32(a2, FixMadd(c, FixLoad(x + j + 2)));
+		a3 = FixAdd32(a3, FixMadd(c, FixLoad(x + j + 3)));
+	}
+	s0 = FixHalf(a0);
+	s1 = FixHalf(a1);
+	s2 = FixHalf(a2);
+	s3 = FixHalf(a3);
+	// transpose the four lanes of each sum and add them up
+	s0 = _mm_add_epi32(_mm_unpacklo_epi32(s0, s1), _mm_unpackhi_epi32(s0, s1));
+	s2 = _mm_add_epi32(_mm_unpacklo_epi32(s2, s3), _mm_unpackhi_epi32(s2, s3));
+	_mm_storeu_si128((__m128i *)y, _mm_add_epi32(_mm_unpacklo_epi64(s0, s2),
+		_mm_unpackhi_epi64(s0, s2)));
+}
+#endif
+
+static Int16 Scale(const FixedFIR *f, long long sum)
+{
+	long long half = (long long)1 << f->q >> 1;
+	long long y = sum >> f->q;	// arithmetic shift: toward minus infinity
+
+	if(f->rounding == FIXEDFIR_ROUND)
+		y = (sum + half) >> f->q;
+	else if(f->rounding == FIXEDFIR_CONVERGENT && half) {
+		sum &= ((long long)1 << f->q) - 1;	// the bits shifted out
+		if(sum > half || (sum == half && (y & 1)))
+			y++;
+	}
+	if(y > 32767)
+		return 32767;
+	if(y < -32768)
+		return -32768;
+	return y;
+}
+
+static void Put(FixedFIR *f, Int16 s)
+{
+	Uint32 h = f->head;
+
+	f->x[h] = s;
+	f->x[h + f->line] = s;
+	f->head = h + 1 < f->line ? h + 1 : 0;
+}
+
+Int32 FixedFIR_Init(FixedFIR *f, const Int16 *B, Uint32 taps, Uint32 q, Uint8 rounding,
+	Uint32 block)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up a fixed-point filter
+//
+// Input:     f - filter
+//            B - coefficients B[0..taps-1], from fir_dump2c_Qxx, copied
+//            taps - B_SIZE
+//            q - fraction bits of B, the Qxx of the export (0..30)
+//            rounding - FIXEDFIR_TRUNCATE, FIXEDFIR_ROUND or
+//                       FIXEDFIR_CONVERGENT
+//            block - most samples per FixedFIR_Block pass, 1 if only
+//                    FixedFIR_Filter is used
+//
+// Returns:   1 on success, 0 if out of memory or an argument is bad
+//
+// Calls:     malloc, FixedFIR_Reset
+//
+// Notes:     Sums stay in 32 bits if 32768 * sum(|B|) fits.  pmaddwd
+//            wraps only for two -32768 coefficients side by side
+//            meeting two -32768 samples; such filters use the C path.
+//            f->memory is published last (Publish.h), so an ISR may
+//            test it to see whether the filter is ready.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 j, length, magnitude = 0;
+	Int16 *h;
+	void *memory;
+
+	f->memory = NULL;
+	if(taps == 0 || q > 30 || rounding > FIXEDFIR_CONVERGENT || block == 0)
+		return 0;
+	length = (taps + 2 * FIXEDFIR_VLEN - 1) / (2 * FIXEDFIR_VLEN) * (2 * FIXEDFIR_VLEN);
+	if((memory = malloc((3 * length + 2 * (block - 1)) * sizeof(Int16))) == NULL)
+		return 0;
+	f->taps = taps;
+	f->q = q;
+	f->rounding = rounding;
+	f->length = length;
+	f->block = block;
+	f->line = length - 1 + block;
+	f->h = h = memory;
+	f->x = h + length;
+
+	// reversed, with the padding at the oldest end
+	for(j = 0; j < length; j++)
+		h[j] = j < length - taps ? 0 : B[length - 1 - j];
+	for(j = 0; j < taps; j++)
+		magnitude += B[j] < 0 ? -B[j] : B[j];
+	f->wide = magnitude >= 65536 || taps > 65536;
+	f->simd = 1;
+	for(j = 0; j < length; j += 2)
+		if(h[j] == -32768 && h[j + 1] == -32768)
+			f->simd = 0;
+
+	FixedFIR_Reset(f);
+	PUBLISH(f->memory, memory);
+	return 1;
+}
+
+Int16 FixedFIR_Filter(FixedFIR *f, Int16 input)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters one sample
+//
+// Input:     f - filter
+//            input - newest codec sample
+//
+// Returns:   The output sample, rounded and saturated
+//
+// Calls:     Put, Dot, Scale
+//
+// Notes:     For the ISRs, e.g. on CodecDataIn.Channel[LEFT]
+///////////////////////////////////////////////////////////////////////
+{
+	Put(f, input);
+	return Scale(f, Dot(f, f->x + f->head + f->line - f->length));
+}
+
+void FixedFIR_Block(FixedFIR *f, const Int16 *in, Int16 *out, Uint32 n, Uint32 stride)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters a block of samples
+//
+// Input:     f - filter
+//            in - n inputs, stride apart
+//            out - receives n outputs, stride apart; may be in
+//            n - samples
+//            stride - 1, or 2 for one channel of interleaved L/R
+//
+// Returns:   Nothing
+//
+// Calls:     Put, Dot, Dot4, Scale
+//
+// Notes:     Keep one FixedFIR per channel.  Up to f->block samples
+//            are stored before any is filtered, which keeps the
+//            vector loads from waiting on the stores just made.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i, k;
+	const Int16 *w;
+#if FIXEDFIR_VLEN > 1
+	Int32 sum[4];
+#endif
+
+	while(n) {
+		k = n < f->block ? n : f->block;
+		for(i = 0; i < k; i++)
+			Put(f, in[i * stride]);
+		w = f->x + f->head + f->line - (f->length - 1 + k);
+		i = 0;
+#if FIXEDFIR_VLEN > 1
+		if(f->simd && !f->wide)
+			for(; i + 4 <= k; i += 4) {
+				Dot4(f, w + i, sum);
+				out[i * stride] = Scale(f, sum[0]);
+				out[(i + 1) * stride] = Scale(f, sum[1]);
+				out[(i + 2) * stride] = Scale(f, sum[2]);
+				out[(i + 3) * stride] = Scale(f, sum[3]);
+			}
+#endif
+		for(; i < k; i++)
+			out[i * stride] = Scale(f, Dot(f, w + i));
+		in += k * stride;
+		out += k * stride;
+		n -= k;
+	}
+}
+
+void FixedFIR_Reset(FixedFIR *f)
+{
+	Uint32 i;
+
+	for(i = 0; i < 2 * f->line; i++)
+		f->x[i] = 0;
+	f->head = 0;
+}
+
+void FixedFIR_Close(FixedFIR *f)
+{
+	free(f->memory);
+	f->memory = NULL;
+}
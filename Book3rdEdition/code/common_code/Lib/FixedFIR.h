@@ -0,0 +1,56 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: FixedFIR.h
+//
+// Synopsis: Fixed-point FIR filter for the Int16 codec samples and the
+//           short B[] arrays of fir_dump2c_Qxx.m (Q12, Q15, ...).
+//           Products are 16x16->32 bits, summed in 32 bits when the
+//           coefficients cannot overflow it and in 64 bits otherwise
+//           (chosen by FixedFIR_Init), then rounded, shifted back by
+//           the Q format and saturated to 16 bits:
+//
+//           FixedFIR_Init(&fir, B, B_SIZE, 15, FIXEDFIR_ROUND, 1);
+//           CodecDataOut.Channel[LEFT] = FixedFIR_Filter(&fir, CodecDataIn.Channel[LEFT]);
+//
+//           On the host the sums use SSE2 (AVX2 with -mavx2) pmaddwd,
+//           eight (sixteen) taps per instruction, twice the lanes of
+//           float; integer sums are exact, so every path gives the
+//           same output.  Build with FIXEDFIR_NO_SIMD for plain C.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	FIXEDFIR_H_INCLUDED
+#define FIXEDFIR_H_INCLUDED
+
+#include "tistdtypes.h"
+
+// rounding of the sum before it is shifted back to 16 bits
+#define FIXEDFIR_TRUNCATE		0	// toward minus infinity, a plain shift
+#define FIXEDFIR_ROUND			1	// to nearest, halves up
+#define FIXEDFIR_CONVERGENT		2	// to nearest, halves to even (no bias)
+
+typedef struct {
+	Uint32 taps;			// B_SIZE
+	Uint32 q;				// fraction bits of B, 15 for Q15
+	Uint8  rounding;		// FIXEDFIR_TRUNCATE etc.
+	Uint8  wide;			// 1 if a sum may need more than 32 bits
+	Uint8  simd;			// 0 if the vector path could overflow, see FixedFIR_Init
+	Uint32 length;			// taps padded to the vector length
+	Uint32 block;			// most samples per FixedFIR_Block pass
+	Uint32 line;			// delay line length, length-1+block
+	Int16  *h;				// B reversed, oldest input's coefficient first, zero padded
+	Int16  *x;				// mirrored delay line, see DelayLine.h
+	Uint32 head;			// where the next sample goes
+	void   *memory;
+} FixedFIR;
+
+// defined in FixedFIR.c
+Int32 FixedFIR_Init(FixedFIR *, const Int16 *, Uint32, Uint32, Uint8, Uint32);
+Int16 FixedFIR_Filter(FixedFIR *, Int16);
+void  FixedFIR_Block(FixedFIR *, const Int16 *, Int16 *, Uint32, Uint32);
+void  FixedFIR_Reset(FixedFIR *);
+void  FixedFIR_Close(FixedFIR *);
+
+#endif
@@ -0,0 +1,133 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: FrameQueue.c
+//
+// Synopsis: Lock-free single-producer/single-consumer frame queue.
+//           Replaces the buffer_ready/ready_index/over_run flags of the
+//           frame programs so that more than one frame can wait for
+//           ProcessBuffer.  With a queue depth of D the program needs
+//           D+2 buffers (one filling, one playing) and a slow frame
+//           can borrow up to D frame periods from the frames after it.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "FrameQueue.h"
+
+void FrameQueue_Init(FrameQueue *q, FrameDesc *slots, Uint32 depth, Uint32 latency)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Initializes an empty queue
+//
+// Input:     q - queue to initialize
+//            slots - storage for depth descriptors
+//            depth - queue capacity in frames
+//            latency - frames between a frame's completion and the
+//                      start of its playout (NUM_BUFFERS - 1)
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Call before the producer ISR is enabled
+///////////////////////////////////////////////////////////////////////
+{
+	q->slots = slots;
+	q->depth = depth;
+	q->latency = latency;
+	q->head = q->tail = 0;
+	q->frames = 0;
+	q->dropped = q->late = 0;
+}
+
+Int32 FrameQueue_Push(FrameQueue *q, void *data)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Queues a completed frame (producer side)
+//
+// Input:     q - queue
+//            data - frame buffer
+//
+// Returns:   1 if queued, 0 if the queue was full and the frame dropped
+//
+// Calls:     Nothing
+//
+// Notes:     Call from the ISR that completes frames.  A dropped frame
+//            is played out unprocessed.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 head = q->head, seq = q->frames;
+	volatile FrameDesc *slot;
+
+	q->frames = seq + 1;
+	if(head - q->tail >= q->depth) {
+		q->dropped++;
+		return 0;
+	}
+	slot = &q->slots[head % q->depth];
+	slot->data = data;
+	slot->seq = seq;
+	slot->deadline = seq + q->latency;
+	FRAMEQUEUE_BARRIER();				// descriptor visible before head moves
+	q->head = head + 1;
+	return 1;
+}
+
+FrameDesc *FrameQueue_Peek(FrameQueue *q)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the oldest queued frame (consumer side)
+//
+// Input:     q - queue
+//
+// Returns:   Pointer to the frame descriptor, NULL if the queue is empty
+//
+// Calls:     Nothing
+//
+// Notes:     The frame stays queued until FrameQueue_Pop
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 tail = q->tail;
+
+	if(tail == q->head)
+		return 0;
+	FRAMEQUEUE_BARRIER();				// read descriptor after seeing head
+	return (FrameDesc *)&q->slots[tail % q->depth];
+}
+
+void FrameQueue_Pop(FrameQueue *q)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Releases the oldest queued frame after processing
+//
+// Input:     q - queue
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Counts the frame as late if its playout has already begun
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 tail = q->tail;
+
+	if(tail == q->head)
+		return;
+	if((Int32)(q->frames - q->slots[tail % q->depth].deadline) >= 0)
+		q->late++;
+	FRAMEQUEUE_BARRIER();				// finish with the buffer before release
+	q->tail = tail + 1;
+}
+
+Uint32 FrameQueue_Count(FrameQueue *q)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the number of frames waiting for processing
+//
+// Input:     q - queue
+//
+// Returns:   Queued frame count
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	return q->head - q->tail;
+}
@@ -0,0 +1,53 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: FrameQueue.h
+//
+// Synopsis: Single-producer/single-consumer queue of frame descriptors.
+//           The producer is an ISR (EDMA completion or a Codec_ISR
+//           frame builder), the consumer is the main() loop.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	FRAMEQUEUE_H_INCLUDED
+#define FRAMEQUEUE_H_INCLUDED
+
+#include "tistdtypes.h"
+
+// ISR and main() share one core on the DSP, so only the compiler can
+// reorder there: the empty asm keeps the plain descriptor and buffer
+// accesses on their side of the volatile head and tail.  Host threads
+// need a real fence.
+#ifdef DSPBOARDTYPE_HOST
+#define FRAMEQUEUE_BARRIER()	__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define FRAMEQUEUE_BARRIER()	asm("")
+#endif
+
+// one completed frame
+typedef struct {
+	void   *data;			// frame buffer
+	Uint32 seq;				// frame number, counting from 0
+	Uint32 deadline;		// frame count at which the buffer is played out
+} FrameDesc;
+
+typedef struct {
+	volatile FrameDesc *slots;	// depth descriptors
+	Uint32 depth;				// queue capacity in frames
+	Uint32 latency;				// frames from completion to playout
+	volatile Uint32 head;		// frames queued, written by producer only
+	volatile Uint32 tail;		// frames released, written by consumer only
+	volatile Uint32 frames;		// frames completed, written by producer only
+	volatile Uint32 dropped;	// frames not queued (queue full), producer only
+	volatile Uint32 late;		// frames released after playout began, consumer only
+} FrameQueue;
+
+// defined in FrameQueue.c
+void       FrameQueue_Init(FrameQueue *, FrameDesc *, Uint32, Uint32);
+Int32      FrameQueue_Push(FrameQueue *, void *);
+FrameDesc *FrameQueue_Peek(FrameQueue *);
+void       FrameQueue_Pop(FrameQueue *);
+Uint32     FrameQueue_Count(FrameQueue *);
+
+#endif
@@ -0,0 +1,255 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: FrameTimer.c
+//
+// Synopsis: Execution time statistics for ISRs and ProcessBuffer,
+//           measured with the time stamp counter.  On the DSP TSCL
+//           counts CPU cycles; on the host it reads the host's cycle
+//           counter, whose rate is measured once at start up.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "FrameTimer.h"
+
+static FrameTimer *Timers[FRAMETIMER_MAX];
+static Uint32 NumTimers = 0;
+static float DumpInterval = 0;			// seconds of signal between dumps
+static double TickRate = 0;
+
+#ifdef DSPBOARDTYPE_HOST
+#include <time.h>
+
+static double ElapsedSeconds(struct timespec *t0)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (t.tv_sec - t0->tv_sec) + 1e-9 * (t.tv_nsec - t0->tv_nsec);
+}
+#endif
+
+double FrameTimer_GetTickRate()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the rate of the time stamp counter
+//
+// Input:     None
+//
+// Returns:   TSCL ticks per second
+//
+// Calls:     clock_gettime on the host
+//
+// Notes:     The host counter is timed against the system clock over
+//            20 ms on the first call
+///////////////////////////////////////////////////////////////////////
+{
+#ifdef DSPBOARDTYPE_HOST
+	struct timespec t0;
+	Uint32 tsc0;
+
+	if(TickRate == 0) {
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		tsc0 = TSCL;
+		while(ElapsedSeconds(&t0) < 0.02)
+			;
+		TickRate = (Uint32)(TSCL - tsc0) / ElapsedSeconds(&t0);
+	}
+#else
+	TickRate = FRAMETIMER_DSP_CLOCK;
+#endif
+	return TickRate;
+}
+
+static void SetDumpCount(FrameTimer *t)
+{
+	double events = DumpInterval * FrameTimer_GetTickRate() / t->period;
+
+	t->dump_every = events >= 1 ? (Uint32)events : (DumpInterval > 0);
+	t->next_dump = t->count + t->dump_every;
+}
+
+void FrameTimer_Init(FrameTimer *t, char *name, float period)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Initializes a timer and adds it to those dumped
+//
+// Input:     t - timer
+//            name - label used in dumps
+//            period - deadline in seconds, e.g. BUFFER_COUNT/GetSampleFreq()
+//
+// Returns:   Nothing
+//
+// Calls:     FrameTimer_GetTickRate, FrameTimer_Reset
+//
+// Notes:     Starts TSCL on the DSP
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i;
+
+#ifndef DSPBOARDTYPE_HOST
+	TSCL = 0;							// any write starts the counter
+#endif
+	t->name = name;
+	t->period = (Uint32)(period * FrameTimer_GetTickRate());
+	if(t->period == 0)
+		t->period = 1;
+	FrameTimer_Reset(t);
+
+	for(i = 0; i < NumTimers; i++)
+		if(Timers[i] == t)
+			return;
+	if(NumTimers < FRAMETIMER_MAX)
+		Timers[NumTimers++] = t;
+}
+
+void FrameTimer_Reset(FrameTimer *t)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Clears the statistics of a timer
+//
+// Input:     t - timer
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Use to discard start-up intervals, e.g. cache misses
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i;
+
+	t->count = 0;
+	t->min = 0xFFFFFFFF;
+	t->max = 0;
+	t->sum = 0;
+	for(i = 0; i < FRAMETIMER_BINS; i++)
+		t->hist[i] = 0;
+	t->dump_due = 0;
+	SetDumpCount(t);
+}
+
+static Uint32 BinUpperEdge(Uint32 bin)
+{
+	Uint32 e = (bin >> 3) + 2;
+
+	if(bin < 16)
+		return bin + 1;
+	return (9 + (bin & 7)) << (e - 3);		// wraps to 0 for the last bin
+}
+
+void FrameTimer_GetStats(FrameTimer *t, FrameTimerStats *s)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Reports the statistics of a timer
+//
+// Input:     t - timer
+//            s - receives the statistics
+//
+// Returns:   Nothing
+//
+// Calls:     FrameTimer_GetTickRate
+//
+// Notes:     p99 is the upper edge of the histogram bin holding the
+//            99th percentile, so it is accurate to one bin width
+///////////////////////////////////////////////////////////////////////
+{
+	float us = 1e6 / FrameTimer_GetTickRate();
+	Uint32 count = t->count, above = 0, bin = FRAMETIMER_BINS;
+	Uint32 p99;
+
+	s->count = count;
+	s->period = t->period * us;
+	if(count == 0) {
+		s->min = s->mean = s->p99 = s->max = 0;
+		s->headroom = s->worst_headroom = 1;
+		return;
+	}
+
+	// find the bin where the longest 1% of intervals begins
+	while(bin > 0 && (above += t->hist[bin - 1]) <= count / 100)
+		bin--;
+	p99 = BinUpperEdge(bin - 1);
+	if(p99 > t->max || p99 == 0)
+		p99 = t->max;
+
+	s->min = t->min * us;
+	s->mean = t->sum / count * us;
+	s->p99 = p99 * us;
+	s->max = t->max * us;
+	s->headroom = 1 - (float)p99 / t->period;
+	s->worst_headroom = 1 - (float)t->max / t->period;
+}
+
+void FrameTimer_Dump(FrameTimer *t)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Prints the statistics of a timer
+//
+// Input:     t - timer
+//
+// Returns:   Nothing
+//
+// Calls:     FrameTimer_GetStats, printf
+//
+// Notes:     On the board printf halts the CPU for the debugger, so
+//            call it only where a missed frame does not matter
+///////////////////////////////////////////////////////////////////////
+{
+	FrameTimerStats s;
+
+	FrameTimer_GetStats(t, &s);
+	printf("%s: %u calls, min %.2f mean %.2f p99 %.2f max %.2f us of %.2f us, "
+		"headroom %.1f%% (worst %.1f%%)\n", t->name, s.count, s.min, s.mean,
+		s.p99, s.max, s.period, 100 * s.headroom, 100 * s.worst_headroom);
+}
+
+void FrameTimer_DumpAll()
+{
+	Uint32 i;
+
+	for(i = 0; i < NumTimers; i++)
+		FrameTimer_Dump(Timers[i]);
+	fflush(stdout);
+}
+
+void FrameTimer_SetDumpInterval(float seconds)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets how often FrameTimer_Poll prints each timer
+//
+// Input:     seconds - signal time between dumps, 0 for none
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Applies to timers initialized before and after the call
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i;
+
+	DumpInterval = seconds > 0 ? seconds : 0;
+	for(i = 0; i < NumTimers; i++)
+		SetDumpCount(Timers[i]);
+}
+
+void FrameTimer_Poll()
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Prints the timers that are due for a periodic dump
+//
+// Input:     None
+//
+// Returns:   Nothing
+//
+// Calls:     FrameTimer_Dump
+//
+// Notes:     Call from the main loop, not from an ISR
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i;
+
+	for(i = 0; i < NumTimers; i++) {
+		if(Timers[i]->dump_due) {
+			Timers[i]->dump_due = 0;
+			FrameTimer_Dump(Timers[i]);
+			fflush(stdout);
+		}
+	}
+}
@@ -0,0 +1,115 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: FrameTimer.h
+//
+// Synopsis: Execution time statistics for ISRs and ProcessBuffer.
+//           FrameTimer_Start/FrameTimer_Stop bracket the code being
+//           timed; each interval is compared with the deadline (one
+//           sample period for Codec_ISR, BUFFER_COUNT/Fs for a frame)
+//           and kept in a histogram for the min/mean/p99/max and
+//           headroom figures.  Replaces toggling WriteDigitalOutputs
+//           and watching a scope.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	FRAMETIMER_H_INCLUDED
+#define FRAMETIMER_H_INCLUDED
+
+#include "tistdtypes.h"
+#include <c6x.h>
+
+#define FRAMETIMER_BINS		240		// histogram bins, 8 per octave of ticks
+#define FRAMETIMER_MAX		8		// timers included in FrameTimer_DumpAll
+
+// CPU clock of the OMAP-L138 DSP, the rate TSCL counts at
+#define FRAMETIMER_DSP_CLOCK	456000000.0
+
+typedef struct {
+	char   *name;
+	Uint32 period;					// deadline in TSCL ticks
+	Uint32 start;					// TSCL at FrameTimer_Start
+	Uint32 count;					// intervals recorded
+	Uint32 min, max;				// in ticks
+	double sum;						// for the mean
+	Uint32 hist[FRAMETIMER_BINS];	// see FrameTimer_Bin
+	Uint32 dump_every;				// intervals between dumps, 0 for none
+	Uint32 next_dump;
+	volatile Uint8 dump_due;		// set by FrameTimer_Stop, cleared by FrameTimer_Poll
+} FrameTimer;
+
+typedef struct {
+	Uint32 count;					// intervals recorded
+	float  min, mean, p99, max;		// microseconds
+	float  period;					// deadline in microseconds
+	float  headroom;				// 1 - p99/period, unused share of the deadline
+	float  worst_headroom;			// 1 - max/period, negative if a deadline was missed
+} FrameTimerStats;
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Histogram bin of an interval
+//
+// Input:     ticks - interval length
+//
+// Returns:   ticks below 16, else 8 bins per power of two
+//
+// Calls:     _lmbd
+//
+// Notes:     Bins are at most 1/8 of their value wide, whatever the
+//            load, so p99 is within 12.5% for short and long intervals
+///////////////////////////////////////////////////////////////////////
+static inline Uint32 FrameTimer_Bin(Uint32 ticks)
+{
+	Uint32 e;
+
+	if(ticks < 16)
+		return ticks;
+	e = 31 - _lmbd(1, ticks);			// index of the leading 1
+	return ((e - 2) << 3) + ((ticks >> (e - 3)) & 7);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Mark the start and end of a timed interval
+//
+// Input:     t - timer
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Inline so that the timer adds only a few cycles to the
+//            code it brackets
+///////////////////////////////////////////////////////////////////////
+static inline void FrameTimer_Start(FrameTimer *t)
+{
+	t->start = TSCL;
+}
+
+static inline void FrameTimer_Stop(FrameTimer *t)
+{
+	Uint32 ticks = TSCL - t->start;
+
+	t->hist[FrameTimer_Bin(ticks)]++;
+	t->sum += ticks;
+	if(ticks < t->min)
+		t->min = ticks;
+	if(ticks > t->max)
+		t->max = ticks;
+	if(++t->count == t->next_dump) {
+		t->next_dump += t->dump_every;
+		t->dump_due = 1;
+	}
+}
+
+// defined in FrameTimer.c
+void   FrameTimer_Init(FrameTimer *, char *, float);
+void   FrameTimer_Reset(FrameTimer *);
+void   FrameTimer_GetStats(FrameTimer *, FrameTimerStats *);
+void   FrameTimer_Dump(FrameTimer *);
+void   FrameTimer_DumpAll();
+void   FrameTimer_SetDumpInterval(float);
+void   FrameTimer_Poll();
+double FrameTimer_GetTickRate();
+
+#endif
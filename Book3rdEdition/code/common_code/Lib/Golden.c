@@ -0,0 +1,283 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Golden.c
+//
+// Synopsis: Golden-output comparison of a candidate kernel with its
+//           reference.  Results accumulate over any number of blocks,
+//           so long streams are checked without storing them.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "Golden.h"
+
+#define GOLDEN_MAX_BLOCK	4096	// samples per kernel call in Golden_RunKernels
+
+void Golden_Init(Golden *g, char *name, Uint8 mode, double tolerance)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Starts a comparison
+//
+// Input:     g - comparison
+//            name - label used in the report
+//            mode - GOLDEN_EXACT, GOLDEN_ULP or GOLDEN_SNR
+//            tolerance - ULPs (LSBs for Int16) for GOLDEN_ULP,
+//                        minimum SNR in dB for GOLDEN_SNR
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	memset(g, 0, sizeof(Golden));
+	g->name = name;
+	g->mode = mode;
+	g->tolerance = mode == GOLDEN_EXACT ? 0 : tolerance;
+	g->first = -1;
+	g->max_ulp_at = -1;
+}
+
+Int32 Golden_ParseMode(Golden *g, const char *mode)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets the mode and tolerance from text
+//
+// Input:     g - comparison, initialized
+//            mode - "exact", "ulp:N" or "snr:dB"
+//
+// Returns:   1 on success, 0 if the text is not a mode
+//
+// Calls:     Nothing
+//
+// Notes:     Used for command line options and environment variables
+///////////////////////////////////////////////////////////////////////
+{
+	if(!strcmp(mode, "exact"))
+		g->mode = GOLDEN_EXACT;
+	else if(!strncmp(mode, "ulp:", 4))
+		g->mode = GOLDEN_ULP;
+	else if(!strncmp(mode, "snr:", 4))
+		g->mode = GOLDEN_SNR;
+	else
+		return 0;
+	g->tolerance = g->mode == GOLDEN_EXACT ? 0 : atof(mode + 4);
+	return 1;
+}
+
+Uint32 Golden_Ulps(float a, float b)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Distance between two floats in units in the last place
+//
+// Input:     a, b - values to compare
+//
+// Returns:   Number of representable floats between a and b
+//
+// Calls:     Nothing
+//
+// Notes:     +0 and -0 are 0 ULPs apart; a NaN is 0xFFFFFFFF ULPs
+//            from anything
+///////////////////////////////////////////////////////////////////////
+{
+	Int32 ia, ib;
+	long long oa, ob;
+
+	if(a != a || b != b)
+		return 0xFFFFFFFF;
+	memcpy(&ia, &a, 4);
+	memcpy(&ib, &b, 4);
+	// map sign-magnitude to a monotonic scale
+	oa = ia < 0 ? -(long long)(ia & 0x7FFFFFFF) : ia;
+	ob = ib < 0 ? -(long long)(ib & 0x7FFFFFFF) : ib;
+	return (Uint32)(oa > ob ? oa - ob : ob - oa);
+}
+
+static void Accumulate(Golden *g, double ref, double cand, Uint32 ulps, Uint8 same)
+{
+	double d = cand - ref;
+
+	g->signal += ref * ref;
+	g->noise += d * d;
+	if(!same) {
+		g->mismatches++;
+		if(fabs(d) > g->max_abs)
+			g->max_abs = fabs(d);
+		if(ulps > g->max_ulp) {
+			g->max_ulp = ulps;
+			g->max_ulp_at = g->count;
+		}
+		// SNR is judged over the whole stream, so any difference is
+		// the first divergence there
+		if(g->first < 0 && (g->mode != GOLDEN_ULP || ulps > g->tolerance)) {
+			g->first = g->count;
+			g->first_ref = ref;
+			g->first_cand = cand;
+		}
+	}
+	g->count++;
+}
+
+void Golden_CompareFloat(Golden *g, const float *ref, const float *cand, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Compares the next block of float outputs
+//
+// Input:     g - comparison
+//            ref - reference output
+//            cand - candidate output
+//            n - samples in each
+//
+// Returns:   Nothing
+//
+// Calls:     Golden_Ulps
+//
+// Notes:     Bit-exact means the same bit pattern, so -0 and +0 differ
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i;
+
+	for(i = 0; i < n; i++)
+		Accumulate(g, ref[i], cand[i], Golden_Ulps(ref[i], cand[i]),
+			!memcmp(&ref[i], &cand[i], sizeof(float)));
+}
+
+void Golden_CompareInt16(Golden *g, const Int16 *ref, const Int16 *cand, Uint32 n, Uint32 stride)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Compares the next block of Int16 outputs
+//
+// Input:     g - comparison
+//            ref - reference output
+//            cand - candidate output
+//            n - samples to compare
+//            stride - Int16s between samples, 2 for one channel of
+//                     codec words
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     One ULP is one LSB
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i;
+	Int32 d;
+
+	for(i = 0; i < n; i++, ref += stride, cand += stride) {
+		d = *cand - *ref;
+		Accumulate(g, *ref, *cand, d < 0 ? -d : d, d == 0);
+	}
+}
+
+void Golden_RunKernels(Golden *g, GoldenKernel ref, void *ref_state,
+	GoldenKernel cand, void *cand_state, Uint32 samples, Uint32 block, Uint32 seed)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Runs a reference and a candidate kernel side by side on
+//            the same noise and compares their outputs
+//
+// Input:     g - comparison
+//            ref, ref_state - reference kernel and its state
+//            cand, cand_state - candidate kernel and its state
+//            samples - length of the stream
+//            block - samples per call, 0 for random lengths 1..256
+//            seed - noise seed
+//
+// Returns:   Nothing
+//
+// Calls:     Golden_CompareFloat
+//
+// Notes:     The noise is the host codec's "noise:" input, codec
+//            samples up to -12 dBFS as floats.  Random block lengths
+//            check that a block kernel carries its state correctly
+//            across calls of any size.
+///////////////////////////////////////////////////////////////////////
+{
+	static float in[GOLDEN_MAX_BLOCK], y_ref[GOLDEN_MAX_BLOCK], y_cand[GOLDEN_MAX_BLOCK];
+	Uint32 lengths = seed ^ 0x9E3779B9, n, i;
+
+	if(block > GOLDEN_MAX_BLOCK)
+		block = GOLDEN_MAX_BLOCK;
+	while(samples > 0) {
+		if(block)
+			n = block;
+		else {
+			lengths = lengths * 1664525 + 1013904223;
+			n = 1 + (lengths >> 24);
+		}
+		if(n > samples)
+			n = samples;
+		for(i = 0; i < n; i++) {
+			seed = seed * 1664525 + 1013904223;
+			in[i] = (Int16)(seed >> 16) >> 2;
+		}
+		ref(ref_state, in, y_ref, n);
+		cand(cand_state, in, y_cand, n);
+		Golden_CompareFloat(g, y_ref, y_cand, n);
+		samples -= n;
+	}
+}
+
+double Golden_GetSNR(Golden *g)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Returns the signal to difference ratio so far
+//
+// Input:     g - comparison
+//
+// Returns:   10 log10(sum ref^2 / sum (cand-ref)^2) in dB, HUGE_VAL
+//            if the outputs are identical
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	if(g->noise == 0)
+		return HUGE_VAL;
+	if(g->signal == 0)
+		return -HUGE_VAL;
+	return 10 * log10(g->signal / g->noise);
+}
+
+Int32 Golden_Passed(Golden *g)
+{
+	if(g->mode == GOLDEN_SNR)
+		return Golden_GetSNR(g) >= g->tolerance;
+	return g->first < 0;
+}
+
+Int32 Golden_Report(Golden *g)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Prints the result of a comparison
+//
+// Input:     g - comparison
+//
+// Returns:   1 if the candidate passed, 0 if not
+//
+// Calls:     Golden_Passed, Golden_GetSNR, printf
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	static const char *Modes[] = {"bit-exact", "ulp", "snr"};
+	double snr = Golden_GetSNR(g);
+	Int32 passed = Golden_Passed(g);
+
+	printf("%s: %s %s", g->name, passed ? "PASS" : "FAIL", Modes[g->mode]);
+	if(g->mode == GOLDEN_ULP)
+		printf(" <= %g", g->tolerance);
+	else if(g->mode == GOLDEN_SNR)
+		printf(" >= %g dB", g->tolerance);
+	printf(", %u samples, %u differ, max %u ulp (sample %d), max |diff| %g, ",
+		g->count, g->mismatches, g->max_ulp, g->max_ulp_at, g->max_abs);
+	if(snr == HUGE_VAL)
+		printf("identical\n");
+	else
+		printf("SNR %.1f dB\n", snr);
+	if(g->first >= 0)
+		printf("%s: first divergence at sample %d: reference %.9g, candidate %.9g\n",
+			g->name, g->first, g->first_ref, g->first_cand);
+	fflush(stdout);
+	return passed;
+}
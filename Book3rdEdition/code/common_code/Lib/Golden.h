@@ -0,0 +1,53 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Golden.h
+//
+// Synopsis: Golden-output checks of a candidate kernel (SIMD, fixed
+//           point, block or FFT version) against the reference code it
+//           replaces.  Both are run on the same stream and compared
+//           sample by sample, bit-exact, within a number of ULPs, or
+//           above an SNR; the first sample outside the tolerance is
+//           reported.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	GOLDEN_H_INCLUDED
+#define GOLDEN_H_INCLUDED
+
+#include "tistdtypes.h"
+
+// comparison modes
+enum {GOLDEN_EXACT, GOLDEN_ULP, GOLDEN_SNR};
+
+// block kernel: out[0..n-1] from in[0..n-1], state carried between calls
+typedef void (*GoldenKernel)(void *state, const float *in, float *out, Uint32 n);
+
+typedef struct {
+	char   *name;
+	Uint8  mode;				// GOLDEN_EXACT, _ULP or _SNR
+	double tolerance;			// ULPs, or minimum SNR in dB
+	Uint32 count;				// samples compared
+	Int32  first;				// first sample outside the tolerance, -1 if none
+	double first_ref, first_cand;	// values at first
+	Uint32 mismatches;			// samples that differ at all
+	Uint32 max_ulp;				// largest difference in ULPs (LSBs for Int16)
+	Int32  max_ulp_at;
+	double max_abs;				// largest absolute difference
+	double signal, noise;		// sums of ref^2 and (cand-ref)^2
+} Golden;
+
+// defined in Golden.c
+void   Golden_Init(Golden *, char *, Uint8, double);
+Int32  Golden_ParseMode(Golden *, const char *);
+void   Golden_CompareFloat(Golden *, const float *, const float *, Uint32);
+void   Golden_CompareInt16(Golden *, const Int16 *, const Int16 *, Uint32, Uint32);
+void   Golden_RunKernels(Golden *, GoldenKernel, void *, GoldenKernel, void *,
+			Uint32, Uint32, Uint32);
+double Golden_GetSNR(Golden *);
+Int32  Golden_Passed(Golden *);
+Int32  Golden_Report(Golden *);
+Uint32 Golden_Ulps(float, float);
+
+#endif
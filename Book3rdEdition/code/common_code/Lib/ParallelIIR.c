@@ -0,0 +1,501 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: ParallelIIR.c
+//
+// Synopsis: Parallel form IIR filter, see ParallelIIR.h.  With the
+//           numerator B(w) and denominator A(w) = (1 - p1 w)...(1 - pN w)
+//           in w = z^-1, the constant d = B[N]/A[N] takes the top of B
+//           away (R = B - d A), and pole i has the residue
+//
+//           r_i = R(1/p_i) / product over k != i of (1 - p_k/p_i)
+//
+//           The poles of SOS rows are the roots of each row's
+//           quadratic; those of a transfer function are found all at
+//           once by Durand-Kerner iteration.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <math.h>
+#include "ParallelIIR.h"
+#include "Publish.h"
+#include "Biquad.h"
+
+#define PARALLELIIR_ITERATIONS	500		// Durand-Kerner limit
+
+typedef struct {
+	double re, im;
+} Root;
+
+static Root Mul(Root a, Root b)
+{
+	Root c;
+
+	c.re = a.re * b.re - a.im * b.im;
+	c.im = a.re * b.im + a.im * b.re;
+	return c;
+}
+
+static Root Div(Root a, Root b)
+{
+	Root c;
+	double d = b.re * b.re + b.im * b.im;
+
+	c.re = (a.re * b.re + a.im * b.im) / d;
+	c.im = (a.im * b.re - a.re * b.im) / d;
+	return c;
+}
+
+// p[0] + p[1] z + ... + p[n] z^n
+static Root Poly(const double *p, Uint32 n, Root z)
+{
+	Root v;
+
+	v.re = p[n];
+	v.im = 0;
+	while(n-- > 0) {
+		v = Mul(v, z);
+		v.re += p[n];
+	}
+	return v;
+}
+
+// p of degree n times q of degree m, in place in p; returns the new degree
+static Uint32 Multiply(double *p, Uint32 n, const double *q, Uint32 m)
+{
+	Uint32 i, j;
+	double sum;
+
+	for(i = n + m + 1; i-- > 0; ) {
+		sum = 0;
+		for(j = 0; j <= m && j <= i; j++)
+			if(i - j <= n)
+				sum += p[i-j] * q[j];
+		p[i] = sum;
+	}
+	return n + m;
+}
+
+// the n roots of z^n + a[1] z^(n-1) + ... + a[n]; returns 0 if out
+// of memory
+static Int32 Roots(const double *a, Uint32 n, Root *z)
+{
+	Root start = {0.4, 0.9}, num, den, d;
+	double *rev, change;
+	Uint32 i, k, j;
+
+	// Poly wants the coefficients from z^0 up
+	rev = malloc((n + 1) * sizeof(double));
+	if(rev == NULL)
+		return 0;
+	for(j = 0; j <= n; j++)
+		rev[j] = a[n-j];
+
+	z[0] = start;
+	for(k = 1; k < n; k++)
+		z[k] = Mul(z[k-1], start);
+	for(i = 0; i < PARALLELIIR_ITERATIONS; i++) {
+		change = 0;
+		for(k = 0; k < n; k++) {
+			num = Poly(rev, n, z[k]);
+			den.re = 1;
+			den.im = 0;
+			for(j = 0; j < n; j++)
+				if(j != k) {
+					d.re = z[k].re - z[j].re;
+					d.im = z[k].im - z[j].im;
+					den = Mul(den, d);
+				}
+			d = Div(num, den);
+			z[k].re -= d.re;
+			z[k].im -= d.im;
+			if(hypot(d.re, d.im) > change * (1 + hypot(z[k].re, z[k].im)))
+				change = hypot(d.re, d.im) / (1 + hypot(z[k].re, z[k].im));
+		}
+		if(change < 1e-15)
+			break;
+	}
+	free(rev);
+	return 1;
+}
+
+// one sample through the cascade that was converted, in double
+static double StepCascade(const ParallelIIR *f, double *s, double v)
+{
+	const double *b, *a;
+	Uint32 q = f->cascade_order, k, j;
+	double x0;
+
+	for(k = 0; k < f->cascade_sections; k++, s += q) {
+		b = f->cascade + k * (2 * q + 1);
+		a = b + q;
+		x0 = v;
+		v = b[0]*x0 + s[0];
+		for(j = 1; j < q; j++)
+			s[j-1] = b[j]*x0 - a[j]*v + s[j];
+		s[q-1] = b[q]*x0 - a[q]*v;
+	}
+	return v * f->cascade_gain;
+}
+
+// the partial fractions of B/A, n poles p, into f; allocates f's
+// arrays and keeps the cascade given, which is sections DF2T sections
+// of the order given.  Returns the memory, or NULL if the poles are
+// repeated or unpaired, the numerator's order is too high, or out of
+// memory.
+static void *Expand(ParallelIIR *f, double *B, Uint32 nb, const double *A, Root *p,
+	Uint32 n, const double *cascade, Uint32 sections, Uint32 order, double gain)
+{
+	Uint32 pairs = 0, reals = 0, i, k, m;
+	Root one = {1, 0}, w, num, den, t, r, held_r, held_p;
+	double *memory, d;
+	float *c;
+	Int32 held = 0;
+
+	if(n == 0 || nb > n)
+		return NULL;
+
+	// conjugate pairs must match, and no pole may repeat
+	for(i = 0; i < n; i++) {
+		if(fabs(p[i].im) <= 1e-9 * (1 + fabs(p[i].re)))
+			p[i].im = 0;
+		if(p[i].im > 0)
+			pairs++;
+		else if(p[i].im == 0)
+			reals++;
+		for(k = 0; k < i; k++)
+			if(hypot(p[i].re - p[k].re, p[i].im - p[k].im)
+				<= 1e-6 * (hypot(p[i].re, p[i].im) + hypot(p[k].re, p[k].im)))
+				return NULL;
+	}
+	if(2 * pairs + reals != n)
+		return NULL;
+
+	m = sections * (2 * order + 1);
+	f->sections = pairs + (reals + 1) / 2;
+	memory = malloc(m * sizeof(double) + f->sections * (4 + 2) * sizeof(float));
+	if(memory == NULL)
+		return NULL;
+	f->cascade = memory;
+	f->cascade_sections = sections;
+	f->cascade_order = order;
+	f->cascade_gain = gain;
+	f->c = (float *)(f->cascade + m);
+	f->state = f->c + 4 * f->sections;
+	for(i = 0; i < m; i++)
+		f->cascade[i] = cascade[i];
+
+	d = nb == n ? B[n] / A[n] : 0;
+	f->direct = (float)d;
+	for(i = 0; i <= nb; i++)
+		B[i] -= d * A[i];
+
+	c = f->c;
+	for(i = 0; i < n; i++) {
+		if(p[i].im < 0)
+			continue;
+		w = Div(one, p[i]);
+		num = Poly(B, nb, w);
+		den.re = 1;
+		den.im = 0;
+		for(k = 0; k < n; k++)
+			if(k != i) {
+				t = Mul(p[k], w);
+				t.re = 1 - t.re;
+				t.im = -t.im;
+				den = Mul(den, t);
+			}
+		r = Div(num, den);
+
+		if(p[i].im > 0) {
+			// r/(1 - p w) + its conjugate
+			c[0] = (float)(2 * r.re);
+			c[1] = (float)(-2 * (r.re * p[i].re + r.im * p[i].im));
+			c[2] = (float)(-2 * p[i].re);
+			c[3] = (float)(p[i].re * p[i].re + p[i].im * p[i].im);
+			c += 4;
+		}
+		else if(held) {
+			// two real poles over one denominator
+			c[0] = (float)(held_r.re + r.re);
+			c[1] = (float)(-(held_r.re * p[i].re + r.re * held_p.re));
+			c[2] = (float)(-(held_p.re + p[i].re));
+			c[3] = (float)(held_p.re * p[i].re);
+			c += 4;
+			held = 0;
+		}
+		else {
+			held_r = r;
+			held_p = p[i];
+			held = 1;
+		}
+	}
+	if(held) {
+		c[0] = (float)held_r.re;
+		c[1] = 0;
+		c[2] = (float)-held_p.re;
+		c[3] = 0;
+	}
+	return memory;
+}
+
+Int32 ParallelIIR_InitSOS(ParallelIIR *f, const float *sos, Uint32 sections,
+	Uint32 width, float gain)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Converts a cascade of second order sections to parallel
+//            form
+//
+// Input:     f - filter
+//            sos - sections rows of width coefficients, as for
+//                  Biquad_Init
+//            sections - number of rows
+//            width - 5 for rows {b0, b1, b2, -a1, -a2} (sos_dump2c.m),
+//                    6 for rows {b0, b1, b2, a0, a1, a2} (MATLAB sos)
+//            gain - overall gain, 1 if it is in the rows already
+//
+// Returns:   1 on success, 0 if the cascade has no parallel form (see
+//            ParallelIIR.h), out of memory or an argument is bad
+//
+// Calls:     malloc, Biquad_Row, Multiply, Expand, ParallelIIR_Reset
+//
+// Notes:     A row's poles are the roots of z^2 + a1 z + a2, so a
+//            complex pair comes out exactly conjugate
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 k, nb = 0, n = 0, degree;
+	double *cascade, *B, *A, *row, den[3], disc, q;
+	float c[5];
+	Root *p;
+	void *memory;
+
+	f->memory = NULL;
+	if(sections == 0 || (width != 5 && width != 6))
+		return 0;
+	cascade = malloc((5 * sections + 2 * (2 * sections + 1)) * sizeof(double)
+		+ 2 * sections * sizeof(Root));
+	if(cascade == NULL)
+		return 0;
+	B = cascade + 5 * sections;
+	A = B + 2 * sections + 1;
+	p = (Root *)(A + 2 * sections + 1);
+
+	B[0] = gain;
+	A[0] = 1;
+	for(k = 0; k < sections; k++) {
+		Biquad_Row(c, sos + k * width, width);
+		row = cascade + 5 * k;
+		row[0] = c[0];
+		row[1] = c[1];
+		row[2] = c[2];
+		row[3] = c[3];
+		row[4] = c[4];
+
+		degree = row[2] != 0 ? 2 : row[1] != 0 ? 1 : 0;
+		nb = Multiply(B, nb, row, degree);
+
+		// poles: roots of z^2 + a1 z + a2, the smaller of two real
+		// ones from the larger so that it keeps its precision
+		den[0] = 1;
+		den[1] = row[3];
+		den[2] = row[4];
+		if(row[4] != 0) {
+			disc = row[3] * row[3] - 4 * row[4];
+			if(disc < 0) {
+				p[n].re = p[n+1].re = -row[3] / 2;
+				p[n].im = sqrt(-disc) / 2;
+				p[n+1].im = -p[n].im;
+			}
+			else {
+				q = -(row[3] + (row[3] < 0 ? -sqrt(disc) : sqrt(disc))) / 2;
+				p[n].re = q;
+				p[n+1].re = row[4] / q;
+				p[n].im = p[n+1].im = 0;
+			}
+			Multiply(A, n, den, 2);
+			n += 2;
+		}
+		else if(row[3] != 0) {
+			p[n].re = -row[3];
+			p[n].im = 0;
+			Multiply(A, n, den, 1);
+			n++;
+		}
+	}
+
+	memory = Expand(f, B, nb, A, p, n, cascade, sections, 2, gain);
+	free(cascade);
+	if(memory == NULL)
+		return 0;
+	ParallelIIR_Reset(f);
+	PUBLISH(f->memory, memory);
+	return 1;
+}
+
+Int32 ParallelIIR_InitTF(ParallelIIR *f, const float *b, const float *a, Uint32 length)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Converts a transfer function to parallel form
+//
+// Input:     f - filter
+//            b - length numerator coefficients, such as the B of an
+//                IIR_dump2C.m header
+//            a - length denominator coefficients, a[0] is divided out
+//            length - N of the header, the filter order plus 1
+//
+// Returns:   1 on success, 0 if the filter has no parallel form (see
+//            ParallelIIR.h), out of memory or an argument is bad
+//
+// Calls:     malloc, Roots, Expand, ParallelIIR_Reset
+//
+// Notes:     Trailing zeros, as IIR_dump2C.m pads with, are not
+//            counted in the order
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 j, nb = 0, n = 0;
+	double *cascade, *B, *A;
+	Root *p;
+	void *memory;
+
+	f->memory = NULL;
+	if(length < 2 || a[0] == 0)
+		return 0;
+	for(j = 0; j < length; j++) {
+		if(b[j] != 0)
+			nb = j;
+		if(a[j] != 0)
+			n = j;
+	}
+	if(n == 0 || nb > n)
+		return 0;
+
+	// the cascade is one DF2T section of order n, b0..b[n], a1..a[n];
+	// A is also z^n + a1 z^(n-1) + ... + a[n], the polynomial of the poles
+	cascade = malloc((2 * n + 1 + 2 * (n + 1)) * sizeof(double) + n * sizeof(Root));
+	if(cascade == NULL)
+		return 0;
+	B = cascade + 2 * n + 1;
+	A = B + n + 1;
+	p = (Root *)(A + n + 1);
+	for(j = 0; j <= n; j++) {
+		B[j] = j <= nb ? (double)b[j] / a[0] : 0;
+		A[j] = (double)a[j] / a[0];
+		cascade[j] = B[j];
+		if(j > 0)
+			cascade[n + j] = A[j];
+	}
+
+	memory = NULL;
+	if(Roots(A, n, p))
+		memory = Expand(f, B, nb, A, p, n, cascade, 1, n, 1);
+	free(cascade);
+	if(memory == NULL)
+		return 0;
+	ParallelIIR_Reset(f);
+	PUBLISH(f->memory, memory);
+	return 1;
+}
+
+void ParallelIIR_Run(ParallelIIR *f, const float *x, float *y, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters a block of one channel
+//
+// Input:     f - filter from ParallelIIR_InitSOS or ParallelIIR_InitTF
+//            x - n new inputs
+//            y - receives the n outputs, may be x
+//            n - samples, 1 for a per-sample filter
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Every section of a sample is independent of the others
+//            until their outputs are added
+///////////////////////////////////////////////////////////////////////
+{
+	const float *c;
+	float *s, x0, v, sum;
+	Uint32 i, k;
+
+	for(i = 0; i < n; i++) {
+		x0 = x[i];
+		sum = f->direct * x0;
+		for(k = 0, c = f->c, s = f->state; k < f->sections; k++, c += 4, s += 2) {
+			v = c[0]*x0 + s[0];
+			s[0] = c[1]*x0 - c[2]*v + s[1];
+			s[1] = -c[3]*v;
+			sum += v;
+		}
+		y[i] = sum;
+	}
+}
+
+void ParallelIIR_Reset(ParallelIIR *f)
+{
+	Uint32 i;
+
+	for(i = 0; i < 2 * f->sections; i++)
+		f->state[i] = 0;
+}
+
+void ParallelIIR_Close(ParallelIIR *f)
+{
+	free(f->memory);
+	f->memory = NULL;
+}
+
+static void RunParallel(void *f, const float *in, float *out, Uint32 n)
+{
+	ParallelIIR_Run(f, in, out, n);
+}
+
+// the reference, the cascade run in double; its state follows the
+// ParallelIIR in the block Check allocates
+static void RunCascade(void *filter, const float *in, float *out, Uint32 n)
+{
+	ParallelIIR *f = filter;
+	Uint32 i;
+
+	for(i = 0; i < n; i++)
+		out[i] = (float)StepCascade(f, (double *)(f + 1), in[i]);
+}
+
+Int32 ParallelIIR_Check(ParallelIIR *f, Golden *g, Uint32 samples, Uint32 seed)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Compares the parallel form with the cascade it was
+//            converted from
+//
+// Input:     f - filter from ParallelIIR_InitSOS or ParallelIIR_InitTF
+//            g - comparison from Golden_Init, normally GOLDEN_SNR
+//            samples - length of the random test stream
+//            seed - of the stream
+//
+// Returns:   1 if the parallel outputs are within g's tolerance, 0 if
+//            not or out of memory
+//
+// Calls:     malloc, Golden_RunKernels, Golden_Passed, ParallelIIR_Reset
+//
+// Notes:     The cascade runs in double, so the difference is the
+//            error of the parallel form alone.  f is reset before and
+//            after.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 states = f->cascade_sections * f->cascade_order, m;
+	ParallelIIR *ref;
+	double *s;
+
+	ref = malloc(sizeof(ParallelIIR) + states * sizeof(double));
+	if(ref == NULL)
+		return 0;
+	*ref = *f;
+	s = (double *)(ref + 1);
+	for(m = 0; m < states; m++)
+		s[m] = 0;
+	ParallelIIR_Reset(f);
+
+	Golden_RunKernels(g, RunCascade, ref, RunParallel, f, samples, 0, seed);
+
+	free(ref);
+	ParallelIIR_Reset(f);
+	return Golden_Passed(g);
+}
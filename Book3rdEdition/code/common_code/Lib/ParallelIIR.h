@@ -0,0 +1,60 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: ParallelIIR.h
+//
+// Synopsis: IIR filter in parallel form.  A cascade passes each sample
+//           through one section after another, so no section can start
+//           before the one ahead of it has finished.  Split into
+//           partial fractions,
+//
+//           H(z) = d + sum over k of (b0 + b1 z^-1)/(1 + a1 z^-1 + a2 z^-2)
+//
+//           the sections all take the same input and their outputs are
+//           added, so the processor (or the C6000 compiler's software
+//           pipeline) can run them side by side.  Init does the
+//           conversion, in double, from the SOS rows of sos_dump2c.m or
+//           the B and A arrays of IIR_dump2C.m:
+//
+//           ParallelIIR_InitSOS(&iir, B[0], B_SIZE, 5, 1);
+//           ParallelIIR_Run(&iir, &input, &output, 1);  // in Codec_ISR
+//
+//           A complex pole pair makes one section, real poles are
+//           paired, and an odd real pole is a first order section
+//           (b1 = a2 = 0).  Repeated poles have no such expansion and
+//           are refused, as is a numerator of higher order than the
+//           denominator.  The sum rounds differently from the cascade,
+//           and nearly equal poles give large residues that cancel, so
+//           ParallelIIR_Check compares the result with the cascade it
+//           came from before it is used.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	PARALLELIIR_H_INCLUDED
+#define PARALLELIIR_H_INCLUDED
+
+#include "tistdtypes.h"
+#include "Golden.h"
+
+typedef struct {
+	Uint32 sections;		// parallel sections
+	float  direct;			// d, the path straight from input to output
+	float  *c;				// b0, b1, a1, a2 of each section
+	float  *state;			// DF2T s1, s2 of each section
+	Uint32 cascade_sections;	// the filter converted, kept for
+	Uint32 cascade_order;		// ParallelIIR_Check: DF2T sections of
+	double cascade_gain;		// this order, b0..b[order], a1..a[order]
+	double *cascade;			// each
+	void   *memory;			// set last by ParallelIIR_Init*, so non-NULL means ready
+} ParallelIIR;
+
+// defined in ParallelIIR.c
+Int32 ParallelIIR_InitSOS(ParallelIIR *, const float *, Uint32, Uint32, float);
+Int32 ParallelIIR_InitTF(ParallelIIR *, const float *, const float *, Uint32);
+void  ParallelIIR_Run(ParallelIIR *, const float *, float *, Uint32);
+void  ParallelIIR_Reset(ParallelIIR *);
+void  ParallelIIR_Close(ParallelIIR *);
+Int32 ParallelIIR_Check(ParallelIIR *, Golden *, Uint32, Uint32);
+
+#endif
@@ -0,0 +1,232 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: PartConv.c
+//
+// Synopsis: Uniformly partitioned overlap-save convolution, see
+//           PartConv.h.  As in FastConv.c, two channels share each
+//           complex FFT and the inverse is fft_c of the conjugate.
+//           Spectra are kept as separate real and imaginary arrays so
+//           the multiply-add over the partitions, the bulk of the
+//           work, runs on contiguous floats.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include "PartConv.h"
+
+#if defined(PARTCONV_NO_SIMD)
+#define PARTCONV_VLEN	1
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define PARTCONV_VLEN	8
+typedef __m256 ConvVec;
+#define ConvLoad(p)		_mm256_loadu_ps(p)
+#define ConvStore(p, v)	_mm256_storeu_ps(p, v)
+#define ConvAdd(a, b)	_mm256_add_ps(a, b)
+#define ConvSub(a, b)	_mm256_sub_ps(a, b)
+#define ConvMul(a, b)	_mm256_mul_ps(a, b)
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define PARTCONV_VLEN	4
+typedef __m128 ConvVec;
+#define ConvLoad(p)		_mm_loadu_ps(p)
+#define ConvStore(p, v)	_mm_storeu_ps(p, v)
+#define ConvAdd(a, b)	_mm_add_ps(a, b)
+#define ConvSub(a, b)	_mm_sub_ps(a, b)
+#define ConvMul(a, b)	_mm_mul_ps(a, b)
+#else
+#define PARTCONV_VLEN	1
+#endif
+
+static void MultiplyAdd(float *yr, float *yi, const float *xr, const float *xi,
+	const float *hr, const float *hi, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Adds the product of two spectra to a third
+//
+// Input:     yr, yi - accumulated spectrum
+//            xr, xi - input spectrum
+//            hr, hi - partition spectrum
+//            n - bins
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Runs parts times per frame, nearly all of the work
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i = 0;
+#if PARTCONV_VLEN > 1
+	ConvVec a, b, g, d;
+
+	for(; i + PARTCONV_VLEN <= n; i += PARTCONV_VLEN) {
+		a = ConvLoad(xr + i);
+		b = ConvLoad(xi + i);
+		g = ConvLoad(hr + i);
+		d = ConvLoad(hi + i);
+		ConvStore(yr + i, ConvAdd(ConvLoad(yr + i), ConvSub(ConvMul(a, g), ConvMul(b, d))));
+		ConvStore(yi + i, ConvAdd(ConvLoad(yi + i), ConvAdd(ConvMul(a, d), ConvMul(b, g))));
+	}
+#endif
+	for(; i < n; i++) {
+		yr[i] += xr[i] * hr[i] - xi[i] * hi[i];
+		yi[i] += xr[i] * hi[i] + xi[i] * hr[i];
+	}
+}
+
+Int32 PartConv_Init(PartConv *c, const float *h, Uint32 taps, Uint32 partition,
+	Uint32 channels)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up the convolution of an impulse response
+//
+// Input:     c - engine
+//            h - impulse response h[0..taps-1], copied into the
+//                partition spectra
+//            taps - response length, e.g. 96000 for 2 s at 48 kHz
+//            partition - samples per PartConv_Run, a power of 2, the
+//                        frame length
+//            channels - 1 or 2
+//
+// Returns:   1 on success, 0 if out of memory or an argument is bad
+//
+// Calls:     malloc, init_W, fft_c
+//
+// Notes:     Needs 4*parts*2P floats for the spectra, 3 MB for 96000
+//            taps, so on the DSP the heap must be in external memory
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i, k, n, size = 2 * partition, parts;
+	size_t bytes;
+	float *p;
+
+	c->memory = NULL;
+	if(taps == 0 || partition < 2 || (partition & (partition - 1))
+		|| channels == 0 || channels > 2)
+		return 0;
+	parts = (taps + partition - 1) / partition;
+	c->taps = taps;
+	c->partition = partition;
+	c->parts = parts;
+	c->size = size;
+	c->channels = channels;
+
+	bytes = 2 * size * sizeof(COMPLEX)
+		+ ((4 * parts + 2) * size + 2 * (2 * size + partition)) * sizeof(float);
+	if((c->memory = malloc(bytes)) == NULL)
+		return 0;
+	c->W = c->memory;
+	c->X = c->W + size;
+	p = (float *)(c->X + size);
+	c->Hr = p;	p += parts * size;
+	c->Hi = p;	p += parts * size;
+	c->Xr = p;	p += parts * size;
+	c->Xi = p;	p += parts * size;
+	c->Yr = p;	p += size;
+	c->Yi = p;	p += size;
+	for(k = 0; k < 2; k++) {
+		c->line[k].x = p;
+		c->line[k].length = size;
+		p += 2 * size;
+		c->y[k] = p;
+		p += partition;
+	}
+
+	// spectrum of each partition, zero padded to 2P
+	init_W(size, c->W);
+	for(k = 0; k < parts; k++) {
+		n = taps - k * partition < partition ? taps - k * partition : partition;
+		for(i = 0; i < size; i++) {
+			c->X[i].real = i < n ? h[k * partition + i] : 0;
+			c->X[i].imag = 0;
+		}
+		fft_c(size, c->X, c->W);
+		for(i = 0; i < size; i++) {
+			c->Hr[k * size + i] = c->X[i].real / size;
+			c->Hi[k * size + i] = c->X[i].imag / size;
+		}
+	}
+
+	PartConv_Reset(c);
+	return 1;
+}
+
+void PartConv_Run(PartConv *c)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters the last partition of samples put into the
+//            delay lines
+//
+// Input:     c - engine
+//
+// Returns:   Nothing, the outputs are in c->y[0] (and c->y[1])
+//
+// Calls:     DelayLine_Window, fft_c, MultiplyAdd
+//
+// Notes:     Put exactly c->partition samples into each line since
+//            the last call.  The outputs are those of the samples just
+//            put, so the only latency is that of collecting them.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i, k, s, size = c->size, P = c->partition;
+	const float *p = DelayLine_Window(&c->line[0], size), *q = DelayLine_Window(&c->line[1], size);
+	float *xr, *xi, *yr = c->Yr, *yi = c->Yi;
+	COMPLEX *X = c->X;
+
+	// spectrum of the last 2P inputs, both channels in one transform
+	for(i = 0; i < size; i++) {
+		X[i].real = p[i];
+		X[i].imag = c->channels == 2 ? q[i] : 0;
+	}
+	fft_c(size, X, c->W);
+
+	// it replaces the oldest in the frequency-domain delay line
+	c->newest = c->newest ? c->newest - 1 : c->parts - 1;
+	xr = c->Xr + c->newest * size;
+	xi = c->Xi + c->newest * size;
+	for(i = 0; i < size; i++) {
+		xr[i] = X[i].real;
+		xi[i] = X[i].imag;
+		yr[i] = yi[i] = 0;
+	}
+
+	// output spectrum: partition k meets the input k frames old
+	for(k = 0, s = c->newest; k < c->parts; k++) {
+		MultiplyAdd(yr, yi, c->Xr + s * size, c->Xi + s * size,
+			c->Hr + k * size, c->Hi + k * size, size);
+		if(++s >= c->parts)
+			s = 0;
+	}
+
+	// inverse transform, the second half is free of wrap-around
+	for(i = 0; i < size; i++) {
+		X[i].real = yr[i];
+		X[i].imag = -yi[i];
+	}
+	fft_c(size, X, c->W);
+	for(i = 0; i < P; i++)
+		c->y[0][i] = X[P + i].real;
+	if(c->channels == 2)
+		for(i = 0; i < P; i++)
+			c->y[1][i] = -X[P + i].imag;
+}
+
+void PartConv_Reset(PartConv *c)
+{
+	Uint32 i, k;
+
+	for(i = 0; i < c->parts * c->size; i++)
+		c->Xr[i] = c->Xi[i] = 0;
+	for(k = 0; k < 2; k++) {
+		for(i = 0; i < 2 * c->line[k].length; i++)
+			c->line[k].x[i] = 0;
+		c->line[k].head = 0;
+	}
+	c->newest = 0;
+}
+
+void PartConv_Close(PartConv *c)
+{
+	free(c->memory);
+	c->memory = NULL;
+}
@@ -0,0 +1,59 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: PartConv.h
+//
+// Synopsis: Uniformly partitioned convolution for impulse responses
+//           far longer than a frame (reverbs, room correction).  The
+//           response is cut into partitions of one frame, P samples,
+//           each transformed once with fft_c.  Every frame the last
+//           2P inputs are transformed and the spectrum enters a
+//           frequency-domain delay line; the output spectrum is the
+//           sum over partitions of each delayed input spectrum times
+//           its partition's spectrum, and one inverse FFT gives the P
+//           outputs.  The latency is one frame, and each sample costs
+//           two FFTs of 2P points shared by P samples plus 2*taps/P
+//           complex multiply-adds, against taps multiply-adds for
+//           direct form.
+//
+//           PartConv_Init(&rev, h, 96000, 128, 2);
+//           for(i = 0; i < 128; i++) {
+//               DelayLine_Put(&rev.line[0], left[i]);
+//               DelayLine_Put(&rev.line[1], right[i]);
+//           }
+//           PartConv_Run(&rev);          // rev.y[0], rev.y[1]
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	PARTCONV_H_INCLUDED
+#define PARTCONV_H_INCLUDED
+
+#include "tistdtypes.h"
+#include "fft.h"
+#include "DelayLine.h"
+
+typedef struct {
+	Uint32 taps;			// impulse response length
+	Uint32 partition;		// P, samples per PartConv_Run, a power of 2
+	Uint32 parts;			// partitions, taps/P rounded up
+	Uint32 size;			// FFT length, 2P
+	Uint32 channels;		// 1 or 2, filtered with the same response
+	Uint32 newest;			// delay line slot of the newest input spectrum
+	DelayLine line[2];		// last 2P inputs of each channel
+	float  *y[2];			// P outputs of each channel, from PartConv_Run
+	float  *Hr, *Hi;		// parts spectra of the partitions, scaled by 1/size
+	float  *Xr, *Xi;		// frequency-domain delay line, parts input spectra
+	float  *Yr, *Yi;		// output spectrum
+	COMPLEX *W;				// twiddle factors for fft_c
+	COMPLEX *X;				// segment being transformed
+	void   *memory;
+} PartConv;
+
+// defined in PartConv.c
+Int32 PartConv_Init(PartConv *, const float *, Uint32, Uint32, Uint32);
+void  PartConv_Run(PartConv *);
+void  PartConv_Reset(PartConv *);
+void  PartConv_Close(PartConv *);
+
+#endif
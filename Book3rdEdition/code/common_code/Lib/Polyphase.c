@@ -0,0 +1,290 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Polyphase.c
+//
+// Synopsis: Polyphase resampler, see Polyphase.h.  Interpolators
+//           (down == 1) compute all up phases of an input together,
+//           with vectors across the phases: each coefficient row
+//           h[j*up..j*up+up-1] is contiguous and meets one input, and
+//           every output is summed newest input first like the scalar
+//           loop y += x[j] * B[phase + up*j].  Decimators and rational
+//           resamplers take one phase per output, with vectors across
+//           its taps.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include "Polyphase.h"
+#include "Publish.h"
+
+#if defined(POLYPHASE_NO_SIMD)
+#define POLYPHASE_VLEN	1
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define POLYPHASE_VLEN	8
+typedef __m256 PolyVec;
+#define PolyZero()			_mm256_setzero_ps()
+#define PolySet(c)			_mm256_set1_ps(c)
+#define PolyLoad(p)			_mm256_loadu_ps(p)
+#define PolyStore(p, v)		_mm256_storeu_ps(p, v)
+#define PolyMac(a, p, q)	_mm256_add_ps(a, _mm256_mul_ps(PolyLoad(p), q))
+#define PolyAdd(a, b)		_mm256_add_ps(a, b)
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define POLYPHASE_VLEN	4
+typedef __m128 PolyVec;
+#define PolyZero()			_mm_setzero_ps()
+#define PolySet(c)			_mm_set1_ps(c)
+#define PolyLoad(p)			_mm_loadu_ps(p)
+#define PolyStore(p, v)		_mm_storeu_ps(p, v)
+#define PolyMac(a, p, q)	_mm_add_ps(a, _mm_mul_ps(PolyLoad(p), q))
+#define PolyAdd(a, b)		_mm_add_ps(a, b)
+#else
+#define POLYPHASE_VLEN	1
+#endif
+
+static void Interpolate(const float *h, Uint32 P, Uint32 up, const float *x, float *y)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Computes the up outputs of one input
+//
+// Input:     h - padded prototype, h[j*up + phase]
+//            P - taps per phase
+//            up - phases
+//            x - the input, with the P-1 before it at x[-1], x[-2], ...
+//            y - receives phases 0..up-1
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 k = 0, j;
+	float a;
+#if POLYPHASE_VLEN > 1
+	PolyVec c, a0, a1;
+
+	for(; k + 2 * POLYPHASE_VLEN <= up; k += 2 * POLYPHASE_VLEN) {
+		a0 = a1 = PolyZero();
+		for(j = 0; j < P; j++) {
+			c = PolySet(x[-(Int32)j]);
+			a0 = PolyMac(a0, h + j * up + k, c);
+			a1 = PolyMac(a1, h + j * up + k + POLYPHASE_VLEN, c);
+		}
+		PolyStore(y + k, a0);
+		PolyStore(y + k + POLYPHASE_VLEN, a1);
+	}
+	for(; k + POLYPHASE_VLEN <= up; k += POLYPHASE_VLEN) {
+		a0 = PolyZero();
+		for(j = 0; j < P; j++)
+			a0 = PolyMac(a0, h + j * up + k, PolySet(x[-(Int32)j]));
+		PolyStore(y + k, a0);
+	}
+#endif
+	for(; k < up; k++) {
+		a = 0;
+		for(j = 0; j < P; j++)
+			a += x[-(Int32)j] * h[j * up + k];
+		y[k] = a;
+	}
+}
+
+static float Dot(const float *b, const float *x, Uint32 P)
+{
+	Uint32 j = 0;
+	float a = 0;
+#if POLYPHASE_VLEN > 1
+	float s[POLYPHASE_VLEN];
+	PolyVec a0 = PolyZero(), a1 = PolyZero();
+	Uint32 k;
+
+	for(; j + 2 * POLYPHASE_VLEN <= P; j += 2 * POLYPHASE_VLEN) {
+		a0 = PolyMac(a0, b + j, PolyLoad(x + j));
+		a1 = PolyMac(a1, b + j + POLYPHASE_VLEN, PolyLoad(x + j + POLYPHASE_VLEN));
+	}
+	for(; j + POLYPHASE_VLEN <= P; j += POLYPHASE_VLEN)
+		a0 = PolyMac(a0, b + j, PolyLoad(x + j));
+	PolyStore(s, PolyAdd(a0, a1));
+	for(k = 0; k < POLYPHASE_VLEN; k++)
+		a += s[k];
+#endif
+	for(; j < P; j++)
+		a += b[j] * x[j];
+	return a;
+}
+
+// lays out the engine in memory (POLYPHASE_FLOATS of it) and copies h
+static void Setup(Polyphase *r, const float *h, Uint32 taps, Uint32 up, Uint32 down,
+	Uint32 block, float *p)
+{
+	Uint32 P = POLYPHASE_PHASE_TAPS(taps, up), j, k;
+
+	r->taps = taps;
+	r->up = up;
+	r->down = down;
+	r->phase_taps = P;
+	r->block = block;
+	r->line.x = p;
+	r->line.length = P - 1 + block;
+	p += 2 * r->line.length;
+	r->h = p;
+	p += P * up;
+	r->bank = p;
+	p += P * up;
+	r->y = p;
+
+	for(j = 0; j < P * up; j++)
+		r->h[j] = j < taps ? h[j] : 0;
+	for(k = 0; k < up; k++)
+		for(j = 0; j < P; j++)
+			r->bank[k * P + j] = r->h[(P - 1 - j) * up + k];
+	Polyphase_Reset(r);
+}
+
+Int32 Polyphase_Init(Polyphase *r, const float *h, Uint32 taps, Uint32 up,
+	Uint32 down, Uint32 block)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up a resampler in memory from the heap
+//
+// Input:     r - engine
+//            h - prototype filter h[0..taps-1] at up times the input
+//                rate, copied
+//            taps - prototype length
+//            up - interpolation factor, 1 for a decimator
+//            down - decimation factor, 1 for an interpolator
+//            block - most inputs per Polyphase_Run
+//
+// Returns:   1 on success, 0 if out of memory or an argument is 0
+//
+// Calls:     malloc, Setup
+//
+// Notes:     r->memory is published last (Publish.h), so an ISR that
+//            finds it non-NULL may use the engine even if Init ran in
+//            StartUp after the interrupts were enabled
+///////////////////////////////////////////////////////////////////////
+{
+	void *memory;
+
+	r->memory = NULL;
+	if(taps == 0 || up == 0 || down == 0 || block == 0)
+		return 0;
+	memory = malloc(POLYPHASE_FLOATS(taps, up, down, block) * sizeof(float));
+	if(memory == NULL)
+		return 0;
+	Setup(r, h, taps, up, down, block, memory);
+	r->allocated = 1;
+	PUBLISH(r->memory, memory);
+	return 1;
+}
+
+Int32 Polyphase_InitStatic(Polyphase *r, const float *h, Uint32 taps, Uint32 up,
+	Uint32 down, Uint32 block, float *memory, Uint32 floats)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets up a resampler in the caller's memory
+//
+// Input:     r - engine
+//            h, taps, up, down, block - as for Polyphase_Init
+//            memory - floats for the engine, kept until it is closed
+//            floats - size of memory, POLYPHASE_FLOATS(taps, up, down,
+//                     block) or more
+//
+// Returns:   1 on success, 0 if memory is too small or an argument is 0
+//
+// Calls:     Setup
+//
+// Notes:     As Polyphase_Init; Polyphase_Close leaves memory to the
+//            caller
+///////////////////////////////////////////////////////////////////////
+{
+	r->memory = NULL;
+	if(taps == 0 || up == 0 || down == 0 || block == 0 || memory == NULL
+		|| floats < POLYPHASE_FLOATS(taps, up, down, block))
+		return 0;
+	Setup(r, h, taps, up, down, block, memory);
+	r->allocated = 0;
+	PUBLISH(r->memory, memory);
+	return 1;
+}
+
+Uint32 Polyphase_Run(Polyphase *r, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Resamples the last n inputs put into the delay line
+//
+// Input:     r - engine
+//            n - inputs, at most r->block
+//
+// Returns:   The number of outputs in r->y, n*up/down give or take
+//            one
+//
+// Calls:     DelayLine_Window, Interpolate, Dot
+//
+// Notes:     Put exactly n samples into r->line since the last call
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i, count = 0, P = r->phase_taps, up = r->up;
+	const float *w = DelayLine_Window(&r->line, P - 1 + n);
+
+	if(r->down == 1) {
+		for(i = 0; i < n; i++, count += up)
+			Interpolate(r->h, P, up, w + P - 1 + i, r->y + count);
+		return count;
+	}
+
+	// output t uses phase t % up and the P inputs ending with input t / up
+	for(; r->t < n * up; r->t += r->down)
+		r->y[count++] = Dot(r->bank + (r->t % up) * P, w + r->t / up, P);
+	r->t -= n * up;
+	return count;
+}
+
+Uint32 Polyphase_Process(Polyphase *r, const float *in, Uint32 n, float *out)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Resamples a block of any length
+//
+// Input:     r - engine
+//            in - n inputs
+//            n - inputs
+//            out - receives the outputs, room for n*up/down + 1
+//
+// Returns:   The number of outputs
+//
+// Calls:     DelayLine_Put, Polyphase_Run
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i, k, m, count = 0;
+
+	while(n) {
+		k = n < r->block ? n : r->block;
+		for(i = 0; i < k; i++)
+			DelayLine_Put(&r->line, in[i]);
+		m = Polyphase_Run(r, k);
+		for(i = 0; i < m; i++)
+			out[count + i] = r->y[i];
+		count += m;
+		in += k;
+		n -= k;
+	}
+	return count;
+}
+
+void Polyphase_Reset(Polyphase *r)
+{
+	Uint32 i;
+
+	for(i = 0; i < 2 * r->line.length; i++)
+		r->line.x[i] = 0;
+	r->line.head = 0;
+	r->t = 0;
+}
+
+void Polyphase_Close(Polyphase *r)
+{
+	if(r->allocated)
+		free(r->memory);
+	r->memory = NULL;
+}
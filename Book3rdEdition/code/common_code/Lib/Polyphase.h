@@ -0,0 +1,68 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Polyphase.h
+//
+// Synopsis: Polyphase FIR resampler: interpolation by up, decimation
+//           by down, or both (a rate change of up/down).  The
+//           prototype filter h runs at up times the input rate and is
+//           split into up phases of taps/up coefficients.  Each
+//           output is the dot product of one phase with the last
+//           inputs, so the zeros an interpolator inserts are never
+//           multiplied and a decimator computes only the outputs it
+//           keeps.  Inputs are put into the engine's delay line, then
+//           a block is filtered at once:
+//
+//           Polyphase_Init(&shaper, B, 200, 20, 1, 1);   // 20x up
+//           DelayLine_Put(&shaper.line, symbol);
+//           n = Polyphase_Run(&shaper, 1);  // shaper.y[0..n-1]
+//
+//           h is not scaled: an interpolator's passband gain is
+//           sum(h)/up.  Polyphase_Init takes its memory from the heap;
+//           Polyphase_InitStatic uses an array of the caller's, which
+//           suits the board's small heap:
+//
+//           static float shaperMemory[POLYPHASE_FLOATS(200, 20, 1, 1)];
+//           Polyphase_InitStatic(&shaper, B, 200, 20, 1, 1, shaperMemory,
+//               POLYPHASE_FLOATS(200, 20, 1, 1));
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	POLYPHASE_H_INCLUDED
+#define POLYPHASE_H_INCLUDED
+
+#include "tistdtypes.h"
+#include "DelayLine.h"
+
+typedef struct {
+	Uint32 taps;			// prototype length
+	Uint32 up;				// interpolation factor, L
+	Uint32 down;			// decimation factor, M
+	Uint32 phase_taps;		// P, taps/up rounded up
+	Uint32 block;			// most inputs per Polyphase_Run
+	Uint32 t;				// next output, in 1/up inputs from the next block's first
+	DelayLine line;			// last P-1+block inputs
+	float  *y;				// outputs of the last Polyphase_Run
+	float  *h;				// prototype zero padded to P*up, h[j*up + phase]
+	float  *bank;			// each phase's P taps, oldest input's first
+	Uint32 allocated;		// memory is from malloc, freed by Polyphase_Close
+	void   *memory;			// set last by Polyphase_Init*, so non-NULL means ready
+} Polyphase;
+
+// floats of memory Polyphase_InitStatic needs for these arguments
+#define POLYPHASE_PHASE_TAPS(taps, up)	(((taps) + (up) - 1) / (up))
+#define POLYPHASE_FLOATS(taps, up, down, block) \
+	(2 * (POLYPHASE_PHASE_TAPS(taps, up) - 1 + (block)) \
+	+ 2 * POLYPHASE_PHASE_TAPS(taps, up) * (up) + ((block) * (up) + (down) - 1) / (down))
+
+// defined in Polyphase.c
+Int32  Polyphase_Init(Polyphase *, const float *, Uint32, Uint32, Uint32, Uint32);
+Int32  Polyphase_InitStatic(Polyphase *, const float *, Uint32, Uint32, Uint32, Uint32,
+			float *, Uint32);
+Uint32 Polyphase_Run(Polyphase *, Uint32);
+Uint32 Polyphase_Process(Polyphase *, const float *, Uint32, float *);
+void   Polyphase_Reset(Polyphase *);
+void   Polyphase_Close(Polyphase *);
+
+#endif
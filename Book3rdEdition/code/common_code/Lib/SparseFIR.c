@@ -0,0 +1,257 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: SparseFIR.c
+//
+// Synopsis: FIR filter over the nonzero taps only, see SparseFIR.h.
+//           The loops are those of BlockFIR_Folded with the tap
+//           index taken from the offset table, so every output is
+//           summed in the same order with the zero terms left out.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include "SparseFIR.h"
+#include "Publish.h"
+#include "BlockFIR.h"
+
+#if defined(SPARSEFIR_NO_SIMD)
+#define SPARSEFIR_VLEN	1
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define SPARSEFIR_VLEN	8
+typedef __m256 SparseVec;
+#define SparseZero()		_mm256_setzero_ps()
+#define SparseSet(c)		_mm256_set1_ps(c)
+#define SparseLoad(p)		_mm256_loadu_ps(p)
+#define SparseStore(p, v)	_mm256_storeu_ps(p, v)
+#define SparseAdd(a, b)		_mm256_add_ps(a, b)
+#define SparseSub(a, b)		_mm256_sub_ps(a, b)
+#define SparseMul(a, b)		_mm256_mul_ps(a, b)
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define SPARSEFIR_VLEN	4
+typedef __m128 SparseVec;
+#define SparseZero()		_mm_setzero_ps()
+#define SparseSet(c)		_mm_set1_ps(c)
+#define SparseLoad(p)		_mm_loadu_ps(p)
+#define SparseStore(p, v)	_mm_storeu_ps(p, v)
+#define SparseAdd(a, b)		_mm_add_ps(a, b)
+#define SparseSub(a, b)		_mm_sub_ps(a, b)
+#define SparseMul(a, b)		_mm_mul_ps(a, b)
+#else
+#define SPARSEFIR_VLEN	1
+#endif
+
+#define SPARSEFIR_BLOCK	(4 * SPARSEFIR_VLEN)	// outputs per pass over the taps
+
+#if SPARSEFIR_VLEN > 1
+// the input term of a tap at offset j, p the newest input and q the oldest
+static inline SparseVec Term(Int32 symmetry, const float *p, const float *q, Uint32 j)
+{
+	if(symmetry > 0)
+		return SparseAdd(SparseLoad(p - j), SparseLoad(q + j));
+	if(symmetry < 0)
+		return SparseSub(SparseLoad(p - j), SparseLoad(q + j));
+	return SparseLoad(p - j);
+}
+#endif
+
+static float Dot(const SparseFIR *f, const float *x)
+{
+	const float *p = x + f->taps - 1;
+	float y = 0;
+	Uint32 k, j;
+
+	if(f->symmetry > 0)
+		for(k = 0; k < f->count; k++) {
+			j = f->offset[k];
+			y += (p[-(Int32)j] + x[j]) * f->h[k];
+		}
+	else if(f->symmetry < 0)
+		for(k = 0; k < f->count; k++) {
+			j = f->offset[k];
+			y += (p[-(Int32)j] - x[j]) * f->h[k];
+		}
+	else
+		for(k = 0; k < f->count; k++)
+			y += p[-(Int32)f->offset[k]] * f->h[k];
+	if(f->center != 0)
+		y += x[f->taps / 2] * f->center;
+	return y;
+}
+
+Int32 SparseFIR_Init(SparseFIR *f, const float *b, Uint32 taps)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Analyzes a filter and keeps its nonzero taps
+//
+// Input:     f - filter
+//            b - coefficients b[0..taps-1], B[] of coeff.h, kept by
+//                reference
+//            taps - number of coefficients, N+1
+//
+// Returns:   1 on success, 0 if out of memory or taps is 0
+//
+// Calls:     malloc, BlockFIR_Symmetry
+//
+// Notes:     f->memory is published last (Publish.h), so an ISR that
+//            finds it non-NULL may use the filter even if Init ran in
+//            StartUp after the interrupts were enabled
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 j, k, span;
+	void *memory;
+
+	f->memory = NULL;
+	if(taps == 0)
+		return 0;
+	f->b = b;
+	f->taps = taps;
+	f->symmetry = BlockFIR_Symmetry(b, taps);
+
+	// a folded filter is described by its first half and its middle
+	span = f->symmetry == BLOCKFIR_GENERAL ? taps : taps / 2;
+	f->center = f->symmetry != BLOCKFIR_GENERAL && (taps & 1) ? b[taps / 2] : 0;
+	for(j = k = 0; j < span; j++)
+		k += b[j] != 0;
+	f->count = k;
+	f->dense = k == span;
+
+	memory = malloc((k ? k : 1) * (sizeof(float) + sizeof(Uint32)));
+	if(memory == NULL)
+		return 0;
+	f->h = memory;
+	f->offset = (Uint32 *)(f->h + (k ? k : 1));
+	for(j = k = 0; j < span; j++)
+		if(b[j] != 0) {
+			f->h[k] = b[j];
+			f->offset[k++] = j;
+		}
+
+	PUBLISH(f->memory, memory);
+	return 1;
+}
+
+void SparseFIR_Run(const SparseFIR *f, const float *x, float *y, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters a block of one channel
+//
+// Input:     f - filter from SparseFIR_Init
+//            x - taps-1 earlier inputs, oldest first, then the n new ones
+//            y - receives the n outputs
+//            n - outputs to compute, 1 for a per-sample filter
+//
+// Returns:   Nothing
+//
+// Calls:     BlockFIR_Folded, Dot
+//
+// Notes:     Each output takes count multiplies, plus one for the
+//            middle tap
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i = 0, k, j;
+	const float *p, *q;
+#if SPARSEFIR_VLEN > 1
+	Int32 s = f->symmetry;
+	SparseVec c, a0, a1, a2, a3;
+#else
+	float c, a0, a1, a2, a3;
+#endif
+
+	if(f->dense) {
+		BlockFIR_Folded(f->b, f->taps, f->symmetry, x, y, n);
+		return;
+	}
+	// p is the newest input of each output, q its oldest
+#if SPARSEFIR_VLEN > 1
+	for(; i + SPARSEFIR_BLOCK <= n; i += SPARSEFIR_BLOCK) {
+		a0 = a1 = a2 = a3 = SparseZero();
+		p = x + i + f->taps - 1;
+		q = x + i;
+		for(k = 0; k < f->count; k++) {
+			j = f->offset[k];
+			c = SparseSet(f->h[k]);
+			a0 = SparseAdd(a0, SparseMul(Term(s, p, q, j), c));
+			a1 = SparseAdd(a1, SparseMul(Term(s, p + SPARSEFIR_VLEN, q + SPARSEFIR_VLEN, j), c));
+			a2 = SparseAdd(a2, SparseMul(Term(s, p + 2 * SPARSEFIR_VLEN, q + 2 * SPARSEFIR_VLEN, j), c));
+			a3 = SparseAdd(a3, SparseMul(Term(s, p + 3 * SPARSEFIR_VLEN, q + 3 * SPARSEFIR_VLEN, j), c));
+		}
+		if(f->center != 0) {
+			c = SparseSet(f->center);
+			q += f->taps / 2;
+			a0 = SparseAdd(a0, SparseMul(SparseLoad(q), c));
+			a1 = SparseAdd(a1, SparseMul(SparseLoad(q + SPARSEFIR_VLEN), c));
+			a2 = SparseAdd(a2, SparseMul(SparseLoad(q + 2 * SPARSEFIR_VLEN), c));
+			a3 = SparseAdd(a3, SparseMul(SparseLoad(q + 3 * SPARSEFIR_VLEN), c));
+		}
+		SparseStore(y + i, a0);
+		SparseStore(y + i + SPARSEFIR_VLEN, a1);
+		SparseStore(y + i + 2 * SPARSEFIR_VLEN, a2);
+		SparseStore(y + i + 3 * SPARSEFIR_VLEN, a3);
+	}
+	for(; i + SPARSEFIR_VLEN <= n; i += SPARSEFIR_VLEN) {
+		a0 = SparseZero();
+		p = x + i + f->taps - 1;
+		q = x + i;
+		for(k = 0; k < f->count; k++)
+			a0 = SparseAdd(a0, SparseMul(Term(s, p, q, f->offset[k]), SparseSet(f->h[k])));
+		if(f->center != 0)
+			a0 = SparseAdd(a0, SparseMul(SparseLoad(q + f->taps / 2), SparseSet(f->center)));
+		SparseStore(y + i, a0);
+	}
+#else
+	for(; i + 4 <= n; i += 4) {
+		a0 = a1 = a2 = a3 = 0;
+		p = x + i + f->taps - 1;
+		q = x + i;
+		if(f->symmetry > 0)
+			for(k = 0; k < f->count; k++) {
+				j = f->offset[k];
+				c = f->h[k];
+				a0 += (p[0 - (Int32)j] + q[j]) * c;
+				a1 += (p[1 - (Int32)j] + q[j + 1]) * c;
+				a2 += (p[2 - (Int32)j] + q[j + 2]) * c;
+				a3 += (p[3 - (Int32)j] + q[j + 3]) * c;
+			}
+		else if(f->symmetry < 0)
+			for(k = 0; k < f->count; k++) {
+				j = f->offset[k];
+				c = f->h[k];
+				a0 += (p[0 - (Int32)j] - q[j]) * c;
+				a1 += (p[1 - (Int32)j] - q[j + 1]) * c;
+				a2 += (p[2 - (Int32)j] - q[j + 2]) * c;
+				a3 += (p[3 - (Int32)j] - q[j + 3]) * c;
+			}
+		else
+			for(k = 0; k < f->count; k++) {
+				j = f->offset[k];
+				c = f->h[k];
+				a0 += p[0 - (Int32)j] * c;
+				a1 += p[1 - (Int32)j] * c;
+				a2 += p[2 - (Int32)j] * c;
+				a3 += p[3 - (Int32)j] * c;
+			}
+		if(f->center != 0) {
+			c = f->center;
+			q += f->taps / 2;
+			a0 += q[0] * c;
+			a1 += q[1] * c;
+			a2 += q[2] * c;
+			a3 += q[3] * c;
+		}
+		y[i] = a0;
+		y[i + 1] = a1;
+		y[i + 2] = a2;
+		y[i + 3] = a3;
+	}
+#endif
+	for(; i < n; i++)
+		y[i] = Dot(f, x + i);
+}
+
+void SparseFIR_Close(SparseFIR *f)
+{
+	free(f->memory);
+	f->memory = NULL;
+}
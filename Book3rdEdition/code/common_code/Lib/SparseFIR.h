@@ -0,0 +1,50 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: SparseFIR.h
+//
+// Synopsis: FIR filter that skips the zero coefficients of a design.
+//           Half-band filters and Hilbert transformers from fir_dump2c
+//           have every other tap 0; SparseFIR_Init finds them once
+//           when the filter is loaded, folds linear phase filters as
+//           BlockFIR_Folded does, and keeps only the nonzero taps and
+//           their distances from the newest input.  Each output then
+//           reads its inputs at fixed offsets, so on the host the
+//           vector loops load contiguous runs of outputs with no
+//           gathers:
+//
+//           SparseFIR_Init(&hilbert, B, N+1);    // in StartUp
+//           SparseFIR_Run(&hilbert, DelayLine_Window(&x, N+1), &y, 1);
+//
+//           A zero tap adds an exact 0, so the output is bit-exact
+//           with BlockFIR (BlockFIR_Folded for linear phase designs).
+//           A design with no zero taps runs BlockFIR_Folded itself.
+//           Build with SPARSEFIR_NO_SIMD for the portable C path.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	SPARSEFIR_H_INCLUDED
+#define SPARSEFIR_H_INCLUDED
+
+#include "tistdtypes.h"
+
+typedef struct {
+	const float *b;			// coefficients b[0..taps-1] as loaded, by reference
+	Uint32 taps;			// N+1
+	Int32  symmetry;		// of b, BLOCKFIR_SYMMETRIC etc.
+	Uint32 count;			// nonzero taps kept, pairs of them when folded
+	Uint8  dense;			// 1 if none was dropped, Run calls BlockFIR_Folded
+	float  center;			// middle tap of an odd length folded filter, else 0
+	float  *h;				// the kept coefficients, in b's order
+	Uint32 *offset;			// each one's index j in b, its input's distance
+							//   from the newest (and, folded, the oldest)
+	void   *memory;			// set last by SparseFIR_Init, so non-NULL means ready
+} SparseFIR;
+
+// defined in SparseFIR.c
+Int32 SparseFIR_Init(SparseFIR *, const float *, Uint32);
+void  SparseFIR_Run(const SparseFIR *, const float *, float *, Uint32);
+void  SparseFIR_Close(SparseFIR *);
+
+#endif
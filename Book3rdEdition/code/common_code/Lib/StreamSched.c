@@ -0,0 +1,314 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: StreamSched.c
+//
+// Synopsis: Multi-channel block scheduler.  Each worker owns a range
+//           of channels; it takes channels from the front of its own
+//           range, and an idle worker steals the back half of another
+//           worker's range.  A range is one 64-bit word updated by
+//           compare-and-swap, so no locks are taken within a block.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifdef DSPBOARDTYPE_HOST
+#define _GNU_SOURCE
+#include <sched.h>
+#include <unistd.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "StreamSched.h"
+
+static void RunChannel(StreamSched *s, Uint32 c)
+{
+	StreamChannel *ch = &s->channels[c];
+
+	if(s->init)
+		ch->algorithm->init(ch->state);
+	else
+		ch->algorithm->process(ch->state, ch->in, ch->out, s->block);
+}
+
+#ifdef DSPBOARDTYPE_HOST
+#define RANGE(first, end)	((unsigned long long)(end) << 32 | (first))
+
+static Int32 TakeOwn(StreamWorker *w)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Takes the next channel from the front of a worker's range
+//
+// Input:     w - the calling worker
+//
+// Returns:   Channel number, -1 if the range is empty
+//
+// Calls:     Nothing
+//
+// Notes:     Races only with thieves, which move the end down
+///////////////////////////////////////////////////////////////////////
+{
+	unsigned long long r = __atomic_load_n(&w->range, __ATOMIC_ACQUIRE);
+	Uint32 first, end;
+
+	for(;;) {
+		first = (Uint32)r;
+		end = (Uint32)(r >> 32);
+		if(first >= end)
+			return -1;
+		if(__atomic_compare_exchange_n(&w->range, &r, RANGE(first + 1, end), 0,
+			__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+			return first;
+	}
+}
+
+static Int32 Steal(StreamSched *s, Uint32 me)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Moves the back half of another worker's channels to an
+//            idle worker
+//
+// Input:     s - scheduler
+//            me - the idle worker, whose range is empty
+//
+// Returns:   1 if channels were stolen, 0 if no worker has any left
+//
+// Calls:     Nothing
+//
+// Notes:     Victims are tried in order from the next worker on, so
+//            thieves spread over the workers.  The range of an idle
+//            worker is empty, so no other thread writes it while the
+//            stolen channels are stored there.
+///////////////////////////////////////////////////////////////////////
+{
+	StreamWorker *v;
+	unsigned long long r;
+	Uint32 i, first, end, mid;
+
+	for(i = 1; i < s->workers; i++) {
+		v = &s->worker[(me + i) % s->workers];
+		r = __atomic_load_n(&v->range, __ATOMIC_ACQUIRE);
+		for(;;) {
+			first = (Uint32)r;
+			end = (Uint32)(r >> 32);
+			if(first >= end)
+				break;
+			mid = first + (end - first) / 2;
+			if(__atomic_compare_exchange_n(&v->range, &r, RANGE(first, mid), 0,
+				__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+				__atomic_store_n(&s->worker[me].range, RANGE(mid, end), __ATOMIC_RELEASE);
+				__atomic_fetch_add(&s->steals, 1, __ATOMIC_RELAXED);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+static void RunWorker(StreamSched *s, Uint32 me)
+{
+	Int32 c;
+
+	do {
+		while((c = TakeOwn(&s->worker[me])) >= 0)
+			RunChannel(s, c);
+	} while(Steal(s, me));
+}
+
+static void *WorkerTask(void *arg)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Worker thread, runs its share of each block
+//
+// Input:     arg - the worker
+//
+// Returns:   NULL
+//
+// Calls:     RunWorker
+//
+// Notes:     The thread is pinned to one core where the host allows,
+//            so the channels it starts on stay in that core's cache
+///////////////////////////////////////////////////////////////////////
+{
+	StreamWorker *w = arg;
+	StreamSched *s = w->sched;
+	Uint32 me = w - s->worker, generation = 0;
+	Uint8 quit;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	cpu_set_t cpus;
+
+	if(cores > 1) {
+		CPU_ZERO(&cpus);
+		CPU_SET(me % cores, &cpus);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+	}
+	for(;;) {
+		pthread_mutex_lock(&s->lock);
+		while(s->generation == generation && !s->quit)
+			pthread_cond_wait(&s->start, &s->lock);
+		generation = s->generation;
+		quit = s->quit;
+		pthread_mutex_unlock(&s->lock);
+		if(quit)
+			return NULL;
+
+		RunWorker(s, me);
+
+		pthread_mutex_lock(&s->lock);
+		if(++s->idle == s->workers - 1)
+			pthread_cond_signal(&s->finish);
+		pthread_mutex_unlock(&s->lock);
+	}
+}
+#endif
+
+static void RunPass(StreamSched *s)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Runs every channel once, init or one block
+//
+// Input:     s - scheduler
+//
+// Returns:   When all channels are done
+//
+// Calls:     RunWorker, RunChannel
+//
+// Notes:     The calling thread is worker 0
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i;
+
+#ifdef DSPBOARDTYPE_HOST
+	for(i = 0; i < s->workers; i++)
+		s->worker[i].range = RANGE(s->worker[i].first, s->worker[i].end);
+	pthread_mutex_lock(&s->lock);
+	s->idle = 0;
+	s->generation++;
+	pthread_cond_broadcast(&s->start);
+	pthread_mutex_unlock(&s->lock);
+
+	RunWorker(s, 0);
+
+	pthread_mutex_lock(&s->lock);
+	while(s->idle < s->workers - 1)
+		pthread_cond_wait(&s->finish, &s->lock);
+	pthread_mutex_unlock(&s->lock);
+#else
+	for(i = 0; i < s->count; i++)
+		RunChannel(s, i);
+#endif
+}
+
+Int32 StreamSched_Init(StreamSched *s, const StreamAlgorithm *a, StreamChannel *channels,
+	Uint32 count, Uint32 workers)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Creates count channels of an algorithm and the workers
+//            that run them
+//
+// Input:     s - scheduler
+//            a - algorithm
+//            channels - count entries, filled in here; set in and out
+//                       before each StreamSched_Run
+//            count - number of channels
+//            workers - threads including the caller, 0 for one per core
+//
+// Returns:   1 on success, 0 if out of memory or threads
+//
+// Calls:     malloc, pthread_create, RunPass
+//
+// Notes:     Each state is aligned to a cache line and initialized by
+//            the worker that will run it, so it starts in that worker's
+//            cache (and, on NUMA hosts, its memory node).  Workers are
+//            limited to the number of channels.
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 stride = (a->size + STREAMSCHED_LINE - 1) & ~(STREAMSCHED_LINE - 1);
+	char *states;
+	Uint32 i;
+
+	memset(s, 0, sizeof(StreamSched));
+#ifdef DSPBOARDTYPE_HOST
+	if(workers == 0)
+		workers = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	workers = 1;
+#endif
+	if(workers > STREAMSCHED_MAX_WORKERS)
+		workers = STREAMSCHED_MAX_WORKERS;
+	if(workers > count)
+		workers = count;
+	if(workers == 0)
+		workers = 1;
+	s->channels = channels;
+	s->count = count;
+	s->workers = workers;
+
+	if((s->memory = malloc((size_t)stride * count + STREAMSCHED_LINE)) == NULL)
+		return 0;
+	states = (char *)(((size_t)s->memory + STREAMSCHED_LINE - 1) & ~(size_t)(STREAMSCHED_LINE - 1));
+	for(i = 0; i < count; i++) {
+		channels[i].algorithm = a;
+		channels[i].state = states + (size_t)i * stride;
+		channels[i].in = NULL;
+		channels[i].out = NULL;
+	}
+	// contiguous ranges, so neighbouring states share a worker
+	for(i = 0; i < workers; i++) {
+		s->worker[i].first = (Uint32)((unsigned long long)count * i / workers);
+		s->worker[i].end = (Uint32)((unsigned long long)count * (i + 1) / workers);
+	}
+
+#ifdef DSPBOARDTYPE_HOST
+	pthread_mutex_init(&s->lock, NULL);
+	pthread_cond_init(&s->start, NULL);
+	pthread_cond_init(&s->finish, NULL);
+	for(i = 1; i < workers; i++) {
+		s->worker[i].sched = s;
+		if(pthread_create(&s->worker[i].thread, NULL, WorkerTask, &s->worker[i])) {
+			s->workers = i;				// the ones started
+			StreamSched_Close(s);
+			return 0;
+		}
+	}
+#endif
+	s->init = 1;
+	RunPass(s);
+	s->init = 0;
+	return 1;
+}
+
+void StreamSched_Run(StreamSched *s, Uint32 n)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Processes one block on every channel
+//
+// Input:     s - scheduler
+//            n - samples in the block, the same for all channels
+//
+// Returns:   When all channels have been processed
+//
+// Calls:     RunPass
+//
+// Notes:     Each channel reads n samples from its in and writes n to
+//            its out
+///////////////////////////////////////////////////////////////////////
+{
+	s->block = n;
+	RunPass(s);
+}
+
+void StreamSched_Close(StreamSched *s)
+{
+	Uint32 i;
+
+#ifdef DSPBOARDTYPE_HOST
+	pthread_mutex_lock(&s->lock);
+	s->quit = 1;
+	pthread_cond_broadcast(&s->start);
+	pthread_mutex_unlock(&s->lock);
+	for(i = 1; i < s->workers; i++)
+		pthread_join(s->worker[i].thread, NULL);
+	pthread_mutex_destroy(&s->lock);
+	pthread_cond_destroy(&s->start);
+	pthread_cond_destroy(&s->finish);
+#endif
+	free(s->memory);
+	s->memory = NULL;
+	for(i = 0; i < s->count; i++)
+		s->channels[i].state = NULL;
+}
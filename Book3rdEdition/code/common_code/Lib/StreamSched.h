@@ -0,0 +1,82 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: StreamSched.h
+//
+// Synopsis: Runs one algorithm on many independent channels, a block
+//           of samples at a time.  Each channel is a state object
+//           (the ISR's globals gathered into a struct) with a block
+//           function.  On the host the channels of a block are shared
+//           among worker threads by work stealing: every worker starts
+//           on the same channels each block, so their state stays in
+//           its cache, and takes half of another worker's remaining
+//           channels when its own run out.  On the DSP the channels
+//           run one after another.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	STREAMSCHED_H_INCLUDED
+#define STREAMSCHED_H_INCLUDED
+
+#include "tistdtypes.h"
+#ifdef DSPBOARDTYPE_HOST
+#include <pthread.h>
+#endif
+
+#define STREAMSCHED_MAX_WORKERS	64
+#define STREAMSCHED_LINE		64		// cache line, channel states are aligned to it
+
+// block function: out[0..n-1] from in[0..n-1], state carried between calls
+typedef void (*StreamKernel)(void *state, const float *in, float *out, Uint32 n);
+
+// an algorithm that can be instantiated once per channel
+typedef struct {
+	char   *name;
+	Uint32 size;					// bytes of state per channel
+	void   (*init)(void *state);	// sets the state as the ISR's globals start
+	StreamKernel process;
+	Uint8  input;					// codec channel the ISR reads, LEFT (0) or RIGHT (1)
+} StreamAlgorithm;
+
+typedef struct {
+	const StreamAlgorithm *algorithm;
+	void   *state;
+	const float *in;				// block input, set before StreamSched_Run
+	float  *out;					// block output
+} StreamChannel;
+
+typedef struct {
+#ifdef DSPBOARDTYPE_HOST
+	volatile unsigned long long range;	// channels left: first | end << 32
+	pthread_t thread;
+	void   *sched;						// the StreamSched the worker belongs to
+	char   pad[STREAMSCHED_LINE];		// keep workers' ranges on separate lines
+#endif
+	Uint32 first, end;					// channels the worker starts each block on
+} StreamWorker;
+
+typedef struct {
+	StreamChannel *channels;
+	void   *memory;					// channel states
+	Uint32 count;					// channels
+	Uint32 workers;					// threads, including the caller's
+	Uint32 block;					// samples in the current block
+	Uint8  init;					// current pass initializes the states
+	Uint32 steals;					// ranges stolen, over all blocks
+	StreamWorker worker[STREAMSCHED_MAX_WORKERS];
+#ifdef DSPBOARDTYPE_HOST
+	pthread_mutex_t lock;
+	pthread_cond_t start, finish;
+	Uint32 generation;				// blocks started
+	Uint32 idle;					// workers done with the current block
+	Uint8  quit;
+#endif
+} StreamSched;
+
+// defined in StreamSched.c
+Int32 StreamSched_Init(StreamSched *, const StreamAlgorithm *, StreamChannel *, Uint32, Uint32);
+void  StreamSched_Run(StreamSched *, Uint32);
+void  StreamSched_Close(StreamSched *);
+
+#endif
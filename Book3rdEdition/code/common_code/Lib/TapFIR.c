@@ -0,0 +1,55 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: TapFIR.c
+//
+// Synopsis: Specialized filters for the tap counts of the coefficient
+//           headers in this book's programs, see TapFIR.h.  To add a
+//           count, define its filter and add it to the table.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include "TapFIR.h"
+
+TAPFIR_DEFINE(TapFIR_7, 7)		// DigRx hilbert.h, N 6
+TAPFIR_DEFINE(TapFIR_31, 31)	// FIRrevB-D, FiltFrm and PLL coeff.h, N 30
+TAPFIR_DEFINE(TapFIR_33, 33)	// AMrx coeff.h, N 33 taps
+TAPFIR_DEFINE(TapFIR_121, 121)	// DigRx matched_120.h, M 120
+TAPFIR_DEFINE(TapFIR_129, 129)	// GraphEq coeff*.h, N 128
+TAPFIR_DEFINE(TapFIR_201, 201)	// DigTxIM coeff.h, N 200
+
+static const struct {
+	Uint32 taps;
+	TapFIR filter;
+} Table[] = {
+	{7, TapFIR_7},
+	{31, TapFIR_31},
+	{33, TapFIR_33},
+	{121, TapFIR_121},
+	{129, TapFIR_129},
+	{201, TapFIR_201}
+};
+
+TapFIR TapFIR_Select(Uint32 taps)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Finds the specialized filter for a tap count
+//
+// Input:     taps - number of coefficients, N+1
+//
+// Returns:   The filter, or NULL if TapFIR.c has none for taps (use
+//            BlockFIR)
+//
+// Calls:     Nothing
+//
+// Notes:     Call once when the coefficients are loaded, not per block
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 k;
+
+	for(k = 0; k < sizeof(Table) / sizeof(Table[0]); k++)
+		if(Table[k].taps == taps)
+			return Table[k].filter;
+	return NULL;
+}
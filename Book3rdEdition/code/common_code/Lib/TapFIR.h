@@ -0,0 +1,158 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: TapFIR.h
+//
+// Synopsis: FIR filters specialized for a tap count known when the
+//           program is compiled, N+1 of coeff.h.  TAPFIR_DEFINE
+//           writes a filter with the count built in, so the compiler
+//           unrolls the tap loop of a single output completely (no
+//           counter, no branch, constant offsets), the ISR case.  On
+//           the host, blocks keep four SSE or AVX vectors of outputs
+//           in registers as BlockFIR does, unrolled eight taps deep:
+//
+//           #include "coeff.h"
+//           TAPFIR_DEFINE(Lowpass, N+1)       // at file scope
+//           ...
+//           Lowpass(B, DelayLine_Window(&left, N+1), &output, 1);
+//
+//           The arguments and sums are those of BlockFIR, so the
+//           output is bit-exact with it and with the scalar loop.
+//           When the count is only known at run time, TapFIR_Select
+//           returns the filter TapFIR.c defines for it, if any.
+//           Build with TAPFIR_NO_SIMD for the portable C path.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	TAPFIR_H_INCLUDED
+#define TAPFIR_H_INCLUDED
+
+#include "tistdtypes.h"
+
+// y[i] = sum of h[j] * x[i+taps-1-j], i = 0..n-1, see BlockFIR
+typedef void (*TapFIR)(const float *, const float *, float *, Uint32);
+
+#if defined(TAPFIR_NO_SIMD)
+#define TAPFIR_VLEN	1
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define TAPFIR_VLEN	8
+typedef __m256 TapVec;
+#define TapZero()		_mm256_setzero_ps()
+#define TapSet(c)		_mm256_set1_ps(c)
+#define TapStore(p, v)	_mm256_storeu_ps(p, v)
+#define TapMac(a, c, p)	_mm256_add_ps(a, _mm256_mul_ps(_mm256_loadu_ps(p), c))
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define TAPFIR_VLEN	4
+typedef __m128 TapVec;
+#define TapZero()		_mm_setzero_ps()
+#define TapSet(c)		_mm_set1_ps(c)
+#define TapStore(p, v)	_mm_storeu_ps(p, v)
+#define TapMac(a, c, p)	_mm_add_ps(a, _mm_mul_ps(_mm_loadu_ps(p), c))
+#else
+#define TAPFIR_VLEN	1
+#endif
+
+// the body must be inlined where taps is a constant; fully unrolled
+// vector loops of 100+ taps overflow the instruction cache
+#if defined(__GNUC__)
+#define TAPFIR_INLINE	static inline __attribute__((always_inline))
+#define TAPFIR_UNROLL	_Pragma("GCC unroll 256")
+#define TAPFIR_UNROLL_VEC	_Pragma("GCC unroll 8")
+#else
+#define TAPFIR_INLINE	static inline
+#define TAPFIR_UNROLL
+#define TAPFIR_UNROLL_VEC
+#endif
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Filters a block of one channel
+//
+// Input:     h - coefficients h[0..taps-1]
+//            taps - number of coefficients, a constant
+//            x - taps-1 earlier inputs, oldest first, then the n new ones
+//            y - receives the n outputs
+//            n - outputs to compute
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Only called through TAPFIR_DEFINE
+///////////////////////////////////////////////////////////////////////
+TAPFIR_INLINE void TapFIR_Body(const float *h, const Uint32 taps, const float *x,
+	float *y, Uint32 n)
+{
+	const float *p;
+	Uint32 i = 0, j;
+	float a;
+#if TAPFIR_VLEN > 1
+	TapVec c, a0, a1, a2, a3;
+
+	for(; i + 4 * TAPFIR_VLEN <= n; i += 4 * TAPFIR_VLEN) {
+		a0 = a1 = a2 = a3 = TapZero();
+		p = x + i + taps - 1;
+		TAPFIR_UNROLL_VEC
+		for(j = 0; j < taps; j++) {
+			c = TapSet(h[j]);
+			a0 = TapMac(a0, c, p - j);
+			a1 = TapMac(a1, c, p - j + TAPFIR_VLEN);
+			a2 = TapMac(a2, c, p - j + 2 * TAPFIR_VLEN);
+			a3 = TapMac(a3, c, p - j + 3 * TAPFIR_VLEN);
+		}
+		TapStore(y + i, a0);
+		TapStore(y + i + TAPFIR_VLEN, a1);
+		TapStore(y + i + 2 * TAPFIR_VLEN, a2);
+		TapStore(y + i + 3 * TAPFIR_VLEN, a3);
+	}
+	for(; i + TAPFIR_VLEN <= n; i += TAPFIR_VLEN) {
+		a0 = TapZero();
+		p = x + i + taps - 1;
+		TAPFIR_UNROLL_VEC
+		for(j = 0; j < taps; j++)
+			a0 = TapMac(a0, TapSet(h[j]), p - j);
+		TapStore(y + i, a0);
+	}
+#else
+	float c, a1, a2, a3;
+
+	for(; i + 4 <= n; i += 4) {
+		a = a1 = a2 = a3 = 0;
+		p = x + i + taps - 1;
+		TAPFIR_UNROLL
+		for(j = 0; j < taps; j++) {
+			c = h[j];
+			a  += p[-(Int32)j] * c;
+			a1 += p[1 - (Int32)j] * c;
+			a2 += p[2 - (Int32)j] * c;
+			a3 += p[3 - (Int32)j] * c;
+		}
+		y[i] = a;
+		y[i + 1] = a1;
+		y[i + 2] = a2;
+		y[i + 3] = a3;
+	}
+#endif
+	for(; i < n; i++) {
+		a = 0;
+		p = x + i + taps - 1;
+		TAPFIR_UNROLL
+		for(j = 0; j < taps; j++)
+			a += p[-(Int32)j] * h[j];
+		y[i] = a;
+	}
+}
+
+// defines static void name(h, x, y, n), a TapFIR for taps coefficients
+#define TAPFIR_DEFINE(name, taps)											\
+	static void name(const float *h, const float *x, float *y, Uint32 n)	\
+	{																		\
+		TapFIR_Body(h, taps, x, y, n);										\
+	}
+
+// defined in TapFIR.c
+TapFIR TapFIR_Select(Uint32);
+
+#endif
@@ -3,6 +3,9 @@
 
 // fft.h 
 
+#ifndef FFT_H_INCLUDED
+#define FFT_H_INCLUDED
+
 // define the COMPLEX structure
 typedef struct {
     float real, imag;
@@ -10,3 +13,5 @@ typedef struct {
 
 void fft_c(int, COMPLEX*, COMPLEX*);
 void init_W(int, COMPLEX*);
+
+#endif
@@ -22,14 +22,10 @@
 
 #pragma DATA_SECTION (buffer, "CE0"); // allocate buffers in SDRAM 
 Int16 buffer[NUM_BUFFERS][BUFFER_LENGTH];
-Int16 bufLeft[NUM_BUFFERS][BUFFER_LENGTH];
-Int16 bufRight[NUM_BUFFERS][BUFFER_LENGTH];
 // there are 3 buffers in use at all times, one being filled from the McBSP,
 // one being operated on, and one being emptied to the McBSP
 // ready_index --> buffer ready for processing
 volatile Int16 buffer_ready = 0, over_run = 0, ready_index = 0;
-float w[3] = {0.0,0.0,0.0};
-float v[3] = {0.0,0.0,0.0};
 
 // values used for EDMA channel initialization
 #define EDMA_CONFIG_RX_OPTION				0x00100000	// TCINTEN, event 0
@@ -194,98 +190,46 @@ void ProcessBuffer()
 //
 // Returns:   Nothing
 //
-// Calls:     Nothing
+// Calls:     DSPF_sp_biquad
 //
-// Notes:     None
+// Notes:     Each channel runs through the B_SECTIONS DF2T sections
+//            one frame at a time.  DSPF_sp_biquad needs different
+//            input and output arrays, so the sections alternate
+//            between two; the delays carry over to the next frame.
 ///////////////////////////////////////////////////////////////////////
 {   
 	Int16 *pBuf = buffer[ready_index];
-    // extra buffer room for convolution "edge effects"
-    // N is filter order from coeff.h
-	static float Left[BUFFER_COUNT+N]={0}, Right[BUFFER_COUNT+N]={0};
-	float *pL = Left, *pR = Right;
-	float y;
-	float yLeft, yRight;
-	float a[2][3], b[2][3];
-	float tmp;
-	float input;
-
-	Int32 i, j, k;
-
-    // offset pointers to start filling after N elements
-	pR += N;
-	pL += N;
+	static float Left[2][BUFFER_COUNT], Right[2][BUFFER_COUNT];
+	static float delayLeft[B_SECTIONS][2] = {0}, delayRight[B_SECTIONS][2] = {0};
+	Int32 i, k, in = 0;
 
     for(i = 0;i < BUFFER_COUNT;i++) { // extract data to float buffers
     // order is important here: must go right first then left
-    	*pR++ = *pBuf++;
-    	*pL++ = *pBuf++;
+    	Right[0][i] = *pBuf++;
+    	Left[0][i] = *pBuf++;
     }
 
-    // reinitialize pointer before FOR loop
-    pBuf = buffer[ready_index];
-
 ////////////////////////////////////////
-// Implement FIR filter
-// Ensure COEFF.C is part of project
+// Implement IIR filter, one section at a time
+// Ensure 4thIIRSOS.c is part of project
+// row k is {b0, b1, b2, a0, a1, a2}
 ////////////////////////////////////////  
-    for(j = 0; j < 3; j++){
-    	a[0][j] = B[0][j+3];
-    	a[1][j] = B[1][j+3];
-    	b[0][j] = B[0][j];
-    	b[1][j] = B[1][j];
+    for(k = 0; k < B_SECTIONS; k++, in ^= 1) {
+    	DSPF_sp_biquad(Right[in], B[k], &B[k][3], delayRight[k], Right[in ^ 1], BUFFER_COUNT);
+    	DSPF_sp_biquad(Left[in], B[k], &B[k][3], delayLeft[k], Left[in ^ 1], BUFFER_COUNT);
     }
 
-    for(i=0;i < BUFFER_COUNT;i++){
-    	yLeft  = 0;                      // initialize the LEFT output value
-    	yRight = 0;                      // initialize the RIGHT output value
-
-      /*for(j=0,k=i+N;j <= N;j++,k--){ 
-        yLeft  += Left[k] * B[j];        // perform the LEFT dot-product
-        yRight += Right[k] * B[j];        // perform the RIGHT dot-product
-      }*/
-    //	v[0] = Right[i+2] - Right[i+1]*a[0][1]*v[1] - Right[i]*a[0][2]*v[2];
-    	// tmp = b[0][0]*v[0] + b[0][1]*v[1] + b[0][2]*v[2];
-
-
-    	/*w[0] = tmp - a[1][1]*w[1] - a[1][2]*w[2];
-    	y = b[1][0]*w[0] + b[1][1]*w[1] + b[1][2]*w[2];
-
-    	w[2] = w[1];
-    	w[1] = w[0];
-    	v[2] = v[1];
-    	v[1] = v[0];*/
-    	for(j = 0; j < 2; j++){
-                v[0] = Right[i+j] - a[0][1] * v[1] - a[0][2] * v[2];
-                tmp = v[0] * b[0][0] + v[1] * b[0][1] + v[2] * b[0][2];
-                w[0] = tmp - a[1][1] * w[1] - a[1][2] * w[2];
-                y = w[0] * b[1][0] + w[1] * b[1][1] + w[2] * b[1][2];
-                w[2] = w[1];
-                w[1] = w[0];
-                v[2] = v[1];
-                v[1] = v[0];
-    	}
-
-    	yRight = Right[i];
-    	yLeft = Left[i];
+    // reinitialize pointer before FOR loop
+    pBuf = buffer[ready_index];
 
+    for(i = 0;i < BUFFER_COUNT;i++) {
     	// pack into buffer after bounding (must be right then left)
-    	*pBuf++ = _spint(yRight * 65536) >> 16;
-    	*pBuf++ = _spint(yLeft * 65536) >> 16;
-
-    }  
-
-   // save end values at end of buffer array for next pass
-   //  by placing at beginning of buffer array
-    for(i=BUFFER_COUNT,j=0;i < BUFFER_COUNT+N;i++,j++){ 
-    	Left[j]=Left[i];
-    	Right[j]=Right[i];
+    	*pBuf++ = _spint(Right[in][i] * 65536) >> 16;
+    	*pBuf++ = _spint(Left[in][i] * 65536) >> 16;
     }
 
-//////// end of FIR routine ///////////  
+//////// end of IIR routine ///////////  
 
-    // reinitialize pointer
-    pBuf = buffer[ready_index];
     buffer_ready = 0; // signal we are done
 }
 
@@ -0,0 +1,34 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: Publish.h
+//
+// Synopsis: Release store of the pointer that tells an ISR an engine
+//           is ready.  An Init that may run in StartUp after the
+//           interrupts were enabled sets up everything else first,
+//           then publishes its memory:
+//
+//           Setup(r, ...);
+//           PUBLISH(r->memory, memory);          // ISR tests r->memory
+//
+//           On the host the ISR is a thread of its own, so the store
+//           is an __atomic release and the engine's fields are
+//           visible to it before the pointer is.  On the DSP the ISR
+//           interrupts the same core, and only the compiler could move
+//           the field stores past the pointer; the empty asm statement
+//           keeps them before it, as the TI optimizer moves nothing
+//           across one.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	PUBLISH_H_INCLUDED
+#define PUBLISH_H_INCLUDED
+
+#ifdef DSPBOARDTYPE_HOST
+#define PUBLISH(dst, value)	__atomic_store_n(&(dst), (value), __ATOMIC_RELEASE)
+#else
+#define PUBLISH(dst, value)	do { asm(""); (dst) = (value); } while(0)
+#endif
+
+#endif
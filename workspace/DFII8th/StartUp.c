@@ -9,9 +9,14 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "DSP_Config.h"
+#include "DFII8th.h"
+#include "Biquad.h"
+
+extern Biquad sos;		// in IIRmono_ISRs.c
 
 
 void StartUp()
 {
-	;
+	// the gains are in the b coefficients (SOS2C.m), so the overall gain is 1
+	Biquad_Init(&sos, tmp[0], tmp_SECTIONS, 6, BIQUAD_DF2, 1);
 }
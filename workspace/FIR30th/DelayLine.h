@@ -0,0 +1,77 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: DelayLine.h
+//
+// Synopsis: Circular delay line with mirrored storage.  Each sample is
+//           written twice, length floats apart, so the most recent
+//           samples (up to length of them) always lie in one
+//           contiguous window, oldest first.  FIR loops then read
+//           *p-- or p[i] with no wrap checks, and frame programs need
+//           neither the end-of-frame history copy nor a frame-sized
+//           input array.
+//
+//           float x[2*(N+1)];                    // zeroed storage
+//           DelayLine d = {x, N+1, 0};           // or DelayLine_Init
+//
+//           DelayLine_Put(&d, input);
+//           p = DelayLine_Window(&d, N+1) + N;   // newest sample
+//           for(i = 0; i <= N; i++) y += *p-- * B[i];
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef	DELAYLINE_H_INCLUDED
+#define DELAYLINE_H_INCLUDED
+
+#include "tistdtypes.h"
+
+typedef struct {
+	float  *x;			// 2*length floats, each sample at head and head+length
+	Uint32 length;		// samples kept
+	Uint32 head;		// where the next sample goes, 0..length-1
+} DelayLine;
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Adds the newest sample, dropping the oldest
+//
+// Input:     d - delay line
+//            s - new sample
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     Inline, it runs once per sample in the ISRs
+///////////////////////////////////////////////////////////////////////
+static inline void DelayLine_Put(DelayLine *d, float s)
+{
+	Uint32 h = d->head;
+
+	d->x[h] = s;
+	d->x[h + d->length] = s;
+	d->head = h + 1 < d->length ? h + 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Locates the most recent samples
+//
+// Input:     d - delay line
+//            count - samples wanted, at most d->length
+//
+// Returns:   Pointer to the oldest of the last count samples; the
+//            newest is at [count-1]
+//
+// Calls:     Nothing
+//
+// Notes:     Valid until the next DelayLine_Put
+///////////////////////////////////////////////////////////////////////
+static inline float *DelayLine_Window(DelayLine *d, Uint32 count)
+{
+	return d->x + d->head + d->length - count;
+}
+
+// defined in DelayLine.c
+void DelayLine_Init(DelayLine *, float *, Uint32);
+
+#endif
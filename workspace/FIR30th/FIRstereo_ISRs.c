@@ -10,6 +10,8 @@
 
 #include "DSP_Config.h" 
 #include "FIR30th.h"	// load the filter coefficients, B[n] ... extern
+#include "DelayLine.h"
+#include "BlockFIR.h"
   
 // Data is received as 2 16-bit words (left/right) packed into one
 // 32-bit word.  The union allows the data to be accessed as a single 
@@ -27,8 +29,9 @@ volatile union {
 
 /* add any global variables here */
 
-float xLeft[B_LENGTH+1], xRight[B_LENGTH+1], yLeft, yRight;
-Int32 i;
+float xLeft[2*B_LENGTH];				// each sample stored twice, see DelayLine.h
+DelayLine left = {xLeft, B_LENGTH, 0};
+Int32 symmetry = BLOCKFIR_GENERAL;	// of B[], found by StartUp
 
 
 interrupt void Codec_ISR()
@@ -39,12 +42,15 @@ interrupt void Codec_ISR()
 //
 // Returns:   Nothing
 //
-// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData
+// Calls:     CheckForOverrun, ReadCodecData, WriteCodecData,
+//            DelayLine_Put, DelayLine_Window, BlockFIR_Folded
 //
-// Notes:     None
+// Notes:     Linear phase filters take (B_LENGTH+1)/2 multiplies per
+//            sample
 ///////////////////////////////////////////////////////////////////////
 {                    
 	/* add any local variables here */
+	float yLeft;
 
 
  	if(CheckForOverrun())					// overrun error occurred (i.e. halted DSP)
@@ -53,21 +59,12 @@ interrupt void Codec_ISR()
   	CodecDataIn.UINT = ReadCodecData();		// get input data samples
 	
 	/* I added my FIR filter routine here */ 
-	xLeft[0]  = CodecDataIn.Channel[LEFT];	// current LEFT input value
-	xRight[0] = CodecDataIn.Channel[RIGHT];	// current RIGHT input value
-	yLeft  = 0;				// initialize the LEFT output value
-	yRight = 0;				// initialize the RIGHT output value
-
-	for (i = 0; i <= B_LENGTH; i++) {
-		yLeft += xLeft[B_LENGTH - i]*B[i];	// perform the LEFT dot-product
-		yRight = xRight[i];	// perform the RIGHT dot-product
-	}
-	
-	// Shift the signal further to 1 bit and leave space for the new signal. [OK]
-	for (i = B_LENGTH; i > 0; i--) {
-		xLeft[ i] = xLeft[ i-1];        // setup xLeft[] for the next input
-		xRight[i] = xRight[i-1];     	// setup xRight[] for the next input
-	}
+	DelayLine_Put(&left, CodecDataIn.Channel[LEFT]);	// current LEFT input value
+
+	// perform the LEFT dot-product over the last B_LENGTH samples, no
+	// shifting; mirrored samples are added before the multiply if B[]
+	// has linear phase
+	BlockFIR_Folded(B, B_LENGTH, symmetry, DelayLine_Window(&left, B_LENGTH), &yLeft, 1);
 	
 	CodecDataOut.Channel[LEFT]  = yLeft;	// setup the LEFT value	
 	CodecDataOut.Channel[RIGHT] = CodecDataIn.Channel[RIGHT];	// setup the RIGHT value	
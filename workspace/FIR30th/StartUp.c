@@ -9,9 +9,13 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "DSP_Config.h"
+#include "FIR30th.h"
+#include "BlockFIR.h"
 
+extern Int32 symmetry;	// in FIRstereo_ISRs.c
 
 void StartUp()
 {
-	;
+	// fold the FIR from here on if B[] has linear phase
+	symmetry = BlockFIR_Symmetry(B, B_LENGTH);
 }
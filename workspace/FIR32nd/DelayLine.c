@@ -0,0 +1,37 @@
+// Welch, Wright, & Morrow,
+// Real-time Digital Signal Processing, 2017
+
+///////////////////////////////////////////////////////////////////////
+// Filename: DelayLine.c
+//
+// Synopsis: Set-up of the mirrored delay lines of DelayLine.h
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "DelayLine.h"
+
+void DelayLine_Init(DelayLine *d, float *storage, Uint32 length)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Attaches a delay line to its storage and clears it
+//
+// Input:     d - delay line
+//            storage - 2*length floats
+//            length - samples kept, N+1 for an Nth order FIR, N+block
+//                     for one filtering block outputs at a time
+//
+// Returns:   Nothing
+//
+// Calls:     Nothing
+//
+// Notes:     A zeroed static array and {storage, length, 0} give the
+//            same start
+///////////////////////////////////////////////////////////////////////
+{
+	Uint32 i;
+
+	d->x = storage;
+	d->length = length;
+	d->head = 0;
+	for(i = 0; i < 2 * length; i++)
+		storage[i] = 0;
+}
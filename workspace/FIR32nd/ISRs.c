@@ -15,20 +15,26 @@
 #include "frames.h"  
 //#include "coeff.h"      // load the filter coefficients, B[n] ... extern
 #include "FIR32nd.h"
+#include "BlockFIR.h"
+#include "DelayLine.h"
 
 // frame buffer declarations
 //#define BUFFER_COUNT		1024   // buffer length in McASP samples (L+R)
-#define BUFFER_COUNT        128   // buffer length in McASP samples (L+R)
-#define BUFFER_LENGTH   	BUFFER_COUNT*2 // two Int16 read from McASP each time
+#define BUFFER_COUNT        128   // default frame length in McASP samples (L+R)
+#define BUFFER_COUNT_MAX	4096   // longest frame, sets the buffer storage
+#define BUFFER_LENGTH   	BUFFER_COUNT_MAX*2 // two Int16 read from McASP each time
 //#define BUFFER_LENGTH       256 // two Int16 read from McASP each time
 #define NUM_BUFFERS     	3     // don't change this! 
+#define FIR_BLOCK			64    // outputs per BlockFIR call
 
 #pragma DATA_SECTION (buffer, "CE0"); // allocate buffers in SDRAM 
 Int16 buffer[NUM_BUFFERS][BUFFER_LENGTH];
+Uint32 buffer_count = BUFFER_COUNT; // frame length in use, see SetFrameSize
 // there are 3 buffers in use at all times, one being filled from the McBSP,
 // one being operated on, and one being emptied to the McBSP
 // ready_index --> buffer ready for processing
 volatile Int16 buffer_ready = 0, over_run = 0, ready_index = 0;
+Int32 symmetry = BLOCKFIR_GENERAL; // of B[], found by ZeroBuffers
 
 // values used for EDMA channel initialization
 #define EDMA_CONFIG_RX_OPTION				0x00100000	// TCINTEN, event 0
@@ -38,7 +44,7 @@ volatile Int16 buffer_ready = 0, over_run = 0, ready_index = 0;
 #define EDMA_CONFIG_RX_SRC_ADDR				((Uint32)(&(McASP0_Base->rbuf[12])))
 #endif
 #define EDMA_CONFIG_RX_SRC_DEST_B_INDEX		((4 << 16) + 0)	// src_b_index = 0, dest_b_index = 4
-#define EDMA_CONFIG_RX_A_B_COUNT			((BUFFER_COUNT << 16) + 4)	// 4-byte transfers
+#define EDMA_CONFIG_RX_A_B_COUNT			((buffer_count << 16) + 4)	// 4-byte transfers
 #define EDMA_CONFIG_TX_OPTION				0x00101000	// TCINTEN, event 1
 #ifdef DSPBOARDTYPE_TI_OMAPL138_LCDK
 #define EDMA_CONFIG_TX_DEST_ADDR			((Uint32)(&(McASP0_Base->xbuf[13])))
@@ -69,7 +75,7 @@ void EDMA_Init()
 //
 // Calls:     Nothing
 //
-// Notes:     None
+// Notes:     The frames are buffer_count samples long
 ///////////////////////////////////////////////////////////////////////
 {
 	EDMA_params* param;
@@ -81,7 +87,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
 	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
 	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up first tx link param
@@ -91,7 +97,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
 	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
 	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(65) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(65) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up second tx link param
@@ -101,7 +107,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
 	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
 	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(66) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(66) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up third tx link param
@@ -111,7 +117,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_TX_A_B_COUNT;
 	param->dest = EDMA_CONFIG_TX_DEST_ADDR;
 	param->src_dest_b_index = EDMA_CONFIG_TX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(64) & 0xFFFF);
 	param->c_count = 1;
 	
 	
@@ -122,7 +128,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
 	param->dest = (Uint32)(&buffer[1][0]);
 	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(67) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(67) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up first rx link param
@@ -132,7 +138,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
 	param->dest = (Uint32)(&buffer[2][0]);
 	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(68) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(68) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up second rx link param
@@ -142,7 +148,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
 	param->dest = (Uint32)(&buffer[0][0]);
 	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(69) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(69) & 0xFFFF);
 	param->c_count = 1;
 	
 	// set up third rx link param
@@ -152,7 +158,7 @@ void EDMA_Init()
 	param->a_b_count = EDMA_CONFIG_RX_A_B_COUNT;
 	param->dest = (Uint32)(&buffer[1][0]);
 	param->src_dest_b_index = EDMA_CONFIG_RX_SRC_DEST_B_INDEX;
-	param->link_reload = (BUFFER_COUNT << 16) + (EDMA3_0_PARAM(67) & 0xFFFF);
+	param->link_reload = (buffer_count << 16) + (EDMA3_0_PARAM(67) & 0xFFFF);
 	param->c_count = 1;
 	
 	// configure EDMA to start servicing events
@@ -170,16 +176,60 @@ void ZeroBuffers()
 //
 // Returns:   Nothing
 //
-// Calls:     Nothing
+// Calls:     BlockFIR_Symmetry
 //
-// Notes:     None
+// Notes:     Also restarts the buffer ring, for a new EDMA_Init, and
+//            finds whether B[] has linear phase, for ProcessBuffer
 ///////////////////////////////////////////////////////////////////////
 {
-    Int32 i = BUFFER_COUNT * NUM_BUFFERS;
+    Int32 i = BUFFER_COUNT_MAX * NUM_BUFFERS;
     Int32 *p = (Int32 *)buffer;
 
     while(i--)
         *p++ = 0;
+
+    ready_index = 0;
+    buffer_ready = 0;
+    over_run = 0;
+
+    // fold the FIR from here on if B[] has linear phase
+    symmetry = BlockFIR_Symmetry(B, N+1);
+}
+
+Int32 SetFrameSize(Uint32 count)
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Sets the frame length
+//
+// Input:     count - McASP samples (L+R) per frame
+//
+// Returns:   1 on success, 0 if count is 0 or above BUFFER_COUNT_MAX
+//
+// Calls:     Nothing
+//
+// Notes:     Call before ZeroBuffers and EDMA_Init.  Latency is two
+//            frames, and ProcessBuffer must finish within one.
+///////////////////////////////////////////////////////////////////////
+{
+    if(count == 0 || count > BUFFER_COUNT_MAX)
+        return 0;
+    buffer_count = count;
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////
+// Purpose:   Access function for the frame length 
+//
+// Input:     None
+//
+// Returns:   McASP samples (L+R) per frame
+//
+// Calls:     Nothing
+//
+// Notes:     None
+///////////////////////////////////////////////////////////////////////
+Uint32 GetFrameSize()
+{
+    return buffer_count;
 }
 
 void ProcessBuffer()
@@ -193,62 +243,50 @@ void ProcessBuffer()
 //
 // Returns:   Nothing
 //
-// Calls:     Nothing
+// Calls:     DelayLine_Put, DelayLine_Window, BlockFIR_Folded
 //
-// Notes:     None
+// Notes:     Filters FIR_BLOCK samples at a time, so the filter's
+//            storage does not depend on the frame length.  Linear
+//            phase filters take (N+1)/2 multiplies per output.
 ///////////////////////////////////////////////////////////////////////
 {   
-    Int16 *pBuf = buffer[ready_index];
-    // extra buffer room for convolution "edge effects"
-    // N is filter order from coeff.h
-    static float Left[BUFFER_COUNT+N]={0}, Right[BUFFER_COUNT+N]={0};
-    float *pL = Left, *pR = Right;
-    float yLeft, yRight;
-    Int32 i, j, k;
-    
-    // offset pointers to start filling after N elements
-    pR += N;
-    pL += N;
+    Int16 *pBuf = buffer[ready_index], *pOut = buffer[ready_index];
+    // N samples of history plus one block, each sample stored twice
+    // so the block's inputs are contiguous (DelayLine.h)
+    // N is filter order from FIR32nd.h
+    static float xLeft[2*(N+FIR_BLOCK)];
+    static DelayLine left = {xLeft, N+FIR_BLOCK, 0};
+    static float yLeft[FIR_BLOCK];
+    Int32 i, j, n;
 
-    for(i = 0;i < BUFFER_COUNT;i++) { // extract data to float buffers
-    // order is important here: must go right first then left
-       *pR++ = *pBuf++;
-       *pL++ = *pBuf++;
-    }
-
-    // reinitialize pointer before FOR loop
-    pBuf = buffer[ready_index];
-      
 ////////////////////////////////////////
 // Implement FIR filter
-// Ensure COEFF.C is part of project
+// Ensure FIR32nd.c is part of project
 ////////////////////////////////////////  
-   for(i=0;i < BUFFER_COUNT;i++){ 
-      yLeft  = 0;                      // initialize the LEFT output value
-      //yRight = 0;                      // initialize the RIGHT output value
-      
-      for(j=0,k=i+N;j <= N;j++,k--){ 
-        yLeft  += Left[k] * B[j];        // perform the LEFT dot-product
-        //yRight += Right[k] * B[j];        // perform the RIGHT dot-product
+   for(i=0;i < buffer_count;i+=n){ 
+      n = buffer_count - i < FIR_BLOCK ? buffer_count - i : FIR_BLOCK;
+
+      for(j=0;j < n;j++){ // extract data to the delay line
+      // order is important here: must go right first then left
+         //DelayLine_Put(&right, *pBuf);
+         pBuf++;
+         DelayLine_Put(&left, *pBuf++);
+      }
+
+      // the LEFT dot-products for the block, several outputs at a time;
+      // mirrored samples are added before the multiply if B[] is symmetric
+      BlockFIR_Folded(B, N+1, symmetry, DelayLine_Window(&left, N+n), yLeft, n);
+
+      // outputs go behind the inputs already read
+      for(j=0;j < n;j++){ 
+         // pack into buffer after bounding (must be right then left)
+         //*pOut++ = _spint(yRight[j] * 65536) >> 16;
+         *pOut++ = _spint(yLeft[j] * 65536) >> 16;
       }
-      
-      // pack into buffer after bounding (must be right then left)
-      //*pBuf++ = _spint(yRight * 65536) >> 16;
-      *pBuf++ = _spint(yLeft * 65536) >> 16;
    }  
-  
-   // save end values at end of buffer array for next pass
-   //  by placing at beginning of buffer array
-   for(i=BUFFER_COUNT,j=0;i < BUFFER_COUNT+N;i++,j++){ 
-      Left[j]=Left[i];
-      //Right[j]=Right[i];
-   }
 
 //////// end of FIR routine ///////////  
 
-    // reinitialize pointer
-    pBuf = buffer[ready_index];
-
     buffer_ready = 0; // signal we are done
 }
 
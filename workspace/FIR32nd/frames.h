@@ -10,6 +10,8 @@
 
 // defined in ISRs.c
 void ZeroBuffers();
+Int32 SetFrameSize(Uint32);
+Uint32 GetFrameSize();
 void ProcessBuffer();
 int IsBufferReady();
 int IsOverRun();
@@ -9,9 +9,13 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "DSP_Config.h"
+#include "coeff.h"
+#include "BlockFIR.h"
 
+extern Int32 symmetry;	// in FIRmono_ISRs.c
 
 void StartUp()
 {
-	;
+	// fold the FIR from here on if B[] has linear phase
+	symmetry = BlockFIR_Symmetry(B, N+1);
 }